@@ -0,0 +1,121 @@
+/* This source file defines all of the functions shared by the benchmarks in bench/ */
+
+/* Include Directives */
+
+#define _GNU_SOURCE                     // Declares environ.
+
+#include <arpa/inet.h>                  // Definitions for internet operations.
+#include <fcntl.h>                      // File control options.
+#include <signal.h>                     // Defines signals and signal handling functions.
+#include <spawn.h>                      // Spawns processes without copying the caller's address space.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <sys/socket.h>                 // Main sockets header.
+#include <sys/wait.h>                   // Declarations for waiting.
+#include <time.h>                       // Declares time and date functions.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../protocol_functions.h"      // Defines all of the macros and declares all of the functions of the wire protocol.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Function Definitions */
+
+int connect_overseer(int port)
+{
+    int sock_fd;                                // Socket file descriptor.
+    struct sockaddr_in overseer_address = {};   // Overseer internet address.
+
+    if ((sock_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    overseer_address.sin_family = AF_INET;
+    overseer_address.sin_port = htons(port);
+    overseer_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (connect(sock_fd, (struct sockaddr *)&overseer_address, sizeof(overseer_address)) == ERROR)
+    {
+        close(sock_fd);
+        return ERROR;
+    }
+
+    return sock_fd;
+}
+
+int recv_final_reply(int sock_fd, struct frame_header *header, char *payload)
+{
+    int len; // Length of the received payload.
+
+    do
+    {
+        if ((len = recv_frame(sock_fd, header, payload, MAX_PAYLOAD_LEN)) == ERROR)
+        {
+            fprintf(stderr, "Connection to overseer lost\n");
+            exit(EXIT_FAILURE);
+        }
+    } while (header->type != MSG_STARTED && header->type != MSG_SUBMITTED && header->type != MSG_ERROR && header->type != MSG_END);
+
+    return len;
+}
+
+int64_t get_time_ns()
+{
+    struct timespec now; // Current time of the monotonic clock.
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+pid_t start_overseer(char **opts, int port)
+{
+    char port_str[16];                          // Port, as passed to the overseer.
+    char *args[MAX_OVERSEER_ARGS];              // Arguments of the overseer.
+    int num_args = 0;                           // Number of arguments of the overseer.
+    int sock_fd = ERROR;                        // Socket connected to the overseer once it listens.
+    pid_t overseer_pid;                         // Process ID of the overseer.
+    posix_spawn_file_actions_t file_actions;    // Redirection of the overseer's log.
+
+    args[num_args++] = OVERSEER_PATH;
+
+    while (*opts != NULL && num_args < MAX_OVERSEER_ARGS - 2)
+    {
+        args[num_args++] = *opts++;
+    }
+
+    snprintf(port_str, sizeof(port_str), "%i", port);
+    args[num_args++] = port_str;
+    args[num_args] = NULL;
+
+    if (posix_spawn_file_actions_init(&file_actions) ||
+        posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0) ||
+        posix_spawn(&overseer_pid, OVERSEER_PATH, &file_actions, NULL, args, environ) || posix_spawn_file_actions_destroy(&file_actions))
+    {
+        fprintf(stderr, "Could not start %s\n", OVERSEER_PATH);
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < CONNECT_RETRIES && (sock_fd = connect_overseer(port)) == ERROR; i++)
+    {
+        usleep(CONNECT_RETRY_US);
+    }
+
+    if (sock_fd == ERROR)
+    {
+        fprintf(stderr, "Overseer did not listen on port %i\n", port);
+        kill(overseer_pid, SIGKILL);
+        exit(EXIT_FAILURE);
+    }
+
+    close(sock_fd);
+
+    return overseer_pid;
+}
+
+void stop_overseer(pid_t overseer_pid)
+{
+    if (kill(overseer_pid, SIGINT) || waitpid(overseer_pid, NULL, 0) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,84 @@
+/* This header file defines all of the macros and declares all of the functions shared by the benchmarks in bench/ */
+
+#ifndef __BENCH_FUNCTIONS_H__
+#define __BENCH_FUNCTIONS_H__
+
+/* Include Directives */
+
+#include <stdint.h>             // Defines exact-width integer types.
+#include <sys/types.h>          // Defines pid_t.
+
+/* Macro Definitions */
+
+#define BENCH_PORT 47400        // Port the overseer started by a benchmark listens on, unless another is given with -P.
+#define CONNECT_RETRIES 500     // Number of times the overseer is polled for a connection before it is taken to have failed to start.
+#define CONNECT_RETRY_US 10000  // Time in microseconds between connection attempts while the overseer starts.
+#define MAX_OVERSEER_ARGS 32    // Maximum number of arguments passed to the overseer, including its path, port and terminating NULL.
+#define NS_PER_SECOND 1000000000L // Number of nanoseconds in a second.
+#define NS_PER_US 1000          // Number of nanoseconds in a microsecond.
+#define OVERSEER_PATH "./overseer" // Path of the overseer, as the benchmarks are run from the top directory of the repository.
+
+/* Structure Definitions */
+
+struct frame_header;
+
+/* Function Declarations */
+
+/*
+ * Function connect_overseer(): Connect to an overseer on the loopback interface.
+ *
+ * Algorithm: Create a TCP socket and connect it to 127.0.0.1 on the given port.
+ *
+ * Input: Overseer port number (port).
+ *
+ * Output: Socket file descriptor, or ERROR if the connection was refused.
+ */
+int connect_overseer(int port);
+
+/*
+ * Function recv_final_reply(): Receive the replies to a request up to its final reply.
+ *
+ * Algorithm: Receive frames, discarding any which are not final (MSG_MEM_USAGE, MSG_MEM_SAMPLE, MSG_POLICY), until a MSG_STARTED,
+ * MSG_SUBMITTED, MSG_ERROR or MSG_END arrives.
+ *
+ * Input: Socket file descriptor (sock_fd), header to receive the final reply's header (header) and buffer of MAX_PAYLOAD_LEN bytes to receive
+ * its payload (payload).
+ *
+ * Output: Length of the final reply's payload. Exits if the connection is lost.
+ */
+int recv_final_reply(int sock_fd, struct frame_header *header, char *payload);
+
+/*
+ * Function get_time_ns(): Read the monotonic clock.
+ *
+ * Algorithm: As above.
+ *
+ * Input: None.
+ *
+ * Output: Current time of the monotonic clock in nanoseconds.
+ */
+int64_t get_time_ns();
+
+/*
+ * Function start_overseer(): Start an overseer for a benchmark to drive.
+ *
+ * Algorithm: Spawn OVERSEER_PATH with the given options and port, its log discarded, and poll the port until a connection is accepted.
+ *
+ * Input: Options passed to the overseer, terminated by NULL (opts), and port to listen on (port).
+ *
+ * Output: Process ID of the overseer. Exits if it could not be started.
+ */
+pid_t start_overseer(char **opts, int port);
+
+/*
+ * Function stop_overseer(): Stop an overseer started by start_overseer().
+ *
+ * Algorithm: Send SIGINT, which the overseer handles by terminating its children and shutting down, and wait for it to exit.
+ *
+ * Input: Process ID of the overseer (overseer_pid).
+ *
+ * Output: None.
+ */
+void stop_overseer(pid_t overseer_pid);
+
+#endif
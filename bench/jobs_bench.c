@@ -0,0 +1,206 @@
+/* This source file benchmarks the rate at which jobs are launched one controller invocation at a time against submit-batch */
+
+/* Include Directives */
+
+#define _GNU_SOURCE                     // Declares environ.
+
+#include <linux/limits.h>               // Implementation-defined constants.
+#include <spawn.h>                      // Spawns processes without copying the caller's address space.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <string.h>                     // String manipulation functions.
+#include <sys/wait.h>                   // Declarations for waiting.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../protocol_functions.h"      // Defines all of the macros and declares all of the functions of the wire protocol.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define CONTROLLER_PATH "./controller"  // Path of the controller, as the benchmarks are run from the top directory of the repository.
+#define DEFAULT_JOBS 2000               // Number of jobs launched by each method, by default.
+#define JOB_FILE "/bin/true"            // File executed by every job, which exits at once.
+
+/* Function Definitions */
+
+/*
+ * Function run_controllers(): Launch jobs the way a script without submit-batch does.
+ *
+ * Algorithm: Spawn the controller once per job, each connecting, sending the job and waiting for its pid, and wait for each to exit before the
+ * next is spawned.
+ *
+ * Input: Overseer port (port) and number of jobs to launch (num_jobs).
+ *
+ * Output: Number of jobs launched.
+ */
+int run_controllers(int port, int num_jobs)
+{
+    char port_str[16];      // Port, as passed to the controller.
+    int num_started = 0;    // Number of controllers which exited successfully.
+    int status;             // Exit status of the current controller.
+    pid_t c_pid;            // Process ID of the current controller.
+
+    char *args[] = {CONTROLLER_PATH, "127.0.0.1", port_str, JOB_FILE, NULL}; // Arguments of each controller.
+
+    snprintf(port_str, sizeof(port_str), "%i", port);
+
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if (posix_spawn(&c_pid, CONTROLLER_PATH, NULL, NULL, args, environ) || waitpid(c_pid, &status, 0) == ERROR)
+        {
+            fprintf(stderr, "Could not run %s\n", CONTROLLER_PATH);
+            exit(EXIT_FAILURE);
+        }
+
+        num_started += WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+
+    return num_started;
+}
+
+/*
+ * Function run_connections(): Launch jobs with one MSG_EXEC per connection, as the controller does, without spawning a controller.
+ *
+ * Algorithm: For each job, connect, send the command and wait for its MSG_STARTED before closing the connection.
+ *
+ * Input: Overseer port (port) and number of jobs to launch (num_jobs).
+ *
+ * Output: Number of jobs launched.
+ */
+int run_connections(int port, int num_jobs)
+{
+    int num_started = 0;            // Number of jobs answered with MSG_STARTED.
+    int sock_fd;                    // Socket of the current job.
+    struct frame_header header;     // Header of the final reply.
+
+    char *payload = malloc(MAX_PAYLOAD_LEN); // Payload of the final reply.
+
+    if (!payload)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < num_jobs; i++)
+    {
+        if ((sock_fd = connect_overseer(port)) == ERROR || send_frame(sock_fd, MSG_EXEC, 0, JOB_FILE, strlen(JOB_FILE)) == ERROR)
+        {
+            fprintf(stderr, "Could not send job to overseer\n");
+            exit(EXIT_FAILURE);
+        }
+
+        recv_final_reply(sock_fd, &header, payload);
+        num_started += header.type == MSG_STARTED;
+        close(sock_fd);
+    }
+
+    free(payload);
+
+    return num_started;
+}
+
+/*
+ * Function run_batch(): Launch jobs with submit-batch.
+ *
+ * Algorithm: Over a single connection, send the jobs as MSG_SUBMIT requests of as many lines as the overseer accepts in a frame, all before any
+ * reply is read, as the controller does, then count the jobs started in each MSG_SUBMITTED.
+ *
+ * Input: Overseer port (port) and number of jobs to launch (num_jobs).
+ *
+ * Output: Number of jobs launched.
+ */
+int run_batch(int port, int num_jobs)
+{
+    int len;                        // Length of the current MSG_SUBMITTED payload.
+    int num_batches = 0;            // Number of MSG_SUBMIT requests sent.
+    int num_started = 0;            // Number of jobs reported as JOB_STARTED.
+    int sock_fd;                    // Socket carrying the batches.
+    size_t batch_len;               // Length of the current batch.
+    struct frame_header header;     // Header of the current reply.
+
+    size_t line_len = strlen(JOB_FILE "\n");    // Length of a job's line.
+    char *payload = malloc(MAX_PAYLOAD_LEN);    // Batch being built, then reply being read.
+
+    if (!payload || (sock_fd = connect_overseer(port)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < num_jobs; num_batches++)
+    {
+        for (batch_len = 0; i < num_jobs && batch_len + line_len <= PATH_MAX - 1; i++, batch_len += line_len)
+        {
+            memcpy(payload + batch_len, JOB_FILE "\n", line_len);
+        }
+
+        if (send_frame(sock_fd, MSG_SUBMIT, num_batches, payload, batch_len) == ERROR)
+        {
+            fprintf(stderr, "Could not send batch to overseer\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int i = 0; i < num_batches; i++)
+    {
+        len = recv_final_reply(sock_fd, &header, payload);
+
+        for (int j = 0; header.type == MSG_SUBMITTED && j < len / JOB_STATUS_LEN; j++)
+        {
+            num_started += get_be32(payload + j * JOB_STATUS_LEN + sizeof(int32_t)) == JOB_STARTED;
+        }
+    }
+
+    close(sock_fd);
+    free(payload);
+
+    return num_started;
+}
+
+/*
+ * Function main(): Compare the rate at which jobs are launched one at a time and in bulk.
+ *
+ * Algorithm: Parse the options, start an overseer, and time the launch of the given number of jobs by each method in turn, printing the number
+ * launched and the rate.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    int num_started;                        // Number of jobs launched by the current method.
+    int opt;                                // Current command line option.
+    int64_t start;                          // Time at which the current method started.
+    double elapsed;                         // Time taken by the current method in seconds.
+    pid_t overseer_pid;                     // Process ID of the overseer.
+
+    char *opts[] = {NULL};                  // Options of the overseer.
+    int num_jobs = DEFAULT_JOBS;            // Number of jobs launched by each method.
+    int port = BENCH_PORT;                  // Port of the overseer.
+    const char *methods[] = {"controller per job", "connection per job", "submit-batch"}; // Names of the methods.
+    int (*run[])(int, int) = {run_controllers, run_connections, run_batch};                // Functions launching jobs by each method.
+
+    while ((opt = getopt(argc, argv, "n:P:")) != ERROR)
+    {
+        if ((opt == 'n' && (num_jobs = atoi(optarg)) <= 0) || (opt == 'P' && (port = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: jobs_bench [-n jobs] [-P port]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    overseer_pid = start_overseer(opts, port);
+
+    printf("%-20s %10s %12s\n", "method", "launched", "jobs/s");
+
+    for (int i = 0; i < sizeof(methods) / sizeof(methods[0]); i++)
+    {
+        start = get_time_ns();
+        num_started = run[i](port, num_jobs);
+        elapsed = (double)(get_time_ns() - start) / NS_PER_SECOND;
+
+        printf("%-20s %10i %12.0f\n", methods[i], num_started, num_started / elapsed);
+    }
+
+    stop_overseer(overseer_pid);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,320 @@
+/* This source file fuzzes the command tokenizer and split_args() and benchmarks the rate at which commands are parsed */
+
+/* Include Directives */
+
+#define _GNU_SOURCE                     // Declares CPU_SETSIZE, which must be visible before the system headers are included.
+
+#include <arpa/inet.h>                  // Definitions for internet operations, used by the declarations of overseer_functions.h.
+#include <linux/limits.h>               // Implementation-defined constants.
+#include <pthread.h>                    // Threading interfaces, used by the types of overseer_functions.h.
+#include <sched.h>                      // Defines CPU sets.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <string.h>                     // String manipulation functions.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../overseer_functions.h"      // Defines all of the macros and declares all of the functions of the overseer.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define ARG_CHARS "ab-/. \t\"'\\"       // Characters the arguments of the round trips are drawn from, rich in those the tokenizer treats specially.
+#define DEFAULT_COMMANDS 1000000        // Number of times each command is parsed, by default.
+#define DEFAULT_FUZZ 200000             // Number of random commands and of round trips fuzzed, by default.
+#define MAX_ARG_LEN 32                  // Maximum length of an argument of a round trip.
+#define MAX_FUZZ_LEN 256                // Maximum length of a random command.
+#define MAX_ROUND_TRIP_ARGS 8           // Maximum number of arguments of a round trip.
+#define UNSET_TIMEOUT -1                // SIGTERM timeout left by a command without -t.
+
+/* Structure Definitions */
+
+struct parsed_command // Structure holding everything split_args() reads from a command, other than the file and its arguments.
+{
+    char *out_file;         // Output redirection file, within the command, or "" without -o.
+    char *log_file;         // Logging redirection file, within the command, or "" without -log.
+    long int SIGTERM_timeout; // Time in milliseconds before SIGTERM is sent, or UNSET_TIMEOUT without -t.
+    long int mem_limit;     // Memory limit in bytes, or 0 without -m.
+    int priority;           // Priority class.
+    int num_cpus;           // Number of cores to dedicate, or 0 without -cpus.
+    int show_mem_info;      // Indicator of a mem command.
+    int proc_id;            // Process ID of a mem command.
+    int kill_mem_percent;   // Indicator of a memkill command.
+    double mem_percent;     // Percentage of a memkill command.
+    int num_args;           // Number of arguments, including the file, or ERROR if a quote is not closed.
+};
+
+/* Function Definitions */
+
+/*
+ * Function parse_command(): Parse a command as a worker does.
+ *
+ * Algorithm: Reset the parsed command to the defaults of exec_request(), then split the command with split_args().
+ *
+ * Input: Command, which is modified (buf), parsed command to fill (parsed) and array of PATH_MAX strings to receive the file and its
+ * arguments (args).
+ *
+ * Output: None.
+ */
+void parse_command(char *buf, struct parsed_command *parsed, char **args)
+{
+    parsed->out_file = "";
+    parsed->log_file = "";
+    parsed->SIGTERM_timeout = UNSET_TIMEOUT;
+    parsed->mem_limit = 0;
+    parsed->priority = PRIORITY_NORMAL;
+    parsed->num_cpus = 0;
+    parsed->show_mem_info = FALSE;
+    parsed->proc_id = 0;
+    parsed->kill_mem_percent = FALSE;
+    parsed->mem_percent = 0;
+
+    parsed->num_args = split_args(buf, &parsed->out_file, &parsed->log_file, &parsed->SIGTERM_timeout, &parsed->mem_limit, &parsed->priority,
+                                  &parsed->num_cpus, &parsed->show_mem_info, &parsed->proc_id, &parsed->kill_mem_percent, &parsed->mem_percent,
+                                  args);
+}
+
+/*
+ * Function within(): Check that a token lies within a command.
+ *
+ * Algorithm: As above, including the NUL terminating the token.
+ *
+ * Input: Command (buf), its length (len) and token (token).
+ *
+ * Output: TRUE if the token and its terminating NUL lie within the command, otherwise FALSE.
+ */
+int within(char *buf, size_t len, char *token)
+{
+    return token >= buf && token <= buf + len && token + strlen(token) <= buf + len;
+}
+
+/*
+ * Function fuzz_random(): Parse random commands and check that every token split off lies within the command.
+ *
+ * Algorithm: Build each command from random fragments, which are flags, keywords, quotes, backslashes, delimiters and plain characters, keep
+ * a copy of it, and parse it. Unless a quote was reported unclosed, check that the file, its arguments and the redirection files point into
+ * the command and that the arguments are NULL-terminated. Print the offending command and exit on the first failure.
+ *
+ * Input: Number of commands (num_commands).
+ *
+ * Output: Number of commands rejected for an unclosed quote.
+ */
+int fuzz_random(int num_commands)
+{
+    char buf[MAX_FUZZ_LEN + MAX_ARG_LEN];   // Command being parsed.
+    char copy[MAX_FUZZ_LEN + MAX_ARG_LEN];  // Command as it was built.
+    const char *fragment;                   // Fragment being appended.
+    size_t len;                             // Length of the command.
+    size_t target_len;                      // Length the command is built up to.
+    struct parsed_command parsed;           // Result of parsing the command.
+
+    const char *fragments[] = {"mem ", "memkill ", "-o ", "-log ", "-t ", "-m ", "-p ", "-cpus ", "-- ", "\"", "'", "\\", " ", "\t", "a",
+                               "-", "/bin/x", "1.5"}; // Fragments the commands are built from.
+    int num_unclosed = 0;                   // Number of commands rejected for an unclosed quote.
+
+    char **args = malloc(sizeof(char *) * PATH_MAX); // File and arguments of the command.
+
+    if (!args)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < num_commands; i++)
+    {
+        target_len = random() % MAX_FUZZ_LEN;
+
+        for (len = 0; len < target_len; len += strlen(fragment))
+        {
+            fragment = fragments[random() % (sizeof(fragments) / sizeof(fragments[0]))];
+            memcpy(buf + len, fragment, strlen(fragment));
+        }
+
+        buf[len] = '\0';
+        memcpy(copy, buf, len + 1);
+
+        parse_command(buf, &parsed, args);
+
+        if (parsed.num_args == ERROR)
+        {
+            num_unclosed++;
+            continue;
+        }
+
+        for (int j = 0; j < parsed.num_args; j++)
+        {
+            if (!within(buf, len, args[j]))
+            {
+                parsed.num_args = ERROR;
+            }
+        }
+
+        if (parsed.num_args == ERROR || args[parsed.num_args] != NULL || (*parsed.out_file && !within(buf, len, parsed.out_file)) ||
+            (*parsed.log_file && !within(buf, len, parsed.log_file)))
+        {
+            fprintf(stderr, "Token outside the command: [%s]\n", copy);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(args);
+
+    return num_unclosed;
+}
+
+/*
+ * Function fuzz_round_trips(): Check that random arguments written by quote_arg() are parsed back unchanged.
+ *
+ * Algorithm: Draw random arguments, rich in delimiters, quotes and backslashes, and write a command running them with an output file and
+ * timeout, each written by quote_arg() as the controller does, with "--" before the file since it may start with a dash. Parse it and check
+ * that the output file, timeout and every argument come back as they were drawn. Print the offending command and exit on the first failure.
+ *
+ * Input: Number of round trips (num_round_trips).
+ *
+ * Output: None.
+ */
+void fuzz_round_trips(int num_round_trips)
+{
+    char buf[PATH_MAX];                                             // Command being parsed.
+    char copy[PATH_MAX];                                            // Command as it was written.
+    char *end;                                                      // End of the command written so far.
+    int num_drawn;                                                  // Number of arguments drawn, including the file and output file.
+    int same;                                                       // Indicator that the command was parsed back unchanged.
+    struct parsed_command parsed;                                   // Result of parsing the command.
+    char drawn[MAX_ROUND_TRIP_ARGS + 1][MAX_ARG_LEN + 1];           // Output file, then the file and its arguments.
+
+    char **args = malloc(sizeof(char *) * PATH_MAX); // File and arguments of the command.
+
+    if (!args)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < num_round_trips; i++)
+    {
+        num_drawn = 2 + random() % MAX_ROUND_TRIP_ARGS;
+
+        for (int j = 0; j < num_drawn; j++)
+        {
+            int len = random() % (MAX_ARG_LEN + 1); // Length of the argument, which may be empty.
+
+            for (int k = 0; k < len; k++)
+            {
+                drawn[j][k] = ARG_CHARS[random() % strlen(ARG_CHARS)];
+            }
+
+            drawn[j][len] = '\0';
+        }
+
+        end = quote_arg(stpcpy(buf, "-o "), drawn[0]);
+        end = stpcpy(end, " -t 2 --");
+
+        for (int j = 1; j < num_drawn; j++)
+        {
+            end = quote_arg(stpcpy(end, " "), drawn[j]);
+        }
+
+        memcpy(copy, buf, end - buf + 1);
+
+        parse_command(buf, &parsed, args);
+
+        same = parsed.num_args == num_drawn - 1 && !strcmp(parsed.out_file, drawn[0]) && parsed.SIGTERM_timeout == 2 * MS_PER_SECOND;
+
+        for (int j = 1; same && j < num_drawn; j++)
+        {
+            same = !strcmp(args[j - 1], drawn[j]);
+        }
+
+        if (!same)
+        {
+            fprintf(stderr, "Command not parsed back unchanged: [%s]\n", copy);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(args);
+}
+
+/*
+ * Function main(): Fuzz the parser, then measure the rate at which it parses a few typical commands.
+ *
+ * Algorithm: Parse the options and seed the random number generator, then fuzz random commands and round trips through quote_arg(). For each
+ * typical command, copy it into the receive buffer and parse it the given number of times, as each parse modifies the buffer, and print the
+ * rate, including the copy.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    size_t len;                                     // Length of the current command, including its NUL.
+    int num_unclosed;                               // Number of random commands rejected for an unclosed quote.
+    int opt;                                        // Current command line option.
+    int64_t start;                                  // Time at which parsing of the current command started.
+    double elapsed;                                 // Time taken to parse the current command in seconds.
+    struct parsed_command parsed;                   // Result of parsing the current command.
+
+    const char *commands[][2] = {
+        {"bare", "/bin/true"},
+        {"flags", "-o out.txt -log log.txt -t 5 -m 1048576 -p high -cpus 2 /bin/sleep 10"},
+        {"quoted", "-o 'my out.txt' /bin/echo \"say \\\"hello world\\\"\" 'a b' c\\ d"},
+        {"mem", "mem 1234"}};                       // Names and text of the commands measured.
+    int num_commands = DEFAULT_COMMANDS;            // Number of times each command is parsed.
+    int num_fuzz = DEFAULT_FUZZ;                    // Number of random commands and of round trips fuzzed.
+    unsigned int seed = getpid();                   // Seed of the random number generator.
+
+    while ((opt = getopt(argc, argv, "f:n:s:")) != ERROR)
+    {
+        if ((opt == 'f' && (num_fuzz = atoi(optarg)) < 0) || (opt == 'n' && (num_commands = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: parser_bench [-f fuzz] [-n commands] [-s seed]\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (opt == 's')
+        {
+            seed = strtoul(optarg, NULL, 10);
+        }
+    }
+
+    char **args = malloc(sizeof(char *) * PATH_MAX); // File and arguments of the current command.
+    char *buf = malloc(PATH_MAX);                    // Receive buffer the current command is parsed in.
+
+    if (!args || !buf)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    srandom(seed);
+
+    num_unclosed = fuzz_random(num_fuzz);
+    fuzz_round_trips(num_fuzz);
+
+    printf("seed %u: %i random commands (%i with an unclosed quote) and %i round trips passed\n", seed, num_fuzz, num_unclosed, num_fuzz);
+    printf("%-10s %14s %10s\n", "command", "commands/s", "ns each");
+
+    for (int i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+    {
+        len = strlen(commands[i][1]) + 1;
+        start = get_time_ns();
+
+        for (int j = 0; j < num_commands; j++)
+        {
+            memcpy(buf, commands[i][1], len);
+            parse_command(buf, &parsed, args);
+        }
+
+        elapsed = (double)(get_time_ns() - start) / NS_PER_SECOND;
+
+        if (parsed.num_args == ERROR)
+        {
+            fprintf(stderr, "Could not parse %s\n", commands[i][1]);
+            exit(EXIT_FAILURE);
+        }
+
+        printf("%-10s %14.0f %10.1f\n", commands[i][0], num_commands / elapsed, elapsed * NS_PER_SECOND / num_commands);
+    }
+
+    free(args);
+    free(buf);
+
+    return EXIT_SUCCESS;
+}
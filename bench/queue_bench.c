@@ -0,0 +1,190 @@
+/* This source file benchmarks the rate at which the overseer answers pipelined requests as its number of worker threads grows */
+
+/* Include Directives */
+
+#include <pthread.h>                    // Threading interfaces.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../protocol_functions.h"      // Defines all of the macros and declares all of the functions of the wire protocol.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define DEFAULT_CONNECTIONS 8           // Number of connections sending requests at once, by default.
+#define DEFAULT_DEPTH 32                // Number of requests each connection keeps in flight, by default, below the overseer's limit of 64.
+#define DEFAULT_MAX_WORKERS 64          // Largest number of worker threads measured, by default.
+#define DEFAULT_REQUESTS 20000          // Number of requests sent over each connection, by default.
+
+/* Structure Definitions */
+
+struct client // Structure describing a connection driven by its own thread.
+{
+    pthread_t thread;   // Thread sending the requests.
+    int port;           // Port of the overseer.
+    int depth;          // Number of requests kept in flight.
+    int num_requests;   // Number of requests to send.
+    int num_answered;   // Number of requests answered with MSG_END.
+};
+
+/* Function Definitions */
+
+/*
+ * Function send_mem_request(): Send a request for the memory usage of every process.
+ *
+ * Algorithm: Send a MSG_MEM frame for pid 0, which every worker answers from the table of children without touching any process file.
+ *
+ * Input: Socket file descriptor (sock_fd) and request identifier (id).
+ *
+ * Output: None.
+ */
+void send_mem_request(int sock_fd, uint32_t id)
+{
+    char payload[sizeof(int32_t)]; // Payload of the request.
+
+    put_be32(payload, 0);
+
+    if (send_frame(sock_fd, MSG_MEM, id, payload, sizeof(payload)) == ERROR)
+    {
+        fprintf(stderr, "Could not send request to overseer\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Function run_client(): Send a connection's requests, keeping a fixed number in flight.
+ *
+ * Algorithm: Connect and send as many requests as are to be kept in flight, then send a further request each time one is answered with
+ * MSG_END, until all of them have been answered.
+ *
+ * Input: Client (void_var).
+ *
+ * Output: NULL.
+ */
+void *run_client(void *void_var)
+{
+    int num_sent = 0;                       // Number of requests sent.
+    int sock_fd;                            // Socket of the connection.
+    struct frame_header header;             // Header of the current reply.
+
+    struct client *client = void_var;       // Client driven by the thread.
+    char *payload = malloc(MAX_PAYLOAD_LEN); // Payload of the current reply.
+
+    if (!payload || (sock_fd = connect_overseer(client->port)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (num_sent < client->depth && num_sent < client->num_requests)
+    {
+        send_mem_request(sock_fd, num_sent++);
+    }
+
+    while (client->num_answered < client->num_requests)
+    {
+        recv_final_reply(sock_fd, &header, payload);
+        client->num_answered += header.type == MSG_END;
+
+        if (num_sent < client->num_requests)
+        {
+            send_mem_request(sock_fd, num_sent++);
+        }
+    }
+
+    close(sock_fd);
+    free(payload);
+
+    return NULL;
+}
+
+/*
+ * Function main(): Measure the rate at which requests are answered for a growing number of worker threads.
+ *
+ * Algorithm: Parse the options, then for each power of two up to the largest number of workers, start an overseer with that many workers,
+ * drive the given number of connections at once, each keeping the given number of requests in flight, and print the rate at which they are
+ * answered before stopping the overseer.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    char workers_str[16];                           // Number of workers, as passed to the overseer.
+    int num_answered;                               // Number of requests answered with the current number of workers.
+    int opt;                                        // Current command line option.
+    int64_t start;                                  // Time at which the current run started.
+    double elapsed;                                 // Time taken by the current run in seconds.
+    pid_t overseer_pid;                             // Process ID of the overseer.
+
+    char *opts[] = {"-w", workers_str, NULL};       // Options of the overseer.
+    int depth = DEFAULT_DEPTH;                      // Number of requests each connection keeps in flight.
+    int max_workers = DEFAULT_MAX_WORKERS;          // Largest number of workers measured.
+    int num_clients = DEFAULT_CONNECTIONS;          // Number of connections.
+    int num_requests = DEFAULT_REQUESTS;            // Number of requests sent over each connection.
+    int port = BENCH_PORT;                          // Port of the overseer.
+
+    while ((opt = getopt(argc, argv, "c:d:n:P:W:")) != ERROR)
+    {
+        if ((opt == 'c' && (num_clients = atoi(optarg)) <= 0) || (opt == 'd' && (depth = atoi(optarg)) <= 0) ||
+            (opt == 'n' && (num_requests = atoi(optarg)) <= 0) || (opt == 'P' && (port = atoi(optarg)) <= 0) ||
+            (opt == 'W' && (max_workers = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: queue_bench [-c connections] [-d depth] [-n requests] [-P port] [-W max_workers]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    struct client *clients = calloc(num_clients, sizeof(struct client)); // Connections driven at once.
+
+    if (!clients)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%i connections, %i requests in flight on each\n", num_clients, depth);
+    printf("%-10s %12s %14s\n", "workers", "answered", "requests/s");
+
+    for (int num_workers = 1; num_workers <= max_workers; num_workers *= 2)
+    {
+        snprintf(workers_str, sizeof(workers_str), "%i", num_workers);
+        overseer_pid = start_overseer(opts, port);
+
+        start = get_time_ns();
+
+        for (int i = 0; i < num_clients; i++)
+        {
+            clients[i].port = port;
+            clients[i].depth = depth;
+            clients[i].num_requests = num_requests;
+            clients[i].num_answered = 0;
+
+            if (pthread_create(&clients[i].thread, NULL, run_client, &clients[i]))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        num_answered = 0;
+
+        for (int i = 0; i < num_clients; i++)
+        {
+            if (pthread_join(clients[i].thread, NULL))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            num_answered += clients[i].num_answered;
+        }
+
+        elapsed = (double)(get_time_ns() - start) / NS_PER_SECOND;
+
+        printf("%-10i %12i %14.0f\n", num_workers, num_answered, num_answered / elapsed);
+
+        stop_overseer(overseer_pid);
+    }
+
+    free(clients);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+/* This source file benchmarks the memory sampler backends against the original /proc/<pid>/maps parser on cost and accuracy */
+
+/* Include Directives */
+
+#define _GNU_SOURCE                     // Declares CPU_SETSIZE, which must be visible before the system headers are included.
+
+#include <arpa/inet.h>                  // Definitions for internet operations, used by the declarations of overseer_functions.h.
+#include <fcntl.h>                      // File control options.
+#include <limits.h>                     // Defines the limits of integral types.
+#include <linux/limits.h>               // Implementation-defined constants.
+#include <pthread.h>                    // Threading interfaces, used by the types of overseer_functions.h.
+#include <sched.h>                      // Defines CPU sets.
+#include <signal.h>                     // Defines signals and signal handling functions.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <string.h>                     // String manipulation functions.
+#include <sys/mman.h>                   // Declares memory mapping functions.
+#include <sys/wait.h>                   // Declarations for waiting.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../overseer_functions.h"      // Defines all of the macros and declares all of the functions of the overseer.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define BYTES_PER_MB (1024 * 1024)      // Number of bytes in a megabyte.
+#define DEFAULT_MAPPINGS 20000          // Number of mappings of the sampled process, by default.
+#define DEFAULT_RESIDENT_MB 64          // Number of megabytes the sampled process touches, by default.
+#define DEFAULT_SAMPLES 200             // Number of samples taken with each backend, by default.
+
+/* Function Definitions */
+
+/*
+ * Function sample_legacy(): Sample a process' memory usage as the original get_mem_used() did.
+ *
+ * Algorithm: Allocate the line and path buffers, fopen() /proc/<pid>/maps and sum the anonymous mappings, splitting each line with strtok(),
+ * then close the file and free the buffers. It is kept here only as the baseline the backends are measured against.
+ *
+ * Input: Process ID of the sampled process (c_pid).
+ *
+ * Output: Total size of the process' anonymous mappings (bytes).
+ */
+long int sample_legacy(pid_t c_pid)
+{
+    char *token;            // Token returned.
+    FILE *maps_fp;          // Maps file stream.
+    int inode;              // Inode value.
+    long int start_address; // Memory start address.
+    long int end_address;   // Memory end address.
+    long int mem_used = 0;  // Memory usage (bytes).
+
+    char *current_line = malloc(sizeof(char) * PATH_MAX);   // Current line being read in maps file.
+    char *maps_file = malloc(sizeof(char) * FILENAME_MAX);  // Maps file path.
+
+    sprintf(maps_file, "/proc/%i/maps", c_pid);
+    maps_fp = fopen(maps_file, "r");
+
+    while (fgets(current_line, PATH_MAX, maps_fp) != NULL)
+    {
+        token = strtok(current_line, "-");
+        start_address = strtol(token, NULL, 16);
+
+        token = strtok(NULL, " ");
+        end_address = strtol(token, NULL, 16);
+
+        for (int i = 0; i < 4; i++)
+        {
+            token = strtok(NULL, " ");
+        }
+
+        inode = atoi(token);
+
+        if (!inode)
+        {
+            mem_used += end_address - start_address;
+        }
+    }
+
+    fclose(maps_fp);
+
+    free(current_line);
+    free(maps_file);
+
+    return mem_used;
+}
+
+/*
+ * Function start_target(): Start the process whose memory is sampled.
+ *
+ * Algorithm: Fork a child which maps num_mappings small regions, alternating their protection so the kernel cannot merge them, and touches
+ * resident_mb megabytes of a further region, then tells the parent it is ready and sleeps until it is killed.
+ *
+ * Input: Number of separate mappings (num_mappings) and number of megabytes to make resident (resident_mb).
+ *
+ * Output: Process ID of the child.
+ */
+pid_t start_target(int num_mappings, long int resident_mb)
+{
+    char ready;         // Byte the child writes once its memory is laid out.
+    char *region;       // Region mapped by the child.
+    int ready_fds[2];   // Pipe the child reports readiness through.
+    pid_t c_pid;        // Process ID of the child.
+
+    long int page_len = sysconf(_SC_PAGESIZE); // Size of a page.
+
+    if (pipe(ready_fds) || (c_pid = fork()) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!c_pid)
+    {
+        for (int i = 0; i < num_mappings; i++)
+        {
+            if ((region = mmap(NULL, page_len, i % 2 ? PROT_READ : PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, ERROR, 0)) == MAP_FAILED)
+            {
+                _exit(EXIT_FAILURE);
+            }
+        }
+
+        if (resident_mb > 0)
+        {
+            if ((region = mmap(NULL, resident_mb * BYTES_PER_MB, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, ERROR, 0)) == MAP_FAILED)
+            {
+                _exit(EXIT_FAILURE);
+            }
+
+            memset(region, 1, resident_mb * BYTES_PER_MB);
+        }
+
+        if (write(ready_fds[1], "", 1) != 1)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        pause();
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(ready_fds[1]);
+
+    if (read(ready_fds[0], &ready, 1) != 1)
+    {
+        fprintf(stderr, "Sampled process could not lay out its memory\n");
+        exit(EXIT_FAILURE);
+    }
+
+    close(ready_fds[0]);
+
+    return c_pid;
+}
+
+/*
+ * Function main(): Compare the memory sampler backends.
+ *
+ * Algorithm: Parse the options, start the sampled process, then for each backend open its process file once and time the given number of
+ * samples read through it, as the sampler thread does every second. The original parser, which reopens the file for each sample, is timed the
+ * same way. Print the cost of a sample and the usage each backend reports next to what the process touched.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    char proc_file[FILENAME_MAX];               // Path of the file read by the current backend.
+    int mem_fd;                                 // File descriptor of the file read by the current backend.
+    int opt;                                    // Current command line option.
+    int64_t start;                              // Time at which the current backend started sampling.
+    long int mem_used = 0;                      // Memory usage reported by the last sample.
+    pid_t c_pid;                                // Process ID of the sampled process.
+
+    int num_mappings = DEFAULT_MAPPINGS;        // Number of separate mappings of the sampled process.
+    int num_samples = DEFAULT_SAMPLES;          // Number of samples taken with each backend.
+    long int resident_mb = DEFAULT_RESIDENT_MB; // Number of megabytes the sampled process touches.
+
+    while ((opt = getopt(argc, argv, "m:n:r:")) != ERROR)
+    {
+        if ((opt == 'm' && (num_mappings = atoi(optarg)) < 0) || (opt == 'n' && (num_samples = atoi(optarg)) <= 0) ||
+            (opt == 'r' && (resident_mb = atol(optarg)) < 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: sampler_bench [-m mappings] [-r resident_mb] [-n samples]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    c_pid = start_target(num_mappings, resident_mb);
+
+    printf("sampled process: %i mappings, %ld MB touched\n", num_mappings, resident_mb);
+    printf("%-14s %12s %14s\n", "backend", "us/sample", "reported MB");
+
+    start = get_time_ns();
+
+    for (int i = 0; i < num_samples; i++)
+    {
+        mem_used = sample_legacy(c_pid);
+    }
+
+    printf("%-14s %12.1f %14.1f\n", "legacy", (double)(get_time_ns() - start) / num_samples / NS_PER_US, (double)mem_used / BYTES_PER_MB);
+
+    for (int i = 0; i < NUM_MEM_SAMPLERS; i++)
+    {
+        snprintf(proc_file, FILENAME_MAX, mem_samplers[i].proc_file, c_pid);
+
+        if ((mem_fd = open(proc_file, O_RDONLY | O_CLOEXEC)) == ERROR)
+        {
+            fprintf(stderr, "Could not open %s\n", proc_file);
+            exit(EXIT_FAILURE);
+        }
+
+        start = get_time_ns();
+
+        for (int j = 0; j < num_samples; j++)
+        {
+            mem_used = mem_samplers[i].sample(mem_fd);
+        }
+
+        printf("%-14s %12.1f %14.1f\n", mem_samplers[i].name, (double)(get_time_ns() - start) / num_samples / NS_PER_US,
+               (double)mem_used / BYTES_PER_MB);
+
+        close(mem_fd);
+    }
+
+    if (kill(c_pid, SIGKILL) || waitpid(c_pid, NULL, 0) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/* This source file benchmarks the latency of launching a child with the overseer's posix_spawn() path against the original fork() path */
+
+/* Include Directives */
+
+#define _GNU_SOURCE                     // Declares CPU_SETSIZE, which must be visible before the system headers are included.
+
+#include <arpa/inet.h>                  // Definitions for internet operations, used by the declarations of overseer_functions.h.
+#include <fcntl.h>                      // File control options.
+#include <linux/limits.h>               // Implementation-defined constants, used by the declarations of overseer_functions.h.
+#include <pthread.h>                    // Threading interfaces, used by the types of overseer_functions.h.
+#include <sched.h>                      // Defines CPU sets.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <string.h>                     // String manipulation functions.
+#include <sys/wait.h>                   // Declarations for waiting.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../overseer_functions.h"      // Defines all of the macros and declares all of the functions of the overseer.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define BYTES_PER_MB (1024 * 1024)      // Number of bytes in a megabyte.
+#define DEFAULT_HEAP_MB 256             // Number of megabytes of heap the launching process has touched, by default.
+#define DEFAULT_LAUNCHES 500            // Number of children launched by each path, by default.
+#define JOB_FILE "/bin/true"            // File executed by every child, which exits at once.
+#define PERCENTILE_50 50                // Median.
+#define PERCENTILE_99 99                // 99th percentile.
+
+/* Function Definitions */
+
+/*
+ * Function fork_child(): Launch a child as the original exec_request() did.
+ *
+ * Algorithm: Create a pipe and fork. The child closes the read end, marks the write end close-on-exec, redirects stdout and stderr into the
+ * output file and executes the file, writing to the pipe if that fails. The parent blocks on the pipe until it is closed by the exec, or
+ * written to. It is kept here only as the baseline the overseer's spawn path is measured against.
+ *
+ * Input: NULL-terminated array of strings holding the executable file path and its arguments (args) and output file path (out_file).
+ *
+ * Output: Process ID of the child, or ERROR if the file could not be executed.
+ */
+pid_t fork_child(char **args, char *out_file)
+{
+    char err_buf[strlen("Failed") + 1]; // Buffer of the pipe.
+    int out_fd;                         // Child output redirection file descriptor.
+    int pipe_fd[2];                     // Pipe reporting failure to execute.
+    ssize_t child_exec_failed;          // Indicator that execution of child failed.
+    pid_t c_pid;                        // Process ID of child.
+
+    if (pipe(pipe_fd) || (c_pid = fork()) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!c_pid)
+    {
+        if (close(pipe_fd[0]) || fcntl(pipe_fd[1], F_SETFD, FD_CLOEXEC) == ERROR ||
+            (out_fd = open(out_file, O_APPEND | O_CREAT | O_WRONLY | O_CLOEXEC, S_IRWXU | S_IRWXG | S_IRWXO)) == ERROR ||
+            dup2(out_fd, STDOUT_FILENO) == ERROR || dup2(out_fd, STDERR_FILENO) == ERROR)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        execv(args[FILE_ARG_INDEX], args);
+
+        if (write(pipe_fd[1], "Failed", strlen("Failed") + 1) == ERROR)
+        {
+            _exit(EXIT_FAILURE);
+        }
+
+        _exit(EXIT_FAILURE);
+    }
+
+    if (close(pipe_fd[1]) || (child_exec_failed = read(pipe_fd[0], err_buf, sizeof(err_buf))) == ERROR || close(pipe_fd[0]))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return child_exec_failed ? ERROR : c_pid;
+}
+
+/*
+ * Function compare_latencies(): Order two latencies for qsort().
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointers to the latencies to compare (a, b).
+ *
+ * Output: Negative, zero or positive as the first latency is shorter than, equal to or longer than the second.
+ */
+int compare_latencies(const void *a, const void *b)
+{
+    return (*(int64_t *)a > *(int64_t *)b) - (*(int64_t *)a < *(int64_t *)b);
+}
+
+/*
+ * Function main(): Compare the latency of the fork() and posix_spawn() launch paths from a process with a large heap.
+ *
+ * Algorithm: Parse the options, allocate and touch the heap, so that fork() has its page tables to copy, then for each path launch the given
+ * number of children, timing each launch up to the point the overseer would learn its pid and reaping the child outside the timing. Print the
+ * mean, median and 99th percentile latency of each path.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    char *heap;                                     // Heap touched before the children are launched.
+    int opt;                                        // Current command line option.
+    int pidfd;                                      // File descriptor referring to a child launched by spawn_child().
+    int64_t start;                                  // Time at which the current launch started.
+    int64_t total;                                  // Sum of the latencies of the current path.
+    pid_t c_pid;                                    // Process ID of the current child.
+
+    char *args[] = {JOB_FILE, NULL};                // File and arguments of every child.
+    char *out_file = "/dev/null";                   // Output file of every child.
+    int num_launches = DEFAULT_LAUNCHES;            // Number of children launched by each path.
+    long int heap_mb = DEFAULT_HEAP_MB;             // Number of megabytes of heap touched.
+    const char *paths[] = {"fork", "posix_spawn"};  // Names of the launch paths.
+
+    while ((opt = getopt(argc, argv, "m:n:o:")) != ERROR)
+    {
+        if ((opt == 'm' && (heap_mb = atol(optarg)) < 0) || (opt == 'n' && (num_launches = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: spawn_bench [-m heap_mb] [-n launches] [-o out_file]\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (opt == 'o')
+        {
+            out_file = optarg;
+        }
+    }
+
+    int64_t *latencies = malloc(sizeof(int64_t) * num_launches); // Latency of each launch of the current path.
+
+    if (!latencies || (heap_mb > 0 && (heap = malloc(heap_mb * BYTES_PER_MB)) == NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (heap_mb > 0)
+    {
+        memset(heap, 1, heap_mb * BYTES_PER_MB);
+    }
+
+    printf("launching process: %ld MB heap touched\n", heap_mb);
+    printf("%-12s %10s %10s %10s\n", "path", "mean us", "p50 us", "p99 us");
+
+    for (int i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+    {
+        total = 0;
+
+        for (int j = 0; j < num_launches; j++)
+        {
+            start = get_time_ns();
+            c_pid = i == 0 ? fork_child(args, out_file) : spawn_child(args, out_file, &pidfd);
+            latencies[j] = get_time_ns() - start;
+            total += latencies[j];
+
+            if (c_pid == ERROR || (i == 1 && close(pidfd)) || waitpid(c_pid, NULL, 0) == ERROR)
+            {
+                fprintf(stderr, "Could not launch %s\n", JOB_FILE);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        qsort(latencies, num_launches, sizeof(int64_t), compare_latencies);
+
+        printf("%-12s %10.1f %10.1f %10.1f\n", paths[i], (double)total / num_launches / NS_PER_US,
+               (double)latencies[num_launches * PERCENTILE_50 / 100] / NS_PER_US, (double)latencies[num_launches * PERCENTILE_99 / 100] / NS_PER_US);
+    }
+
+    free(latencies);
+
+    return EXIT_SUCCESS;
+}
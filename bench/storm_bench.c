@@ -0,0 +1,195 @@
+/* This source file benchmarks the rate at which the overseer accepts a storm of short connections as its acceptors and backlog grow */
+
+/* Include Directives */
+
+#include <pthread.h>                    // Threading interfaces.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <sys/socket.h>                 // Main sockets header.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../protocol_functions.h"      // Defines all of the macros and declares all of the functions of the wire protocol.
+#include "bench_functions.h"            // Defines all of the macros and declares all of the functions shared by the benchmarks.
+
+/* Macro Definitions */
+
+#define DEFAULT_CONNECTIONS 200         // Number of connections each thread opens in turn, by default.
+#define DEFAULT_THREADS 64              // Number of threads opening connections at once, by default.
+#define LEGACY_BACKLOG 10               // Backlog of the original single listening socket.
+#define NS_PER_MS 1000000               // Number of nanoseconds in a millisecond.
+#define PERCENTILE_99 99                // 99th percentile.
+
+/* Structure Definitions */
+
+struct stormer // Structure describing a thread opening connections one after another.
+{
+    pthread_t thread;   // Thread opening the connections.
+    int port;           // Port of the overseer.
+    int num_conns;      // Number of connections to open.
+    int64_t *latencies; // Time in nanoseconds from connecting to closing each connection.
+};
+
+/* Function Definitions */
+
+/*
+ * Function run_stormer(): Open a thread's connections one after another, making one request over each.
+ *
+ * Algorithm: For each connection, connect, send a MSG_MEM request for every process, wait for its MSG_END and close the connection, timing
+ * all of it, so that a connection left waiting in the backlog or dropped from it and retried shows in its latency.
+ *
+ * Input: Stormer (void_var).
+ *
+ * Output: NULL.
+ */
+void *run_stormer(void *void_var)
+{
+    char request[sizeof(int32_t)];          // Payload of the request.
+    int sock_fd;                            // Socket of the current connection.
+    int64_t start;                          // Time at which the current connection was opened.
+    struct frame_header header;             // Header of the current reply.
+
+    struct stormer *stormer = void_var;     // Stormer driven by the thread.
+    char *payload = malloc(MAX_PAYLOAD_LEN); // Payload of the current reply.
+
+    if (!payload)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    put_be32(request, 0);
+
+    for (int i = 0; i < stormer->num_conns; i++)
+    {
+        start = get_time_ns();
+
+        if ((sock_fd = connect_overseer(stormer->port)) == ERROR || send_frame(sock_fd, MSG_MEM, 0, request, sizeof(request)) == ERROR)
+        {
+            fprintf(stderr, "Could not connect to overseer\n");
+            exit(EXIT_FAILURE);
+        }
+
+        do
+        {
+            recv_final_reply(sock_fd, &header, payload);
+        } while (header.type != MSG_END);
+
+        close(sock_fd);
+        stormer->latencies[i] = get_time_ns() - start;
+    }
+
+    free(payload);
+
+    return NULL;
+}
+
+/*
+ * Function compare_latencies(): Order two latencies for qsort().
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointers to the latencies to compare (a, b).
+ *
+ * Output: Negative, zero or positive as the first latency is shorter than, equal to or longer than the second.
+ */
+int compare_latencies(const void *a, const void *b)
+{
+    return (*(int64_t *)a > *(int64_t *)b) - (*(int64_t *)a < *(int64_t *)b);
+}
+
+/*
+ * Function main(): Measure the rate at which a storm of connections is accepted for the original listener and for growing acceptors.
+ *
+ * Algorithm: Parse the options, then start an overseer with the original single acceptor and backlog, followed by one for each power of two
+ * up to the largest number of acceptors with the given backlog. Each time, have every thread open its connections one after another, all
+ * threads at once, and print the rate at which connections were completed and their 99th percentile and worst latency before stopping the
+ * overseer.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    char acceptors_str[16];                         // Number of acceptors, as passed to the overseer.
+    char backlog_str[16];                           // Backlog, as passed to the overseer.
+    int num_total;                                  // Number of connections opened by all threads.
+    int opt;                                        // Current command line option.
+    int64_t start;                                  // Time at which the current run started.
+    double elapsed;                                 // Time taken by the current run in seconds.
+    pid_t overseer_pid;                             // Process ID of the overseer.
+
+    char *opts[] = {"-a", acceptors_str, "-b", backlog_str, NULL}; // Options of the overseer.
+    int backlog = SOMAXCONN;                        // Backlog of each listening socket after the original listener.
+    int max_acceptors = sysconf(_SC_NPROCESSORS_ONLN); // Largest number of acceptors measured.
+    int num_conns = DEFAULT_CONNECTIONS;            // Number of connections each thread opens.
+    int num_stormers = DEFAULT_THREADS;             // Number of threads opening connections at once.
+    int port = BENCH_PORT;                          // Port of the overseer.
+
+    while ((opt = getopt(argc, argv, "A:b:c:n:P:")) != ERROR)
+    {
+        if ((opt == 'A' && (max_acceptors = atoi(optarg)) <= 0) || (opt == 'b' && (backlog = atoi(optarg)) <= 0) ||
+            (opt == 'c' && (num_stormers = atoi(optarg)) <= 0) || (opt == 'n' && (num_conns = atoi(optarg)) <= 0) ||
+            (opt == 'P' && (port = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: storm_bench [-A max_acceptors] [-b backlog] [-c threads] [-n connections] [-P port]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    num_total = num_stormers * num_conns;
+
+    struct stormer *stormers = calloc(num_stormers, sizeof(struct stormer)); // Threads opening connections at once.
+    int64_t *latencies = malloc(sizeof(int64_t) * num_total);               // Latency of each connection of the current run.
+
+    if (!stormers || !latencies)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%i threads opening %i connections each\n", num_stormers, num_conns);
+    printf("%-10s %8s %12s %10s %10s\n", "acceptors", "backlog", "conns/s", "p99 ms", "worst ms");
+
+    /* The first run reproduces the original listener, a single acceptor with a backlog of 10, which the others are compared against. */
+    for (int num_acceptors = 0; num_acceptors <= max_acceptors; num_acceptors = num_acceptors ? num_acceptors * 2 : 1)
+    {
+        snprintf(acceptors_str, sizeof(acceptors_str), "%i", num_acceptors ? num_acceptors : 1);
+        snprintf(backlog_str, sizeof(backlog_str), "%i", num_acceptors ? backlog : LEGACY_BACKLOG);
+
+        overseer_pid = start_overseer(opts, port);
+
+        start = get_time_ns();
+
+        for (int i = 0; i < num_stormers; i++)
+        {
+            stormers[i].port = port;
+            stormers[i].num_conns = num_conns;
+            stormers[i].latencies = latencies + i * num_conns;
+
+            if (pthread_create(&stormers[i].thread, NULL, run_stormer, &stormers[i]))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        for (int i = 0; i < num_stormers; i++)
+        {
+            if (pthread_join(stormers[i].thread, NULL))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        elapsed = (double)(get_time_ns() - start) / NS_PER_SECOND;
+
+        qsort(latencies, num_total, sizeof(int64_t), compare_latencies);
+
+        printf("%-10s %8s %12.0f %10.2f %10.2f\n", acceptors_str, backlog_str, num_total / elapsed,
+               (double)latencies[num_total * PERCENTILE_99 / 100] / NS_PER_MS, (double)latencies[num_total - 1] / NS_PER_MS);
+
+        stop_overseer(overseer_pid);
+    }
+
+    free(latencies);
+    free(stormers);
+
+    return EXIT_SUCCESS;
+}
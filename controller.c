@@ -1,15 +1,16 @@
 /* Include Directives */
 
-#include <linux/limits.h>           // Implementation-defined constants.
 #include <stdlib.h>                 // Standard library definitions.
+#include <string.h>                 // String manipulation functions.
+#include <time.h>                   // Declares time and date functions.
 #include <unistd.h>                 // Declares a number of implementation-specific functions.
 #include "controller_functions.h"   // Defines all of the macros and declares all of the functions used in controller.c.
 
 /*
  * Function main(): Main function reponsible for calling individual functions.
  * 
- * Algorithm: Call functions to validate arguments, connect to the overseer, concatenate the arguments, send the arguments and if applicable, receive 
- * memory information.
+ * Algorithm: Call functions to validate arguments, connect to the overseer, and either run a session, submit a batch of jobs, or send the 
+ * request and if applicable, receive memory information.
  * 
  * Input: Number of command line arguments (argc) and command line arguments (argv).
  * 
@@ -17,10 +18,11 @@
  */
 int main(int argc, char *argv[])
 {
-    char *overseer_ip;  // Overseer IP address. 
-    int overseer_port;  // Overseer port number.
-    int show_mem_info;  // Indicates whether memory information was requested from the overseer.
-    int sock_fd;        // Socket file descriptor.
+    int exit_code = EXIT_SUCCESS;   // Exit code.
+    char *overseer_ip;              // Overseer IP address. 
+    int overseer_port;              // Overseer port number.
+    int show_mem_info;              // Indicates whether memory information or output was requested from the overseer.
+    int sock_fd;                    // Socket file descriptor.
 
     show_mem_info = validate_args(argc, argv);
 
@@ -29,23 +31,28 @@ int main(int argc, char *argv[])
 
     sock_fd = connect_to(overseer_ip, overseer_port);
 
-    char *args = malloc(sizeof(char) * PATH_MAX); // Arguments to be sent to overseer. 
-
-    if (!args)
+    if (!strcmp(argv[FLAG_1_ARG_INDEX], "session"))
     {
-        exit(EXIT_FAILURE);
+        run_session(sock_fd, argv);
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "submit-batch"))
+    {
+        if (submit_batch(sock_fd, argv))
+        {
+            exit_code = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        send_args(sock_fd, 0, argc, argv);
     }
-
-    concat_args(argc, args, argv);
-    send_args(sock_fd, args);
 
     if (show_mem_info)
     {
         get_print_mem_info(sock_fd);
     }
 
-    free(args);
     close(sock_fd);
 
-    return EXIT_SUCCESS;
+    return exit_code;
 }
\ No newline at end of file
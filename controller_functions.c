@@ -3,13 +3,18 @@
 /* Include Directives */
 
 #include <ctype.h>                  // Defines functions that are used in character classification.
+#include <errno.h>                  // Defines macros for values that are used for error reporting.
 #include <linux/limits.h>           // Implementation-defined constants.
 #include <netdb.h>                  // Definitions for network database operations.
+#include <poll.h>                   // Definitions for the poll() function.
 #include <stdio.h>                  // Functions that deal with standard input and output.
 #include <stdlib.h>                 // Standard library definitions.
 #include <string.h>                 // String manipulation functions.
+#include <sys/socket.h>             // Main sockets header.
+#include <time.h>                   // Declares time and date functions.
 #include <unistd.h>                 // Declares a number of implementation-specific functions.
 #include "controller_functions.h"   // Defines all of the macros and declares all of the functions used in controller.c
+#include "protocol_functions.h"     // Defines all of the macros and declares all of the functions of the wire protocol.
 
 /* Function Definitions */
 
@@ -17,27 +22,23 @@ int validate_args(int argc, char *argv[])
 {
     if (argc < MIN_ARGS_HELP) 
     {
-        fprintf(stderr, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] <file> [arg...] | mem [pid] | memkill <percent>}\n");
+        fprintf(stderr, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] [-m bytes] [-p high|normal|low] [-cpus count] <file> [arg...] | mem [--watch] [pid] | memkill <percent> | tail <pid> | watchdog [<percent> <seconds> [pid] | off [pid]] | session | submit-batch <manifest>}\n");
         exit(EXIT_FAILURE);
     }
 
     if (!strcmp(argv[IP_ARG_INDEX], "--help")) 
     {
-        fprintf(stdout, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] <file> [arg...] | mem [pid] | memkill <percent>}\n");
+        fprintf(stdout, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] [-m bytes] [-p high|normal|low] [-cpus count] <file> [arg...] | mem [--watch] [pid] | memkill <percent> | tail <pid> | watchdog [<percent> <seconds> [pid] | off [pid]] | session | submit-batch <manifest>}\n");
         exit(EXIT_SUCCESS);
     }
 
-    /* Check the correct types for each argument and that they are in the correct order. */
-    if (argc < MIN_ARGS || !is_num(argv[PORT_ARG_INDEX]) || (!strcmp(argv[FLAG_1_ARG_INDEX], "-o") && (argc < MIN_ARGS_1_FLAG ||
-        !strcmp(argv[FLAG_2_ARG_INDEX], "-o") || (!strcmp(argv[FLAG_2_ARG_INDEX], "-log") && argc < MIN_ARGS_2_FLAGS))) || 
-        (!strcmp(argv[FLAG_1_ARG_INDEX], "-log") && (argc < MIN_ARGS_1_FLAG || !strcmp(argv[FLAG_2_ARG_INDEX], "-o") || 
-        !strcmp(argv[FLAG_2_ARG_INDEX], "-log")))) 
+    if (!check_args(argc, argv)) 
     {
-        fprintf(stderr, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] <file> [arg...] | mem [pid] | memkill <percent>}\n");
+        fprintf(stderr, "Usage: controller <address> <port> {[-o out_file] [-log log_file] [-t seconds] [-m bytes] [-p high|normal|low] [-cpus count] <file> [arg...] | mem [--watch] [pid] | memkill <percent> | tail <pid> | watchdog [<percent> <seconds> [pid] | off [pid]] | session | submit-batch <manifest>}\n");
         exit(EXIT_FAILURE);
     }
 
-    if (!strcmp(argv[FLAG_1_ARG_INDEX], "mem"))
+    if (!strcmp(argv[FLAG_1_ARG_INDEX], "mem") || !strcmp(argv[FLAG_1_ARG_INDEX], "tail") || !strcmp(argv[FLAG_1_ARG_INDEX], "watchdog"))
     {
         return TRUE;
     }
@@ -47,6 +48,409 @@ int validate_args(int argc, char *argv[])
     }
 }
 
+int check_args(int argc, char *argv[])
+{
+    /* Check the correct types for each argument and that they are in the correct order. */
+    if (argc < MIN_ARGS || !is_num(argv[PORT_ARG_INDEX]) || (!strcmp(argv[FLAG_1_ARG_INDEX], "-o") && (argc < MIN_ARGS_1_FLAG ||
+        !strcmp(argv[FLAG_2_ARG_INDEX], "-o") || (!strcmp(argv[FLAG_2_ARG_INDEX], "-log") && argc < MIN_ARGS_2_FLAGS))) || 
+        (!strcmp(argv[FLAG_1_ARG_INDEX], "-log") && (argc < MIN_ARGS_1_FLAG || !strcmp(argv[FLAG_2_ARG_INDEX], "-log") || 
+        (!strcmp(argv[FLAG_2_ARG_INDEX], "-o") && argc < MIN_ARGS_2_FLAGS))) || (!strcmp(argv[FLAG_1_ARG_INDEX], "memkill") && argc == MIN_ARGS) || 
+        (!strcmp(argv[FLAG_1_ARG_INDEX], "submit-batch") && argc != BATCH_ARGS) || 
+        (!strcmp(argv[FLAG_1_ARG_INDEX], "tail") && (argc != TAIL_ARGS || !is_num(argv[MIN_ARGS]))) || 
+        (!strcmp(argv[FLAG_1_ARG_INDEX], "watchdog") && argc > MIN_ARGS && !strcmp(argv[MIN_ARGS], "off") && 
+        (argc > WATCHDOG_OFF_ARGS + 1 || (argc > WATCHDOG_OFF_ARGS && !is_num(argv[WATCHDOG_OFF_ARGS])))) || 
+        (!strcmp(argv[FLAG_1_ARG_INDEX], "watchdog") && argc > MIN_ARGS && strcmp(argv[MIN_ARGS], "off") && (argc < WATCHDOG_ARGS || 
+        argc > WATCHDOG_ARGS + 1 || atof(argv[MIN_ARGS]) <= 0 || atof(argv[FLAG_2_ARG_INDEX]) < 0 || 
+        (argc > WATCHDOG_ARGS && !is_num(argv[WATCHDOG_ARGS])))))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+int print_reply(struct frame_header *header, char *payload, int len, int show_id)
+{
+    char prefix[PREFIX_LEN] = "";   // Identifier of the request the reply belongs to, if shown.
+    char timestamp[TIME_STR_LEN];   // Timestamp of current sample.
+
+    if (show_id)
+    {
+        sprintf(prefix, "[%u] ", header->id);
+    }
+
+    payload[len] = '\0';
+
+    if (header->version != PROTOCOL_VERSION)
+    {
+        fprintf(stderr, "%sOverseer speaks protocol version %i\n", prefix, header->version);
+        exit(EXIT_FAILURE);
+    }
+
+    switch (header->type)
+    {
+        case MSG_ERROR:
+            fprintf(stderr, "%sOverseer rejected the request: %s\n", prefix, payload);
+            return TRUE;
+
+        case MSG_END:
+            if (show_id)
+            {
+                fprintf(stdout, "%sdone\n", prefix);
+            }
+            return TRUE;
+
+        case MSG_STARTED:
+            if (len == sizeof(int32_t))
+            {
+                fprintf(stdout, "%sstarted %i\n", prefix, get_be32(payload));
+            }
+            return TRUE;
+
+        case MSG_MEM_USAGE:
+            if (len >= MEM_USAGE_LEN)
+            {
+                fprintf(stdout, "%s%i %li %s\n", prefix, get_be32(payload), get_be64(payload + sizeof(int32_t)), payload + MEM_USAGE_LEN);
+            }
+            return FALSE;
+
+        case MSG_EVENT:
+            if (len == EVENT_LEN)
+            {
+                print_event(prefix, payload);
+            }
+            return FALSE;
+
+        case MSG_OUTPUT:
+            /* Output is passed on as it arrives, whether or not it ends in a newline. */
+            fprintf(stdout, "%s", prefix);
+            fwrite(payload, sizeof(char), len, stdout);
+            fflush(stdout);
+            return FALSE;
+
+        case MSG_POLICY:
+            if (len == POLICY_LEN && get_be32(payload + sizeof(int32_t)) == 0)
+            {
+                fprintf(stdout, "%sglobal off, %li actions\n", prefix, get_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t)));
+            }
+            else if (len == POLICY_LEN)
+            {
+                if (get_be32(payload))
+                {
+                    fprintf(stdout, "%s%i ", prefix, get_be32(payload));
+                }
+                else
+                {
+                    fprintf(stdout, "%sglobal ", prefix);
+                }
+
+                fprintf(stdout, "%.2f%% for %.3fs, %li actions\n", (double)get_be32(payload + sizeof(int32_t)) / HUNDRED_PERCENT, 
+                        (double)get_be64(payload + 2 * sizeof(int32_t)) / MS_PER_SECOND, get_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t)));
+            }
+            return FALSE;
+
+        case MSG_MEM_SAMPLE:
+            if (len == MEM_SAMPLE_LEN)
+            {
+                format_time(get_be64(payload), timestamp);
+                fprintf(stdout, "%s%s %li\n", prefix, timestamp, get_be64(payload + sizeof(int64_t)));
+            }
+            return FALSE;
+
+        default:
+            return FALSE;
+    }
+}
+
+int send_lines(int sock_fd, char *argv[], char *buf, size_t *buf_len, uint32_t *next_id, int max_lines)
+{
+    char *end;                                  // End of the current line.
+    int line_argc;                              // Number of arguments of the current line.
+    int num_sent = 0;                           // Number of requests sent.
+    char *line_argv[MAX_SESSION_ARGS];          // Arguments of the current line, preceded by those naming the overseer.
+    size_t line_len;                            // Length of the current line including its newline.
+
+    while (num_sent < max_lines && (end = memchr(buf, '\n', *buf_len)) != NULL)
+    {
+        *end = '\0';
+        line_len = end - buf + 1;
+
+        line_argc = split_line(buf, argv, line_argv);
+
+        if (line_argc == ERROR)
+        {
+            fprintf(stderr, "Unclosed quote\n");
+        }
+        else if (line_argc > FLAG_1_ARG_INDEX)
+        {
+            if (!check_args(line_argc, line_argv) || !strcmp(line_argv[FLAG_1_ARG_INDEX], "session") || 
+                !strcmp(line_argv[FLAG_1_ARG_INDEX], "submit-batch"))
+            {
+                fprintf(stderr, "Usage: {[-o out_file] [-log log_file] [-t seconds] [-m bytes] [-p high|normal|low] [-cpus count] <file> [arg...] | mem [--watch] [pid] | memkill <percent> | tail <pid> | watchdog [<percent> <seconds> [pid] | off [pid]]}\n");
+            }
+            else
+            {
+                send_args(sock_fd, (*next_id)++, line_argc, line_argv);
+                num_sent++;
+            }
+        }
+
+        *buf_len -= line_len;
+        memmove(buf, buf + line_len, *buf_len);
+    }
+
+    return num_sent;
+}
+
+int split_line(char *line, char *argv[], char **line_argv)
+{
+    int found = TRUE;   // Result of reading the current argument.
+    int line_argc;      // Number of arguments of the line.
+
+    for (line_argc = 0; line_argc < FLAG_1_ARG_INDEX; line_argc++)
+    {
+        line_argv[line_argc] = argv[line_argc];
+    }
+
+    /* The line is split as the overseer splits a command, so a quoted argument reaches the job intact. */
+    line[strcspn(line, "\r")] = '\0';
+
+    while (line_argc < MAX_SESSION_ARGS - 1 && (found = next_token(&line, &line_argv[line_argc])) == TRUE)
+    {
+        line_argc++;
+    }
+
+    line_argv[line_argc] = NULL;
+
+    return found == ERROR ? ERROR : line_argc;
+}
+
+int read_manifest(char *manifest, char *argv[], struct batch_chunk **chunks, int **line_nums)
+{
+    FILE *manifest_fp;                  // Manifest file stream.
+    char *line = NULL;                  // Current line of the manifest.
+    size_t line_cap = 0;                // Capacity of line.
+    ssize_t line_len;                   // Length of the current line.
+    int line_argc;                      // Number of arguments of the current line.
+    int line_num = 0;                   // Number of the current line.
+    int num_chunks = 0;                 // Number of chunks.
+    int num_jobs = 0;                   // Number of jobs.
+    int max_jobs = 0;                   // Capacity of line_nums.
+    struct batch_chunk *chunk = NULL;   // Chunk being filled.
+    char *line_argv[MAX_SESSION_ARGS];  // Arguments of the current line, preceded by those naming the overseer.
+
+    char *job = malloc(sizeof(char) * PATH_MAX); // Copy of the current line, as splitting it into arguments modifies it.
+
+    if ((manifest_fp = fopen(manifest, "r")) == NULL)
+    {
+        fprintf(stderr, "Could not open manifest %s\n", manifest);
+        exit(EXIT_FAILURE);
+    }
+
+    *chunks = NULL;
+    *line_nums = NULL;
+
+    while ((line_len = getline(&line, &line_cap, manifest_fp)) != ERROR)
+    {
+        line_num++;
+        line[strcspn(line, "\r\n")] = '\0';
+        line_len = strlen(line);
+
+        if (line[strspn(line, " \t")] == '\0' || line[strspn(line, " \t")] == '#')
+        {
+            continue;
+        }
+
+        /* The whole manifest is checked before any job is sent, so a mistake cannot leave a batch half launched. */
+        if (line_len >= PATH_MAX - 1 || !job)
+        {
+            fprintf(stderr, "Line %i of %s is too long\n", line_num, manifest);
+            exit(EXIT_FAILURE);
+        }
+
+        strcpy(job, line);
+
+        if ((line_argc = split_line(job, argv, line_argv)) == ERROR)
+        {
+            fprintf(stderr, "Line %i of %s has an unclosed quote\n", line_num, manifest);
+            exit(EXIT_FAILURE);
+        }
+
+        if (!check_args(line_argc, line_argv) || !strcmp(line_argv[FLAG_1_ARG_INDEX], "mem") || 
+            !strcmp(line_argv[FLAG_1_ARG_INDEX], "memkill") || !strcmp(line_argv[FLAG_1_ARG_INDEX], "session") || 
+            !strcmp(line_argv[FLAG_1_ARG_INDEX], "submit-batch") || !strcmp(line_argv[FLAG_1_ARG_INDEX], "tail") || 
+            !strcmp(line_argv[FLAG_1_ARG_INDEX], "watchdog"))
+        {
+            fprintf(stderr, "Line %i of %s is not a job: [-o out_file] [-log log_file] [-t seconds] [-m bytes] [-p high|normal|low] [-cpus count] <file> [arg...]\n", line_num, manifest);
+            exit(EXIT_FAILURE);
+        }
+
+        /* Jobs are packed into chunks which each fit in a single request. */
+        if (!chunk || chunk->len + line_len + 1 > PATH_MAX - 1)
+        {
+            if ((*chunks = realloc(*chunks, sizeof(struct batch_chunk) * (num_chunks + 1))) == NULL)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            chunk = &(*chunks)[num_chunks++];
+            chunk->jobs = malloc(sizeof(char) * PATH_MAX);
+            chunk->len = 0;
+            chunk->first_job = num_jobs;
+            chunk->num_jobs = 0;
+
+            if (!chunk->jobs)
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (num_jobs == max_jobs)
+        {
+            max_jobs = max_jobs ? max_jobs * 2 : PATH_MAX;
+
+            if ((*line_nums = realloc(*line_nums, sizeof(int) * max_jobs)) == NULL)
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        (*line_nums)[num_jobs++] = line_num;
+        sprintf(chunk->jobs + chunk->len, "%s\n", line);
+        chunk->len += line_len + 1;
+        chunk->num_jobs++;
+    }
+
+    if (fclose(manifest_fp))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    free(job);
+    free(line);
+
+    return num_chunks;
+}
+
+int submit_batch(int sock_fd, char *argv[])
+{
+    int index;                      // Index of a dispatched job within its chunk.
+    int len;                        // Length of the received payload.
+    int num_chunks;                 // Number of chunks of the manifest.
+    int num_failed = 0;             // Number of jobs which were not launched.
+    int num_pending = 0;            // Number of chunks sent whose reply has not been received.
+    int num_queued = 0;             // Number of queued jobs not yet dispatched, less those dispatched before their chunk's reply arrived.
+    int num_sent = 0;               // Number of chunks sent.
+    int pid;                        // Process ID of the current job.
+    struct batch_chunk *chunk;      // Chunk the received reply belongs to.
+    struct batch_chunk *chunks;     // Chunks of the manifest.
+    struct frame_header header;     // Header of the received frame.
+    int *line_nums;                 // Manifest line number of each job.
+
+    char *payload = malloc(sizeof(char) * (MAX_PAYLOAD_LEN + 1)); // Payload of the received frame.
+
+    if (!payload)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    num_chunks = read_manifest(argv[MIN_ARGS], argv, &chunks, &line_nums);
+
+    /* Queued jobs are waited for too, as each is only given a pid once the scheduler dispatches it. */
+    while (num_sent < num_chunks || num_pending > 0 || num_queued > 0)
+    {
+        /* Chunks are pipelined up to the overseer's limit on requests in flight, each identified by its index. */
+        for (; num_sent < num_chunks && num_pending < SESSION_MAX_REQUESTS; num_sent++, num_pending++)
+        {
+            if (send_frame(sock_fd, MSG_SUBMIT, num_sent + 1, chunks[num_sent].jobs, chunks[num_sent].len) == ERROR)
+            {
+                fprintf(stderr, "Connection to overseer lost\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if ((len = recv_frame(sock_fd, &header, payload, MAX_PAYLOAD_LEN)) == ERROR)
+        {
+            fprintf(stderr, "Connection to overseer lost\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (header.id < 1 || header.id > num_sent)
+        {
+            continue;
+        }
+
+        chunk = &chunks[header.id - 1];
+
+        if (header.type == MSG_DISPATCHED)
+        {
+            if (len == DISPATCHED_LEN && (index = get_be32(payload)) >= 0 && index < chunk->num_jobs)
+            {
+                num_queued--;
+
+                if (get_be32(payload + 2 * sizeof(int32_t)) == JOB_STARTED)
+                {
+                    fprintf(stdout, "%i %i\n", line_nums[chunk->first_job + index], get_be32(payload + sizeof(int32_t)));
+                }
+                else
+                {
+                    fprintf(stderr, "Line %i could not be executed\n", line_nums[chunk->first_job + index]);
+                    num_failed++;
+                }
+            }
+
+            continue;
+        }
+
+        num_pending--;
+
+        if (header.type != MSG_SUBMITTED || len != chunk->num_jobs * JOB_STATUS_LEN)
+        {
+            print_reply(&header, payload, len, FALSE);
+            num_failed += chunk->num_jobs;
+            continue;
+        }
+
+        for (int i = 0; i < chunk->num_jobs; i++)
+        {
+            pid = get_be32(payload + i * JOB_STATUS_LEN);
+
+            switch (get_be32(payload + i * JOB_STATUS_LEN + sizeof(int32_t)))
+            {
+                case JOB_STARTED:
+                    fprintf(stdout, "%i %i\n", line_nums[chunk->first_job + i], pid);
+                    break;
+
+                case JOB_QUEUED:
+                    fprintf(stdout, "%i queued\n", line_nums[chunk->first_job + i]);
+                    num_queued++;
+                    break;
+
+                case JOB_FAILED:
+                    fprintf(stderr, "Line %i could not be executed\n", line_nums[chunk->first_job + i]);
+                    num_failed++;
+                    break;
+
+                default:
+                    fprintf(stderr, "Line %i was rejected\n", line_nums[chunk->first_job + i]);
+                    num_failed++;
+                    break;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_chunks; i++)
+    {
+        free(chunks[i].jobs);
+    }
+
+    free(chunks);
+    free(line_nums);
+    free(payload);
+
+    return num_failed;
+}
+
 int is_num(char *str) {
     for (int i = 0; i < strlen(str); i++)
     {
@@ -86,41 +490,263 @@ int connect_to(char *overseer_ip, int overseer_port)
 
 void concat_args(int argc, char *args, char **argv) 
 {
-    strcpy(args, argv[MIN_ARGS - 1]);
+    char *end = args; // End of the arguments written so far.
 
-    if (argc > MIN_ARGS) 
+    for (int i = MIN_ARGS - 1; i < argc; i++)
     {
-        for (int i = MIN_ARGS; i < argc; i++)
+        /* Quoting at most doubles an argument and adds its quotes and the space before it. */
+        if (end - args + 2 * strlen(argv[i]) + 4 > PATH_MAX)
         {
-            strcat(args, " ");
-            strcat(args, argv[i]);
+            fprintf(stderr, "Command is too long\n");
+            exit(EXIT_FAILURE);
         }
+
+        if (i > MIN_ARGS - 1)
+        {
+            *end++ = ' ';
+        }
+
+        end = quote_arg(end, argv[i]);
     }
 }
 
-void send_args(int sock_fd, char *args) 
+void format_time(time_t raw_time, char *time_fmt)
+{
+    struct tm current_time; // Broken-down time.
+
+    localtime_r(&raw_time, &current_time);
+
+    sprintf(time_fmt, "%d-%02d-%02d %02d:%02d:%02d", current_time.tm_year + 1900, current_time.tm_mon + 1, current_time.tm_mday, 
+            current_time.tm_hour, current_time.tm_min, current_time.tm_sec);
+}
+
+void send_args(int sock_fd, uint32_t id, int argc, char **argv) 
 {
-    if (send(sock_fd, args, PATH_MAX, 0) == ERROR) 
+    int result; // Result of sending the request.
+
+    char *payload = calloc(PATH_MAX, sizeof(char)); // Payload of the request.
+
+    if (!payload)
     {
         exit(EXIT_FAILURE);
     }
+
+    if (!strcmp(argv[FLAG_1_ARG_INDEX], "mem") && argc > MIN_ARGS && !strcmp(argv[MIN_ARGS], "--watch"))
+    {
+        put_be32(payload, argc > WATCH_PID_ARG_INDEX ? atoi(argv[WATCH_PID_ARG_INDEX]) : 0);
+        result = send_frame(sock_fd, MSG_WATCH, id, payload, sizeof(int32_t));
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "mem"))
+    {
+        put_be32(payload, argc > MIN_ARGS ? atoi(argv[MIN_ARGS]) : 0);
+        result = send_frame(sock_fd, MSG_MEM, id, payload, sizeof(int32_t));
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "tail"))
+    {
+        put_be32(payload, atoi(argv[MIN_ARGS]));
+        result = send_frame(sock_fd, MSG_TAIL, id, payload, sizeof(int32_t));
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "memkill"))
+    {
+        put_be32(payload, atof(argv[MIN_ARGS]) * HUNDRED_PERCENT + 0.5);
+        result = send_frame(sock_fd, MSG_MEMKILL, id, payload, sizeof(int32_t));
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "watchdog") && argc == MIN_ARGS)
+    {
+        result = send_frame(sock_fd, MSG_WATCHDOG, id, NULL, 0);
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "watchdog") && !strcmp(argv[MIN_ARGS], "off"))
+    {
+        put_be32(payload, argc > WATCHDOG_OFF_ARGS ? atoi(argv[WATCHDOG_OFF_ARGS]) : 0);
+        result = send_frame(sock_fd, MSG_WATCHDOG, id, payload, sizeof(int32_t));
+    }
+    else if (!strcmp(argv[FLAG_1_ARG_INDEX], "watchdog"))
+    {
+        put_be32(payload, argc > WATCHDOG_ARGS ? atoi(argv[WATCHDOG_ARGS]) : 0);
+        put_be32(payload + sizeof(int32_t), atof(argv[MIN_ARGS]) * HUNDRED_PERCENT + 0.5);
+        put_be64(payload + 2 * sizeof(int32_t), atof(argv[FLAG_2_ARG_INDEX]) * MS_PER_SECOND + 0.5);
+        result = send_frame(sock_fd, MSG_WATCHDOG, id, payload, WATCHDOG_LEN);
+    }
+    else
+    {
+        concat_args(argc, payload, argv);
+        result = send_frame(sock_fd, MSG_EXEC, id, payload, strlen(payload));
+    }
+
+    if (result == ERROR) 
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    free(payload);
 }
 
 void get_print_mem_info(int sock_fd)
 {
-    int num_bytes; // Number of bytes read from sock_fd.
+    int len;                    // Length of the received payload.
+    struct frame_header header; // Header of the received frame.
+
+    char *payload = malloc(sizeof(char) * (MAX_PAYLOAD_LEN + 1)); // Payload of the received frame.
+
+    if (!payload)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while ((len = recv_frame(sock_fd, &header, payload, MAX_PAYLOAD_LEN)) != ERROR && !print_reply(&header, payload, len, FALSE));
+
+    if (len == ERROR)
+    {
+        fprintf(stderr, "Connection to overseer lost\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (header.type == MSG_ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    free(payload);
+}
+
+void print_event(char *prefix, char *payload)
+{
+    char timestamp[TIME_STR_LEN];   // Timestamp of the event.
+
+    int32_t pid = get_be32(payload + sizeof(int32_t));                          // Process ID the event concerns.
+    int64_t value = get_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t));  // Value of the event.
+
+    format_time(get_be64(payload + 2 * sizeof(int32_t)), timestamp);
+
+    switch (get_be32(payload))
+    {
+        case EVENT_SAMPLE:
+            fprintf(stdout, "%s%s %i %li\n", prefix, timestamp, pid, value);
+            break;
+
+        case EVENT_STARTED:
+            fprintf(stdout, "%s%s %i started\n", prefix, timestamp, pid);
+            break;
+
+        case EVENT_EXITED:
+            fprintf(stdout, "%s%s %i exited %li\n", prefix, timestamp, pid, value);
+            break;
+
+        case EVENT_KILLED:
+            fprintf(stdout, "%s%s %i killed by signal %li\n", prefix, timestamp, pid, value);
+            break;
+
+        case EVENT_DROPPED:
+            fprintf(stdout, "%s%s dropped %li events\n", prefix, timestamp, value);
+            break;
+
+        case EVENT_OUTPUT_DROPPED:
+            /* Reported on stderr, so that the tailed output on stdout is left as the process wrote it. */
+            fprintf(stderr, "%s%s %i dropped %li bytes of output\n", prefix, timestamp, pid, value);
+            break;
+
+        case EVENT_MEMORY_HIGH:
+            fprintf(stdout, "%s%s %i throttled %li times\n", prefix, timestamp, pid, value);
+            break;
+
+        case EVENT_OOM_KILL:
+            fprintf(stdout, "%s%s %i oom-killed %li processes\n", prefix, timestamp, pid, value);
+            break;
+    }
+
+    /* Events arrive indefinitely, so each is passed on as soon as it is printed. */
+    fflush(stdout);
+}
+
+void run_session(int sock_fd, char *argv[])
+{
+    int len;                                            // Length of the received payload.
+    int num_pending = 0;                                // Number of requests sent whose final reply has not been received.
+    int reading = TRUE;                                 // Indicates whether standard input is still being read.
+    int writing = TRUE;                                 // Indicates whether further requests may still be sent.
+    size_t buf_len = 0;                                 // Number of bytes of standard input buffered.
+    ssize_t num_bytes;                                  // Number of bytes read from standard input.
+    struct frame_header header;                         // Header of the received frame.
+    struct pollfd fds[NUM_SESSION_FDS] = {{STDIN_FILENO, POLLIN, 0}, {sock_fd, POLLIN, 0}}; // Standard input and the overseer socket.
+    uint32_t next_id = 1;                               // Identifier of the next request.
 
-    char *buf = malloc(sizeof(char) * PATH_MAX);
+    char *buf = malloc(sizeof(char) * PATH_MAX);                    // Buffered standard input.
+    char *payload = malloc(sizeof(char) * (MAX_PAYLOAD_LEN + 1));   // Payload of the received frame.
+
+    if (!buf || !payload)
+    {
+        exit(EXIT_FAILURE);
+    }
 
-    while((num_bytes = recv(sock_fd, buf, PATH_MAX, 0)) != 0)
+    while (reading || num_pending > 0)
     {
-        if (num_bytes == ERROR)
+        /* Send each complete line while the overseer will keep reading, so neither end can block the other's writes indefinitely. */
+        num_pending += send_lines(sock_fd, argv, buf, &buf_len, &next_id, SESSION_MAX_REQUESTS - num_pending);
+
+        if (reading && buf_len == PATH_MAX - 1 && !memchr(buf, '\n', buf_len))
+        {
+            fprintf(stderr, "Command too long\n");
+            buf_len = 0;
+        }
+
+        if (!reading && buf_len > 0 && num_pending < SESSION_MAX_REQUESTS)
         {
+            /* Send the final line, which has no terminating newline. */
+            buf[buf_len++] = '\n';
+            continue;
+        }
+
+        if (!reading && num_pending == 0)
+        {
+            break;
+        }
+
+        fds[0].fd = reading && num_pending < SESSION_MAX_REQUESTS && !memchr(buf, '\n', buf_len) ? STDIN_FILENO : ERROR;
+
+        if (poll(fds, NUM_SESSION_FDS, ERROR) == ERROR)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
             exit(EXIT_FAILURE);
         }
 
-        fprintf(stdout, "%s", buf);
+        if (fds[1].revents)
+        {
+            if ((len = recv_frame(sock_fd, &header, payload, MAX_PAYLOAD_LEN)) == ERROR)
+            {
+                fprintf(stderr, "Connection to overseer lost\n");
+                exit(EXIT_FAILURE);
+            }
+
+            if (print_reply(&header, payload, len, TRUE))
+            {
+                num_pending--;
+            }
+        }
+
+        if (fds[0].fd != ERROR && fds[0].revents)
+        {
+            if ((num_bytes = read(STDIN_FILENO, buf + buf_len, PATH_MAX - 1 - buf_len)) > 0)
+            {
+                buf_len += num_bytes;
+            }
+            else if (num_bytes == 0 || errno != EINTR)
+            {
+                reading = FALSE;
+            }
+        }
+
+        if (!reading && buf_len == 0 && writing)
+        {
+            /* Tell the overseer no further requests will follow, while still receiving the replies to those in flight. */
+            shutdown(sock_fd, SHUT_WR);
+            writing = FALSE;
+        }
     }
 
     free(buf);
+    free(payload);
 }
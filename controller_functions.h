@@ -3,22 +3,61 @@
 #ifndef __CONTROLLER_FUNCTIONS_H__
 #define __CONTROLLER_FUNCTIONS_H__
 
+/* Include Directives */
+
+#include <stddef.h>         // Defines size_t.
+#include <stdint.h>         // Defines exact-width integer types.
+
 /* Macro Definitions */
 
+#define BATCH_ARGS 5        // Number of arguments required for correct usage of submit-batch.
 #define ERROR -1            // Typical value returned by various functions to indicate error. 
 #define FALSE 0             // Integer representation of truth-value false.
 #define FLAG_1_ARG_INDEX 3  // Index of first flag within command line arguments.
 #define FLAG_2_ARG_INDEX 5  // Index of second flag within command line arguments. 
+#define HUNDRED_PERCENT 100 // One hundred percent.
 #define IP_ARG_INDEX 1      // Index of overseer IP adress within command line arguments.
+#define MAX_SESSION_ARGS (PATH_MAX / 2 + FLAG_1_ARG_INDEX + 1) // Maximum number of arguments of a session command, including those naming the overseer.
 #define MIN_ARGS 4          // Absolute minimum number of arguments required for correct usage. 
 #define MIN_ARGS_1_FLAG 6   // Minimum number of arguments required for correct usage when using one flag.
 #define MIN_ARGS_2_FLAGS 8  // Minimum number of arguments required for correct usage when using two flags.
 #define MIN_ARGS_HELP 2     // Minimum number of arguments required to receive usage message.
+#define MS_PER_SECOND 1000  // Number of milliseconds in a second.
+#define NUM_SESSION_FDS 2   // Number of file descriptors polled by a session (standard input and the overseer socket).
 #define PORT_ARG_INDEX 2    // Index of overseer port within command line arguments.
+#define PREFIX_LEN 16       // Size of the buffer holding the request identifier printed before a reply.
+#define TAIL_ARGS 5         // Number of arguments required for correct usage of tail.
+#define TIME_STR_LEN 28     // The string length of a timestamp.
 #define TRUE 1              // Integer representation of truth-value true.
+#define WATCH_PID_ARG_INDEX 5 // Index of the pid to watch within command line arguments.
+#define WATCHDOG_ARGS 6     // Number of arguments required to install the global watchdog policy, one fewer than for a process' policy.
+#define WATCHDOG_OFF_ARGS 5 // Number of arguments required to remove the global watchdog policy, one fewer than for a process' policy.
+
+/* Structure Definitions */
+
+struct frame_header;
+
+struct batch_chunk // Structure describing a run of consecutive jobs of a manifest, sent to the overseer as a single MSG_SUBMIT request.
+{
+    char *jobs;     // Jobs, one per line.
+    size_t len;     // Length of jobs.
+    int first_job;  // Index of the first job within the manifest's jobs.
+    int num_jobs;   // Number of jobs.
+};
 
 /* Function Declarations */
 
+/*
+ * Function check_args(): Checks the provided command line arguments.
+ * 
+ * Algorithm: Check the correct types for each argument and that they are in the correct order.
+ * 
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ * 
+ * Output: Indication of whether the arguments are valid.
+ */
+int check_args(int argc, char *argv[]);
+
 /*
  * Function connect_to(): Initialises connection to overseer.
  * 
@@ -41,33 +80,111 @@ int connect_to(char *overseer_ip, int overseer_port);
  */
 int is_num(char *str);
 
+/*
+ * Function print_reply(): Prints a reply received from the overseer.
+ * 
+ * Algorithm: Print the process, sample, event, output, watchdog policy, launched process or rejection the frame describes, preceded by the identifier of its request if 
+ * requested, and exit if the overseer speaks another version of the protocol.
+ * 
+ * Input: Header of the frame (header), payload of the frame with room for a terminating null byte (payload), length of the payload (len) and 
+ * indication of whether to print the request identifier (show_id).
+ * 
+ * Output: Indication of whether the frame is the final reply to its request.
+ */
+int print_reply(struct frame_header *header, char *payload, int len, int show_id);
+
+/*
+ * Function send_lines(): Sends the complete lines of a session's buffered input as requests.
+ * 
+ * Algorithm: Split each line into arguments, prepend those naming the overseer, check them and send the request with the next identifier, 
+ * printing a usage message instead for an invalid line. Stop once the specified number of requests have been sent.
+ * 
+ * Input: Socket file descriptor (sock_fd), command line arguments (argv), buffered input (buf) and its length (buf_len), identifier of the next 
+ * request (next_id) and maximum number of requests to send (max_lines).
+ * 
+ * Output: Number of requests sent.
+ */
+int send_lines(int sock_fd, char *argv[], char *buf, size_t *buf_len, uint32_t *next_id, int max_lines);
+
+/*
+ * Function split_line(): Splits a line of commands into arguments.
+ * 
+ * Algorithm: Copy the arguments naming the overseer, then split the line after them with next_token(), as the overseer splits a command.
+ * 
+ * Input: Line to split, which is modified (line), command line arguments (argv) and array of MAX_SESSION_ARGS strings to hold the 
+ * arguments (line_argv).
+ * 
+ * Output: Number of arguments in line_argv, or ERROR if a quote is not closed.
+ */
+int split_line(char *line, char *argv[], char **line_argv);
+
+/*
+ * Function read_manifest(): Reads and checks a manifest of jobs.
+ * 
+ * Algorithm: Read the manifest line by line, skipping blank lines and comments, and exit if any line is not a job. Pack the jobs into chunks 
+ * which each fit in a single request, recording the line number of each job.
+ * 
+ * Input: File path of the manifest (manifest), command line arguments (argv), pointer to hold the array of chunks (chunks) and pointer to hold 
+ * the array of line numbers (line_nums). The caller frees both arrays and the jobs of each chunk.
+ * 
+ * Output: Number of chunks.
+ */
+int read_manifest(char *manifest, char *argv[], struct batch_chunk **chunks, int **line_nums);
+
+/*
+ * Function submit_batch(): Submits every job of a manifest and prints the outcome of each.
+ * 
+ * Algorithm: Read the manifest, then pipeline its chunks as MSG_SUBMIT requests, keeping at most SESSION_MAX_REQUESTS outstanding. Print the 
+ * line number and pid of each job launched, and report those which were not. Wait for the MSG_DISPATCHED of each queued job, which may arrive 
+ * before the reply to its chunk, and print its pid in turn.
+ * 
+ * Input: Socket file descriptor (sock_fd) and command line arguments (argv).
+ * 
+ * Output: Number of jobs which were not launched.
+ */
+int submit_batch(int sock_fd, char *argv[]);
+
 /*
  * Function validate_args(): Validates the provided command line arguments.
  * 
  * Algorithm: Check if enough arguments have been provided, check if the help flag has been used, check the correct types for each argument and that 
- * they are in the correct order, check if the mem command has been used.
+ * they are in the correct order, check if the mem, tail or watchdog command has been used.
  * 
  * Input: Number of command line arguments (argc) and command line arguments (argv).
  * 
- * Output: Indication of whether memory information was requested from the overseer.
+ * Output: Indication of whether memory information, output or the watchdog policies were requested from the overseer.
  */
 int validate_args(int argc, char *argv[]);
 
 /*
  * Function concat_args(): Concatenates command line arguments.
  * 
- * Algorithm: Copy first argument into args, then append the remaining arguments to args.
+ * Algorithm: Write each argument from the first flag onwards with quote_arg(), separated by spaces, so that the overseer splits them back 
+ * into the same arguments. Exit if they would not fit.
  * 
- * Input: Number of command line arguments (argc), char array to hold string of arguments (args) and command line arguments (argv).
+ * Input: Number of command line arguments (argc), char array of PATH_MAX bytes to hold string of arguments (args) and command line arguments 
+ * (argv).
  * 
  * Output: None.
  */
 void concat_args(int argc, char *args, char **argv);
 
 /*
- * Function get_print_mem_info(): Receives and prints memory information from overseer.
+ * Function format_time(): Format the specified system time. 
+ * 
+ * Algorithm: Convert the time to local time and format it into a string.
  * 
- * Algorithm: As above.
+ * Input: System time (raw_time) and time string (time_fmt).
+ * 
+ * Output: None.
+ */
+void format_time(time_t raw_time, char *time_fmt);
+
+/*
+ * Function get_print_mem_info(): Receives and prints memory information or output from overseer.
+ * 
+ * Algorithm: Receive frames until MSG_END, printing each process, sample or piece of output they carry, and exit if the overseer rejects the 
+ * request or the connection is lost.
  * 
  * Input: Socket file descriptor (sock_fd).
  * 
@@ -75,16 +192,43 @@ void concat_args(int argc, char *args, char **argv);
  */
 void get_print_mem_info(int sock_fd);
 
+/*
+ * Function print_event(): Prints a child event pushed by the overseer.
+ * 
+ * Algorithm: Decode the event and print its time, the process it concerns and the memory usage, exit status, number of dropped events or 
+ * bytes of output, or number of memory.high or OOM kill events it carries, then flush standard output.
+ * 
+ * Input: Text printed before the event (prefix) and payload of the MSG_EVENT frame (payload).
+ * 
+ * Output: None.
+ */
+void print_event(char *prefix, char *payload);
+
+/*
+ * Function run_session(): Sends the commands read from standard input over a single connection and prints the replies as they arrive.
+ * 
+ * Algorithm: Poll standard input and the socket, sending each complete line as a request with its own identifier and printing each reply 
+ * preceded by the identifier of its request. Stop reading standard input while SESSION_MAX_REQUESTS requests are outstanding, so the overseer 
+ * never stops reading while this end is blocked sending. At the end of standard input, shut down the sending side of the socket and wait for 
+ * the final reply to every outstanding request.
+ * 
+ * Input: Socket file descriptor (sock_fd) and command line arguments (argv).
+ * 
+ * Output: None.
+ */
+void run_session(int sock_fd, char *argv[]);
 
 /*
- * Function send_args(): Send arguments to socket file descriptor.
+ * Function send_args(): Send the request described by the command line arguments to the overseer.
  * 
- * Algorithm: As above.
+ * Algorithm: Encode mem, memkill, tail and watchdog commands as MSG_MEM (or MSG_WATCH), MSG_MEMKILL, MSG_TAIL and MSG_WATCHDOG frames, 
+ * and any other command as a MSG_EXEC frame holding the concatenated arguments, then send the frame.
  * 
- * Input: Socket file descriptor (sock_fd) and arguments to send (args).
+ * Input: Socket file descriptor (sock_fd), identifier of the request (id), number of command line arguments (argc) and command line 
+ * arguments (argv).
  * 
  * Output: None.
  */
-void send_args(int sock_fd, char *args);
+void send_args(int sock_fd, uint32_t id, int argc, char **argv);
 
 #endif // __CONTROLLER_FUNCTIONS_H__
\ No newline at end of file
@@ -1,31 +1,52 @@
 /* Include Directives */
 
+#define _GNU_SOURCE             // Declares CPU_SETSIZE, which must be visible before the system headers are included.
+
 #include <arpa/inet.h>          // Definitions for internet operations.
-#include <fcntl.h>              // POSIX functions for creating, opening, rewriting, and manipulating files.
+#include <linux/limits.h>       // Implementation-defined constants.
 #include <pthread.h>            // Function declarations and mappings for threading interfaces and defines a number of constants used by those functions.
+#include <sched.h>              // Defines CPU sets.
 #include <stdio.h>              // Functions that deal with standard input and output.
 #include <stdlib.h>             // Standard library definitions.
 #include <unistd.h>             // Declares a number of implementation-specific functions.
 #include "overseer_functions.h" // Defines all of the macros and declares all of the functions used in controller.c.
+#include "protocol_functions.h" // Defines all of the macros and declares all of the functions of the wire protocol.
 
 /* Global Variables */
 
-int num_requests = 0;                   
+int supervisor_fd;
 int quit = FALSE;                  
-pthread_cond_t got_request;   
-pthread_mutex_t mem_mutex;      
+pthread_cond_t sampler_cond;
+pthread_mutex_t child_mutex;
 pthread_mutex_t quit_mutex;             
-pthread_mutex_t request_mutex;   
-struct mem_entry *last_entry = NULL;   
-struct mem_entry *mem_report = NULL;     
-struct request *last_request = NULL;    
-struct request *requests = NULL;       
+struct mem_sampler mem_samplers[NUM_MEM_SAMPLERS] = {{"statm", "/proc/%i/statm", sample_statm}, 
+                                                     {"smaps_rollup", "/proc/%i/smaps_rollup", sample_smaps_rollup}, 
+                                                     {"maps", "/proc/%i/maps", sample_maps}};
+struct mem_sampler *mem_sampler = &mem_samplers[0];
+struct mem_sampler cgroup_sampler = {"cgroup", "%s/memory.current", sample_memory_current};
+struct cgroup_tree cgroup_tree = {};
+struct proc_table proc_table = {};
+struct sample_batch sample_batch = {};
+struct watch_list watch_list = {};
+struct log_queue log_queue = {};
+struct capture_list capture_list = {};
+struct watchdog watchdog = {};
+struct admission admission = {{"memory", "cpu", NULL}, {"/proc/pressure/memory", "/proc/pressure/cpu"}};
+struct placement placement = {};
+struct scheduler scheduler = {{"high", "normal", "low", "max", NULL}};
+struct worker_pool worker_pool = {NUM_THREADS};
+struct reactor_pool reactor_pool = {0, SOMAXCONN};
+struct child *children = NULL;
+struct child *pending_children = NULL;
+struct child *spare_children = NULL;
+struct child *tripped_children = NULL;
 
 /*
  * Function main(): Main function reponsible for calling individual functions.
  * 
- * Algorithm: Call functions to initialise signal handling, initialise threads, listen for connections, accept connections, add requests to the 
- * queue and clean up.
+ * Algorithm: Parse the command line options, call functions to initialise signal handling, the placement engine, the log writer, threads, the 
+ * supervisor, the sampler, the publisher, the capture thread and, if enabled, the admission controller and the scheduler, start the reactors 
+ * which each listen for and accept connections and add requests to the queues, run the first reactor on the main thread, and clean up.
  * 
  * Input: Number of command line arguments (argc) and command line arguments (argv).
  * 
@@ -33,75 +54,124 @@ struct request *requests = NULL;
  */
 int main(int argc, char **argv)
 {
-    int overseer_port;                  // Overseer port number.
-    int new_fd;                         // Connection file descriptor.
-    int sock_fd;                        // Socket file descriptor.
-    pthread_t p_threads[NUM_THREADS];   // Array of thread identifiers.
-    struct sockaddr_in controller_addr; // Internet address of controller.
+    char *end;                                  // End of the rotation length option.
+    int opt;                                    // Current command line option.
+    int overseer_port;                          // Overseer port number.
+    int signal_fd;                              // Signal file descriptor.
+    pthread_t admission_thread;                 // Admission thread identifier.
+    pthread_t capture_thread;                   // Capture thread identifier.
+    pthread_t dispatcher_thread;                // Dispatcher thread identifier.
+    pthread_t logger_thread;                    // Log writer thread identifier.
+    pthread_t publisher_thread;                 // Publisher thread identifier.
+    pthread_t sampler_threads[SAMPLER_THREADS]; // Array of sampler thread identifiers.
+    pthread_t supervisor_thread;                // Supervisor thread identifier.
+
+    while ((opt = getopt(argc, argv, "a:b:cg:j:p:r:s:w:")) != ERROR)
+    {
+        /* A rotation length only applies to captured output, so it implies capture. */
+        if (opt == 'c' || opt == 'r')
+        {
+            capture_list.enabled = TRUE;
+        }
+
+        if ((opt == 'r' && ((capture_list.rotate_len = strtol(optarg, &end, 10)) <= 0 || *end != '\0')) || 
+            (opt == 'w' && ((worker_pool.num_workers = strtol(optarg, &end, 10)) <= 0 || worker_pool.num_workers > MAX_WORKERS || 
+                              *end != '\0')) || 
+            (opt == 'a' && ((reactor_pool.num_reactors = strtol(optarg, &end, 10)) <= 0 || reactor_pool.num_reactors > MAX_REACTORS || 
+                              *end != '\0')) || 
+            (opt == 'b' && ((reactor_pool.backlog = strtol(optarg, &end, 10)) <= 0 || *end != '\0')) || 
+            (opt == 's' && (mem_sampler = find_mem_sampler(optarg)) == NULL) || (opt == 'p' && parse_pressure(optarg) == ERROR) || 
+            (opt == 'j' && parse_limits(optarg) == ERROR) || opt == '?')
+        {
+            fprintf(stderr, "Usage: overseer [-s statm|smaps_rollup|maps] [-c] [-r bytes] [-g cgroup] [-p memory=percent,cpu=percent] "
+                            "[-j high=count,normal=count,low=count,max=count] [-w workers] [-a acceptors] [-b backlog] <port>\n");
+            exit(EXIT_FAILURE);
+        }
 
-    if (argc != NUM_ARGS)
+        if (opt == 'g')
+        {
+            cgroup_tree.root = optarg;
+        }
+    }
+
+    if (argc - optind != NUM_ARGS)
     {
-        fprintf(stderr, "Usuage: overseer <port>\n");
+        fprintf(stderr, "Usage: overseer [-s statm|smaps_rollup|maps] [-c] [-r bytes] [-g cgroup] [-p memory=percent,cpu=percent] "
+                            "[-j high=count,normal=count,low=count,max=count] [-w workers] [-a acceptors] [-b backlog] <port>\n");
         exit(EXIT_FAILURE);
     }
 
-    init_SIGINT_handling();
-    init_threads(p_threads, handle_requests);
-
-    overseer_port = htons(atoi(argv[PORT_ARG_INDEX])); 
-    listen_to(&sock_fd, overseer_port);
-    fcntl(sock_fd, F_SETFL, O_NONBLOCK);
-    
-    if (pthread_mutex_lock(&quit_mutex))
+    /* The subtree is prepared before the supervisor starts, as the supervisor polls the jobs' cgroups. */
+    if (cgroup_tree.root != NULL && init_cgroup_tree(cgroup_tree.root) == ERROR)
     {
+        fprintf(stderr, "Could not enable the memory controller in %s\n", cgroup_tree.root);
         exit(EXIT_FAILURE);
     }
-    
-    while (!quit)
+
+    signal_fd = init_signal_fd();
+    init_placement();
+    init_logger(&logger_thread);
+    init_threads(handle_requests);
+    init_supervisor(&supervisor_thread);
+    init_sampler(sampler_threads);
+    init_publisher(&publisher_thread);
+    init_capture(&capture_thread);
+
+    if (scheduler.enabled)
     {
-        if (pthread_mutex_unlock(&quit_mutex))
-        {
-            exit(EXIT_FAILURE);
-        }
+        init_scheduler(&dispatcher_thread);
+    }
 
-        if ((new_fd = accept_conn(sock_fd, &controller_addr)) == ERROR)
-        {
-            usleep(BUSY_WAIT_SLEEP);
-            continue;
-        }
+    if (admission.enabled && init_admission(&admission_thread) == ERROR)
+    {
+        fprintf(stderr, "Could not subscribe to pressure notifications\n");
+        exit(EXIT_FAILURE);
+    }
 
-        add_request(controller_addr, new_fd);
+    overseer_port = htons(atoi(argv[optind])); 
 
-        if (pthread_mutex_lock(&quit_mutex))
-        {
-            exit(EXIT_FAILURE);
-        }
+    /* By default connections are accepted on as many listening sockets as there are cores to accept them on. */
+    if (!reactor_pool.num_reactors)
+    {
+        reactor_pool.num_reactors = placement.num_cpus < MAX_REACTORS ? placement.num_cpus : MAX_REACTORS;
     }
 
-    if (pthread_mutex_unlock(&quit_mutex))
+    init_reactors(overseer_port, &signal_fd);
+    run_reactor(&reactor_pool.reactors[0], &signal_fd);
+    stop_reactors();
+
+    if (close(signal_fd))
     {
         exit(EXIT_FAILURE);
     }
 
-    if (close(sock_fd))
+    stop_threads();
+
+    /* Held launches are released or rejected before the supervisor, which adopts launched children, terminates. */
+    if (admission.enabled)
     {
-        exit(EXIT_FAILURE);
+        stop_admission(admission_thread);
     }
 
-    if (pthread_cond_broadcast(&got_request))
+    /* Queued jobs are rejected after held launches, which may queue on release. */
+    if (scheduler.enabled)
     {
-        exit(EXIT_FAILURE);
+        stop_scheduler(dispatcher_thread);
     }
 
-    for (int i = 0; i < NUM_THREADS; i++)
+    wake_supervisor();
+
+    if (pthread_join(supervisor_thread, NULL) || (cgroup_tree.root != NULL && close(cgroup_tree.epoll_fd)))
     {
-        if (pthread_join(p_threads[i], NULL))
-        {
-            exit(EXIT_FAILURE);
-        }
+        exit(EXIT_FAILURE);
     }
 
+    stop_sampler(sampler_threads);
+    stop_capture(capture_thread);
+    stop_publisher(publisher_thread);
+
     clean_up_unhandled_reqs();
+    stop_logger(logger_thread);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -2,19 +2,36 @@
 
 /* Include Directives */
 
+#define _GNU_SOURCE             // Declares accept4(), which must be visible before the system headers are included.
+
 #include <arpa/inet.h>          // Definitions for internet operations.
+#include <dirent.h>             // Declares functions for reading directories.
 #include <errno.h>              // Defines macros for values that are used for error reporting.
 #include <fcntl.h>              // POSIX functions for creating, opening, rewriting, and manipulating files.
+#include <limits.h>             // Defines the limits of integral types.
 #include <linux/limits.h>       // Implementation-defined constants.
+#include <linux/mempolicy.h>    // Defines the memory policy modes.
+#include <poll.h>               // Definitions for the poll() function.
 #include <pthread.h>            // Function declarations and mappings for threading interfaces and defines a number of constants used by those functions.
+#include <sched.h>              // Declares functions for CPU affinity.
+#include <spawn.h>              // Declares functions for spawning processes.
+#include <stdarg.h>             // Macros for handling variable arguments.
 #include <stdio.h>              // Functions that deal with standard input and output.
 #include <stdlib.h>             // Standard library definitions.
 #include <string.h>             // String manipulation functions.
+#include <sys/epoll.h>          // Declares functions for the epoll I/O event notification facility.
+#include <sys/eventfd.h>        // Declares functions for creating event notification file descriptors.
+#include <sys/ioctl.h>          // Declares functions for controlling devices.
+#include <sys/signalfd.h>       // Declares functions for accepting signals via a file descriptor.
+#include <sys/stat.h>           // Declares functions for creating directories.
+#include <sys/syscall.h>        // Defines system call numbers.
 #include <sys/sysinfo.h>        // Defines functions for retrieving system information.
+#include <sys/uio.h>            // Declares functions for vector I/O.
 #include <sys/wait.h>           // Declares functions for holding processes.
 #include <time.h>               // Declares time and date functions.
 #include <unistd.h>             // Declares a number of implementation-specific functions.
 #include "overseer_functions.h" // Defines all of the macros and declares all of the functions used in controller.c.
+#include "protocol_functions.h" // Defines all of the macros and declares all of the functions of the wire protocol.
 
 /* Function Definitions */
 
@@ -23,9 +40,10 @@ int accept_conn(int sock_fd, struct sockaddr_in *controller_addr)
     int new_fd;                                         // Connection file descriptor.
     socklen_t addr_len = sizeof(struct sockaddr_in);    // Length of an internet address.
 
-    if ((new_fd = accept(sock_fd, (struct sockaddr *)controller_addr, &addr_len)) == ERROR)
+    /* Connections must not leak into executed files, as they may now outlive the fork of a request. */
+    if ((new_fd = accept4(sock_fd, (struct sockaddr *)controller_addr, &addr_len, SOCK_CLOEXEC)) == ERROR)
     {
-        if (errno == EAGAIN) // If no incoming connections.
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNABORTED) // If no incoming connections.
         {
             return new_fd;
         }
@@ -38,977 +56,5808 @@ int accept_conn(int sock_fd, struct sockaddr_in *controller_addr)
     return new_fd;
 }
 
-int split_args(char *buf, char *out_file, char *log_file, int *SIGTERM_timeout, int *show_mem_info, int *proc_id, int *kill_mem_percent, double *mem_percent, char **args)
+int split_args(char *buf, char **out_file, char **log_file, long int *SIGTERM_timeout, long int *mem_limit, int *priority, int *num_cpus, 
+               int *show_mem_info, int *proc_id, int *kill_mem_percent, double *mem_percent, char **args)
 {
-    char *token; // Token returned.
+    char *flag;             // Flag whose value is being read.
+    int found;              // Result of reading the current token.
+    int num_args = 0;       // Number of arguments.
+    char *pos = buf;        // Position in the buffer of the next token.
+    char *token;            // Current token, within the buffer.
 
-    token = strtok(buf, " ");
+    found = next_token(&pos, &token);
 
-    if (!strcmp(token, "-o"))
+    if (found == TRUE && (!strcmp(token, "mem") || !strcmp(token, "memkill")))
     {
-        token = strtok(NULL, " ");
-        strcpy(out_file, token);
+        flag = token;
 
-        token = strtok(NULL, " ");
-            
-        if (!strcmp(token, "-log"))
+        if (!strcmp(flag, "mem"))
         {
-            token = strtok(NULL, " ");
-            strcpy(log_file, token);
-
-            token = strtok(NULL, " ");
-
-            if (!strcmp(token, "-t"))
-            {
-                token = strtok(NULL, " ");
-                *SIGTERM_timeout = atoi(token);
-
-                token = strtok(NULL, " ");
-            }
+            *show_mem_info = TRUE;
+        }
+        else
+        {
+            *kill_mem_percent = TRUE;
         }
-    }
-    else if (!strcmp(token, "-log"))
-    {
-        token = strtok(NULL, " ");
-        strcpy(log_file, token); 
-
-        token = strtok(NULL, " ");
 
-        if (!strcmp(token, "-t"))
+        if ((found = next_token(&pos, &token)) == TRUE)
         {
-            token = strtok(NULL, " ");
-            *SIGTERM_timeout = atoi(token);
+            if (!strcmp(flag, "mem"))
+            {
+                *proc_id = atoi(token);
+            }
+            else
+            {
+                *mem_percent = atof(token);
+            }
 
-            token = strtok(NULL, " ");
+            found = next_token(&pos, &token);
         }
     }
-    else if (!strcmp(token, "-t"))
-    {
-        token = strtok(NULL, " ");
-        *SIGTERM_timeout = atoi(token);
 
-        token = strtok(NULL, " ");
-    }
-    else if (!strcmp(token, "mem"))
+    /* Flags may be given in any order before the file, and "--" ends them so that a file starting with a dash can be executed. */
+    while (found == TRUE && token[0] == '-')
     {
-        *show_mem_info = TRUE;
-
-        token = strtok(NULL, " ");
+        if (!strcmp(token, "--"))
+        {
+            found = next_token(&pos, &token);
+            break;
+        }
 
-        if (token != NULL)
+        if (strcmp(token, "-o") && strcmp(token, "-log") && strcmp(token, "-t") && strcmp(token, "-m") && strcmp(token, "-p") && 
+            strcmp(token, "-cpus"))
         {
-            *proc_id = atoi(token);
+            break;
         }
 
-        token = strtok(NULL, " ");
-    }
-    else if (!strcmp(token, "memkill"))
-    {
-        *kill_mem_percent = TRUE;
+        flag = token;
 
-        token = strtok(NULL, " ");
+        if ((found = next_token(&pos, &token)) != TRUE)
+        {
+            break;
+        }
 
-        if (token != NULL)
+        if (!strcmp(flag, "-o"))
+        {
+            *out_file = token;
+        }
+        else if (!strcmp(flag, "-log"))
+        {
+            *log_file = token;
+        }
+        else if (!strcmp(flag, "-t"))
+        {
+            *SIGTERM_timeout = atof(token) * MS_PER_SECOND;
+        }
+        else if (!strcmp(flag, "-m"))
+        {
+            *mem_limit = atol(token);
+        }
+        else if (!strcmp(flag, "-p"))
+        {
+            *priority = find_priority(token);
+        }
+        else
         {
-            *mem_percent = atof(token);
+            *num_cpus = atoi(token);
         }
 
-        token = strtok(NULL, " ");
+        found = next_token(&pos, &token);
     }
 
-    int num_args = 0; // Number of arguments.
-    while (token != NULL)
+    while (found == TRUE)
     {
-        args[num_args] = token;
-        token = strtok(NULL, " ");
-        num_args++;
+        args[num_args++] = token;
+        found = next_token(&pos, &token);
     }
 
-    return num_args;
+    args[num_args] = NULL;
+
+    return found == ERROR ? ERROR : num_args;
 }
 
-long int get_mem_used(pid_t c_pid)
+int recv_request(struct request *req, char *buf_recv, int *show_mem_info, pid_t *proc_id, int *kill_mem_percent, double *mem_percent, 
+                 int *submit_batch, int *watch, int *tail, int *watchdog)
 {
-    char *token;            // Token returned.
-    FILE *maps_fp;          // Maps file stream.
-    int inode;              // Inode value.
-    long int start_address; // Memory start address.
-    long int end_address;   // Memory end address.
-    long int mem_used = 0;  // Memory usage (bytes).
-
-    char *current_line = malloc(sizeof(char) * PATH_MAX);   // Current line being read in maps file.
-    char *maps_file = malloc(sizeof(char) * FILENAME_MAX);  // Maps file path.
+    int len;            // Length of the received command.
+    ssize_t num_bytes;  // Number of bytes received by the current call.
 
-    sprintf(maps_file, "/proc/%i/maps", c_pid);
-    maps_fp = fopen(maps_file, "r");
-
-    while (fgets(current_line, PATH_MAX, maps_fp) != NULL)
+    /* Legacy controllers send a NUL-terminated command padded to PATH_MAX bytes, which may arrive across several reads. All of it is read, 
+     * as closing the connection with the padding unread would reset it before the controller has read the reply. */
+    if (req->session == NULL)
     {
-        token = strtok(current_line, "-"); 
-        start_address = strtol(token, NULL, 16);
-
-        token = strtok(NULL, " ");         
-        end_address = strtol(token, NULL, 16);
-
-        for (int i = 0; i < 4; i++) 
-        { 
-            token = strtok(NULL, " "); 
+        for (len = 0; len < PATH_MAX; len += num_bytes)
+        {
+            if ((num_bytes = recv(req->new_fd, buf_recv + len, PATH_MAX - len, 0)) <= 0)
+            {
+                break;
+            }
         }
 
-        inode = atoi(token);
+        buf_recv[len < PATH_MAX ? len : PATH_MAX - 1] = '\0';
 
-        if (!inode)
-        {
-            mem_used += end_address - start_address;
-        }
+        return buf_recv[strspn(buf_recv, " ")] == '\0' ? ERROR : TRUE;
     }
 
-    fclose(maps_fp);
+    switch (req->type)
+    {
+        case MSG_EXEC:
+            memcpy(buf_recv, req->payload, req->len + 1);
 
-    free(current_line);
-    free(maps_file);
+            if (buf_recv[strspn(buf_recv, " ")] != '\0')
+            {
+                return TRUE;
+            }
 
-    return mem_used;
-}
+            send_reply(req, MSG_ERROR, "empty command", strlen("empty command"));
+            return ERROR;
 
-struct request *get_request()
-{
-    struct request *req; // Pointer to current request.
+        case MSG_MEM:
+            *show_mem_info = TRUE;
+            *proc_id = req->len == sizeof(int32_t) ? get_be32(req->payload) : 0;
+            return FALSE;
 
-    if (num_requests > 0)
-    {
-        req = requests;
-        requests = req->next;
+        case MSG_MEMKILL:
+            if (req->len == sizeof(int32_t))
+            {
+                *kill_mem_percent = TRUE;
+                *mem_percent = (double)get_be32(req->payload) / HUNDRED_PERCENT;
+                return FALSE;
+            }
 
-        if (requests == NULL)
-        {
-            last_request = NULL;
-        }
+            send_reply(req, MSG_ERROR, "malformed request", strlen("malformed request"));
+            return ERROR;
 
-        num_requests--;
-    }
-    else
-    {
-        req = NULL;
-    }
+        case MSG_SUBMIT:
+            memcpy(buf_recv, req->payload, req->len + 1);
+            *submit_batch = TRUE;
+            return FALSE;
 
-    return req;
-}
+        case MSG_WATCH:
+            if (req->len == sizeof(int32_t))
+            {
+                *watch = TRUE;
+                *proc_id = get_be32(req->payload);
+                return FALSE;
+            }
 
-void add_mem_entry(pid_t proc_id, char* timestamp, char **args, int mem_used)
-{
-    char *concat_args = malloc(sizeof(char) * PATH_MAX);                            // Concatenated string of file path and its arguments.
-    struct mem_entry *entry = (struct mem_entry *)malloc(sizeof(struct mem_entry)); // Pointer to a new memory report entry.
+            send_reply(req, MSG_ERROR, "malformed request", strlen("malformed request"));
+            return ERROR;
 
-    if (!entry) 
-    {
-        exit(EXIT_FAILURE);
-    }
+        case MSG_TAIL:
+            if (req->len == sizeof(int32_t))
+            {
+                *tail = TRUE;
+                *proc_id = get_be32(req->payload);
+                return FALSE;
+            }
 
-    entry->proc_id = proc_id;
-    entry->timestamp = strdup(timestamp);
+            send_reply(req, MSG_ERROR, "malformed request", strlen("malformed request"));
+            return ERROR;
 
-    strcpy(concat_args, args[0]);
+        case MSG_WATCHDOG:
+            if (req->len == 0 || req->len == sizeof(int32_t) || req->len == WATCHDOG_LEN)
+            {
+                *watchdog = TRUE;
+                return FALSE;
+            }
 
-    int i = 1;
-    while (args[i] != NULL)
-    {
-        strcat(concat_args, " ");
-        strcat(concat_args, args[i]);
-        i++;
+            send_reply(req, MSG_ERROR, "malformed request", strlen("malformed request"));
+            return ERROR;
     }
 
-    entry->args = strdup(concat_args);
+    send_reply(req, MSG_ERROR, "unknown message type", strlen("unknown message type"));
 
-    entry->mem_used = mem_used;
-    entry->next = NULL;
+    return ERROR;
+}
 
-    if (pthread_mutex_lock(&mem_mutex))
-    {
-        exit(EXIT_FAILURE);
-    }
+void init_reactor(struct reactor *reactor, int overseer_port, int *signal_fd)
+{
+    struct epoll_event event;   // Event to register.
+    struct request *req;        // Pointer to the current spare request record.
 
-    if (mem_report == NULL)
-    { 
-        mem_report = entry;
-        last_entry = entry;
-    }
-    else
-    {
-        last_entry->next = entry;
-        last_entry = entry;
-    }
+    listen_to(&reactor->sock_fd, overseer_port, reactor_pool.backlog);
 
-    if (pthread_mutex_unlock(&mem_mutex))
+    if (fcntl(reactor->sock_fd, F_SETFL, O_NONBLOCK) == ERROR || (reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR)
     {
         exit(EXIT_FAILURE);
     }
 
-    free(concat_args);
-}
-
-void add_request(struct sockaddr_in controller_addr, int new_fd)
-{
-    struct request *req = (struct request *)malloc(sizeof(struct request));
+    event.events = EPOLLIN;
+    event.data.ptr = &reactor->sock_fd;
 
-    if (!req) 
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor->sock_fd, &event))
     {
         exit(EXIT_FAILURE);
     }
 
-    req->controller_addr = controller_addr;
-    req->new_fd = new_fd;
-    req->next = NULL;
+    event.events = EPOLLIN;
+    event.data.ptr = &reactor_pool.quit_fd;
 
-    if (pthread_mutex_lock(&request_mutex))
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, reactor_pool.quit_fd, &event))
     {
         exit(EXIT_FAILURE);
     }
 
-    if (num_requests == 0)
-    { 
-        requests = req;
-        last_request = req;
-    }
-    else
+    if (signal_fd != NULL)
     {
-        last_request->next = req;
-        last_request = req;
-    }
+        event.events = EPOLLIN;
+        event.data.ptr = signal_fd;
 
-    num_requests++;
+        if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, *signal_fd, &event))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    if (pthread_mutex_unlock(&request_mutex) || pthread_cond_signal(&got_request))
+    for (int i = 0; i < REQUEST_POOL_LEN; i++)
     {
-        exit(EXIT_FAILURE);
+        req = alloc_request();
+        req->next = reactor->spare_requests;
+        reactor->spare_requests = req;
     }
 }
 
-void clean_up_unhandled_reqs()
+int init_signal_fd()
 {
-    struct request* req; // Pointer to current request.
+    int signal_fd;  // Signal file descriptor.
+    sigset_t mask;  // Set of signals to be received via the file descriptor.
 
-    while (requests != NULL)
+    /* SIGCHLD is blocked as well, so that the supervisor can fall back to receiving it via its own signal file descriptor. */
+    if (sigemptyset(&mask) || sigaddset(&mask, SIGCHLD) || pthread_sigmask(SIG_BLOCK, &mask, NULL) || sigemptyset(&mask) || 
+        sigaddset(&mask, SIGINT) || pthread_sigmask(SIG_BLOCK, &mask, NULL))
     {
-       req = requests;
-       requests = requests->next;
-
-       close(req->new_fd);
-       
-       free(req);
+        exit(EXIT_FAILURE);
     }
-}
 
-void delete_mem_entries(pid_t proc_id)
-{
-    struct mem_entry *entry;    // Pointer to entry in memory report.
-    struct mem_entry *prev;     // Pointer to previous entry in memory report.
-
-    if (pthread_mutex_lock(&mem_mutex))
+    if ((signal_fd = signalfd(ERROR, &mask, SFD_CLOEXEC | SFD_NONBLOCK)) == ERROR)
     {
         exit(EXIT_FAILURE);
     }
 
-    /* Starting at first entry, until we reach an entry that doesn't match the process ID, delete all entries. */
-    entry = mem_report;
-    while (entry != NULL && entry->proc_id == proc_id) 
-    {
-        mem_report = entry->next;
+    return signal_fd;
+}
 
-        free(entry->timestamp);
-        free(entry->args);
-        free(entry);
+int open_mem_fd(struct child *child)
+{
+    char proc_file[FILENAME_MAX]; // Path of the file read by the memory sampler.
 
-        entry = mem_report;
-    }
- 
-    /* Until we reach the last entry, delete all entries that match the process ID. */
-    while (entry != NULL) 
+    if (strcmp(child->cgroup, ""))
     {
-        while (entry != NULL && entry->proc_id != proc_id) 
-        {
-            prev = entry;
-            entry = entry->next;
-        }
- 
-        if (entry == NULL)
-        {
-            break;
-        }
-            
-        prev->next = entry->next;
-
-        if (prev->next == NULL)
-        {
-            last_entry = prev;
-
-            free(entry->timestamp);
-            free(entry->args);
-            free(entry);
-            break;
-        }
-        else
-        {
-            free(entry->timestamp);
-            free(entry->args);
-            free(entry);
- 
-            entry = prev->next;
-        }
+        snprintf(proc_file, FILENAME_MAX, child->mem_sampler->proc_file, child->cgroup);
     }
-
-    if (pthread_mutex_unlock(&mem_mutex))
+    else
     {
-        exit(EXIT_FAILURE);
+        snprintf(proc_file, FILENAME_MAX, child->mem_sampler->proc_file, child->c_pid);
     }
-}
 
-void exec_request(struct sockaddr_in controller_addr, int new_fd)
-{   
-    double mem_percent;             // Memory percentage threshold.
-    int kill_mem_percent = FALSE;   // Indicator of if processes above a certain percentage memory usage should be killed.
-    int num_args;                   // Number of arguments.
-    int show_mem_info = FALSE;      // Indicator of if memory information is to be sent back to the controller.
-    int SIGTERM_timeout = 10;       // Time before SIGTERM is sent to child.
-    pid_t proc_id = 0;              // The ID of the process for memory information to be sent back.
+    return open(proc_file, O_RDONLY | O_CLOEXEC);
+}
 
-    char **args = calloc(PATH_MAX, sizeof(char));                       // Array of strings to hold executable file path and its arguments.
-    char *buf_recv = calloc(PATH_MAX, sizeof(char));                    // Buffer of received arguments.
-    char *controller_ip = strdup(inet_ntoa(controller_addr.sin_addr));  // Controller's IP address.
-    char *current_time = malloc(sizeof(char) * TIME_STR_LEN);           // Current time string.
-    char *log_file = calloc(FILENAME_MAX, sizeof(char));                // File path of logging redirection file.
-    char *out_file = calloc(FILENAME_MAX, sizeof(char));                // File path of child output redirection file.
+long int get_mem_used(struct child *child)
+{
+    long int mem_used; // Memory usage (bytes).
 
-    if (!args || !buf_recv || !controller_ip || !current_time || recv(new_fd, buf_recv, PATH_MAX, 0) == ERROR)
+    if (child->mem_fd == ERROR || (mem_used = child->mem_sampler->sample(child->mem_fd)) == ERROR)
     {
-        exit(EXIT_FAILURE);
+        return 0;
     }
 
-    num_args = split_args(buf_recv, out_file, log_file, &SIGTERM_timeout, &show_mem_info, &proc_id, &kill_mem_percent, &mem_percent, args);
+    return mem_used;
+}
 
-    get_time(current_time);
-    fprintf(stdout, "%s - connection received from %s\n", current_time, controller_ip);
+long int read_latest_sample(struct child *child)
+{
+    long int mem_used;      // Memory usage of the latest sample.
+    unsigned long int seq;  // Sequence count of the history before it was read.
 
-    if (show_mem_info)
+    do
     {
-        char *proc_args[NUM_THREADS];       // File and arguments of currently running processes.
-        long int mem_used[NUM_THREADS];     // Memory usage of currently running processes.
-        pid_t proc_ids[NUM_THREADS] = {0};  // Process IDs of currently running processes.
+        while ((seq = __atomic_load_n(&child->seq, __ATOMIC_ACQUIRE)) & 1);
 
-        if (proc_id)
-        {
-            send_mem_info_id(proc_id, new_fd);
-        }
-        else
-        {
-            get_mem_info_all(proc_ids, mem_used, proc_args);
-            send_mem_info_all(proc_ids, mem_used, proc_args, new_fd); 
-        }
+        mem_used = child->num_samples ? child->history[(child->num_samples - 1) % MEM_HISTORY_LEN].mem_used : ERROR;
 
-        if (close(new_fd))
-        {
-            exit(EXIT_FAILURE);
-        }
-    }
-    else if (kill_mem_percent)
-    {
-        char *proc_args[NUM_THREADS];       // File and arguments of currently running processes.
-        long int mem_used[NUM_THREADS];     // Memory usage of currently running processes.
-        pid_t proc_ids[NUM_THREADS] = {0};  // Process IDs of currently running processes.
-        
-        if (close(new_fd))
-        {
-            exit(EXIT_FAILURE);
-        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&child->seq, __ATOMIC_RELAXED) != seq);
 
-        get_mem_info_all(proc_ids, mem_used, proc_args);
+    return mem_used;
+}
 
-        kill_all_percent(proc_ids, mem_used, mem_percent);
-    }
-    else
+long int sample_maps(int mem_fd)
+{
+    char buf[MAPS_BUF_LEN];     // Buffer of the maps file.
+    char *end;                  // End of the data in buf.
+    char *line;                 // Current line being parsed.
+    char *newline;              // End of the current line.
+    char *token;                // Current field of the current line.
+    int skip_line = FALSE;      // Indicator that the remainder of an overlong line is to be skipped.
+    long int start_address;     // Memory start address.
+    long int end_address;       // Memory end address.
+    long int mem_used = 0;      // Memory usage (bytes).
+    off_t offset = 0;           // Offset of the next read.
+    size_t len = 0;             // Length of the data in buf.
+    ssize_t num_bytes;          // Number of bytes read.
+
+    while ((num_bytes = pread(mem_fd, buf + len, MAPS_BUF_LEN - len - 1, offset)) > 0)
     {
-        FILE *log_fp;                   // Logging redirection file stream.
-        int pipe_fd[NUM_ENDS_PIPE];     // Pipe file descriptor.
-        int use_log_file = FALSE;       // Indicator of if redirection file should be used.
-        pid_t c_pid;                    // Process ID of child.
-
-        char *message = calloc(PATH_MAX, sizeof(char)); // Message to log
-
-        if (!log_file || !message || !out_file)
-        {
-            exit(EXIT_FAILURE);
-        }
-        
-        if (close(new_fd))
-        {
-            exit(EXIT_FAILURE);
-        }
-
-        if (strcmp(log_file, ""))
-        {
-            use_log_file = TRUE;
-
-            if ((log_fp = fopen(log_file, "a")) == NULL)
-            {
-                exit(EXIT_FAILURE);
-            }
-        }
-
-        get_time(current_time);
-        sprintf(message, "%s - attempting to execute", current_time);
-        log_message(use_log_file, log_fp, message);
-        log_args(num_args, use_log_file, log_fp, args);
-        sprintf(message, "\n");
-        log_message(use_log_file, log_fp, message);
-
-        if (pipe(pipe_fd) || (c_pid = fork()) == ERROR)
-        {
-            exit(EXIT_FAILURE);
-        }
+        offset += num_bytes;
+        len += num_bytes;
+        end = buf + len;
+        *end = '\0';
 
-        /* Child Process */
-        if (!c_pid)
+        line = buf;
+        while (line < end)
         {
-            int out_fd;         // Child output redirection file descriptor.
-            int stderr_old_fd;  // Copy of stdout.
-            int stdout_old_fd;  // Copy of stderr.
+            newline = memchr(line, '\n', end - line);
 
-            if (close(pipe_fd[PIPE_READ]) || fcntl(pipe_fd[PIPE_WRITE], F_SETFD, FD_CLOEXEC) == ERROR)
+            /* Keep an incomplete line for the next read, unless it already fills the buffer. */
+            if (newline == NULL && (line > buf || len < MAPS_BUF_LEN - 1))
             {
-                exit(EXIT_FAILURE);
+                break;
             }
 
-            if (strcmp(out_file, ""))
+            if (!skip_line)
             {
-                redir_stream(&out_fd, out_file, &stdout_old_fd, &stderr_old_fd);
+                /* Each line is "start-end perms offset dev inode [path]"; only anonymous mappings (inode 0) are counted. */
+                start_address = strtol(line, &token, 16);
+                end_address = strtol(token + 1, &token, 16);
 
-                if (fcntl(out_fd, F_SETFD, FD_CLOEXEC) == ERROR)
-                {
-                    exit(EXIT_FAILURE);
-                }
-            }
-                
-            if(execv(args[FILE_ARG_INDEX], args) == ERROR) 
-            {
-                if (strcmp(out_file, ""))
+                for (int i = 0; i < 3; i++)
                 {
-                    restore_stream(stdout_old_fd, stderr_old_fd);
+                    while (*token == ' ')
+                    {
+                        token++;
+                    }
 
-                    if (close(out_fd))
+                    while (*token != ' ' && *token != '\0')
                     {
-                        exit(EXIT_FAILURE);
+                        token++;
                     }
                 }
 
-                if (write(pipe_fd[PIPE_WRITE], "Failed", strlen("Failed") + 1) == ERROR)
+                if (!strtol(token, NULL, 10))
                 {
-                    exit(EXIT_FAILURE);
+                    mem_used += end_address - start_address;
                 }
             }
-        }
-        /* Parent Process */
-        else 
-        {
-            char err_buf[strlen("Error") + 1];  // Buffer of pipe.
-            int child_exec_failed;              // Indicator that execution of child failed.
-
-            if (close(pipe_fd[PIPE_WRITE]) || (child_exec_failed = read(pipe_fd[PIPE_READ], err_buf, strlen("Failed") + 1)) == ERROR || 
-                close(pipe_fd[PIPE_READ]))
-            {
-                exit(EXIT_FAILURE);
-            }
-
-            if (child_exec_failed)
-            {
-                get_time(current_time);
-                sprintf(message, "%s - could not execute", current_time);
-                log_message(use_log_file, log_fp, message);
-                log_args(num_args, use_log_file, log_fp, args);
-                sprintf(message, "\n");
-                log_message(use_log_file, log_fp, message);
-            }
-            else
-            {
-                get_time(current_time);
-                sprintf(message, "%s -", current_time);
-                log_message(use_log_file, log_fp, message);
-                log_args(num_args, use_log_file, log_fp, args);
-                sprintf(message, " has been executed with pid %i\n", c_pid);
-                log_message(use_log_file, log_fp, message);
-
-                manage_child(c_pid, SIGTERM_timeout, current_time, args, message, use_log_file, log_fp);
-            }
 
-            if (use_log_file)
-            {
-                if (fclose(log_fp))
-                {
-                    exit(EXIT_FAILURE);
-                }
-            }
+            skip_line = (newline == NULL);
+            line = (newline == NULL) ? end : newline + 1;
         }
-        free(message);
+
+        len = end - line;
+        memmove(buf, line, len);
     }
 
-    free(args);
-    free(buf_recv);
-    free(controller_ip);
-    free(current_time);
-    free(log_file);
-    free(out_file);
+    return num_bytes == ERROR ? ERROR : mem_used;
 }
 
-void get_mem_info_all(pid_t *proc_ids, long int *mem_used, char **proc_args)
+long int sample_smaps_rollup(int mem_fd)
 {
-    int in_array;               // Indicator of if process ID is already in array.
-    struct mem_entry* entry;    // Pointer to entry in memory report.
+    char buf[SMAPS_ROLLUP_BUF_LEN]; // Buffer of the smaps_rollup file.
+    char *field;                    // Resident set size field.
+    ssize_t num_bytes;              // Number of bytes read.
 
-    if (pthread_mutex_lock(&mem_mutex))
+    if ((num_bytes = pread(mem_fd, buf, SMAPS_ROLLUP_BUF_LEN - 1, 0)) <= 0)
     {
-        exit(EXIT_FAILURE);
+        return ERROR;
     }
 
-    entry = mem_report;
-    while (entry != NULL) 
+    buf[num_bytes] = '\0';
+
+    if ((field = strstr(buf, "\nRss:")) == NULL)
     {
-        in_array = FALSE;
+        return ERROR;
+    }
 
-        /* Check if process ID is in array. */
-        for (int i = 0; i < NUM_THREADS; i++)
-        {
-            if (entry->proc_id == proc_ids[i])
-            {
-                in_array = TRUE;
-                break;
-            }
-        }
+    return strtol(field + strlen("\nRss:"), NULL, 10) * BYTES_PER_KB;
+}
 
-        /* If not, add to array. */
-        if (!in_array)
-        {
-            for (int i = 0; i < NUM_THREADS; i++)
-            {
-                if (!proc_ids[i])
-                {
-                    proc_ids[i] = entry->proc_id;
-                    break;
-                }
-            }
-        }
+long int sample_statm(int mem_fd)
+{
+    char buf[STATM_BUF_LEN];    // Buffer of the statm file.
+    char *field;                // Resident pages field.
+    ssize_t num_bytes;          // Number of bytes read.
 
-        /* Update memory used and add file and arguments if they aren't already present. */
-        for (int i = 0; i < NUM_THREADS; i++)
-        {
-            if (proc_ids[i] == entry->proc_id)
-            {
-                mem_used[i] = entry->mem_used;
+    if ((num_bytes = pread(mem_fd, buf, STATM_BUF_LEN - 1, 0)) <= 0)
+    {
+        return ERROR;
+    }
 
-                if (proc_args[i] == NULL)
-                {
-                    proc_args[i] = entry->args;
-                }
-            }
-        }
+    buf[num_bytes] = '\0';
 
-        entry = entry->next;
-    }
+    /* The file is "size resident shared text lib data dt", in pages. */
+    strtol(buf, &field, 10);
 
-    if (pthread_mutex_unlock(&mem_mutex))
-    {
-        exit(EXIT_FAILURE);
-    }
+    return strtol(field, NULL, 10) * sysconf(_SC_PAGESIZE);
 }
 
-void get_time(char *current_time_fmt)
+long int sample_memory_current(int mem_fd)
 {
-    struct tm current_time; // Current system time.
-    time_t raw_time;        // Raw system time.
+    char buf[CGROUP_BUF_LEN];   // Buffer of the memory.current file.
+    ssize_t num_bytes;          // Number of bytes read.
 
-    if ((raw_time = time(NULL)) == ERROR)
+    if ((num_bytes = pread(mem_fd, buf, CGROUP_BUF_LEN - 1, 0)) <= 0)
     {
-        exit(EXIT_FAILURE);
+        return ERROR;
     }
 
-    current_time = *localtime(&raw_time);
+    buf[num_bytes] = '\0';
 
-    sprintf(current_time_fmt, "%d-%02d-%02d %02d:%02d:%02d", current_time.tm_year + 1900, current_time.tm_mon + 1, current_time.tm_mday, 
-            current_time.tm_hour, current_time.tm_min, current_time.tm_sec);
+    return strtol(buf, NULL, 10);
 }
 
-void handle_SIGINT()
+int init_cgroup_tree(char *root)
 {
-    if (pthread_mutex_lock(&quit_mutex))
+    cgroup_tree.root = root;
+
+    if (write_cgroup_file(root, "cgroup.subtree_control", "+memory") == ERROR)
     {
-        exit(EXIT_FAILURE);
+        return ERROR;
     }
 
-    quit = TRUE;
-
-    if (pthread_mutex_unlock(&quit_mutex))
+    if ((cgroup_tree.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR)
     {
         exit(EXIT_FAILURE);
     }
+
+    return 0;
 }
 
-void init_SIGINT_handling()
+int write_cgroup_file(char *cgroup, char *file, char *value)
 {
-    struct sigaction SIGINT_action; // Action to take for SIGINT.
+    char path[FILENAME_MAX];    // Path of the interface file.
+    int fd;                     // File descriptor of the interface file.
+    int result = 0;             // Result of writing the value.
 
-    SIGINT_action.sa_handler = handle_SIGINT;
+    snprintf(path, FILENAME_MAX, "%s/%s", cgroup, file);
 
-    if (sigemptyset(&SIGINT_action.sa_mask))
+    if ((fd = open(path, O_WRONLY | O_CLOEXEC)) == ERROR)
     {
-        exit(EXIT_FAILURE);
+        return ERROR;
     }
 
-    SIGINT_action.sa_flags = 0;
-
-    if (sigaction(SIGINT, &SIGINT_action, NULL))
+    /* The kernel applies a write to an interface file as a whole, so a short write means it was rejected. */
+    if (write(fd, value, strlen(value)) != (ssize_t)strlen(value))
+    {
+        result = ERROR;
+    }
+
+    if (close(fd))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return result;
+}
+
+int place_child(pid_t c_pid, long int mem_limit, char *cgroup)
+{
+    char value[CGROUP_BUF_LEN]; // Value written to an interface file.
+    int placed;                 // Indicator of if the child has been placed in the cgroup.
+
+    snprintf(cgroup, FILENAME_MAX, "%s/%i", cgroup_tree.root, c_pid);
+
+    /* A cgroup left behind by an earlier process with the same pid is reused. */
+    if (mkdir(cgroup, S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) && errno != EEXIST)
+    {
+        return ERROR;
+    }
+
+    placed = TRUE;
+
+    if (mem_limit > 0)
+    {
+        snprintf(value, CGROUP_BUF_LEN, "%ld", mem_limit);
+        placed = write_cgroup_file(cgroup, "memory.max", value) != ERROR;
+
+        /* Reclaim is forced on the child before the limit is reached, so it is throttled rather than killed where possible. */
+        snprintf(value, CGROUP_BUF_LEN, "%ld", mem_limit / 100 * MEM_HIGH_PERCENT);
+        placed = placed && write_cgroup_file(cgroup, "memory.high", value) != ERROR;
+    }
+
+    snprintf(value, CGROUP_BUF_LEN, "%i", c_pid);
+
+    if (!placed || write_cgroup_file(cgroup, "cgroup.procs", value) == ERROR)
+    {
+        /* The cgroup is empty, as the child never entered it, so removing it only fails if another process did. */
+        rmdir(cgroup);
+        return ERROR;
+    }
+
+    return 0;
+}
+
+int open_out_file(char *out_file, off_t *out_len)
+{
+    int out_fd; // Output file descriptor.
+
+    if ((out_fd = open(out_file, O_CLOEXEC | O_CREAT | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO)) == ERROR)
+    {
+        return ERROR;
+    }
+
+    if ((*out_len = lseek(out_fd, 0, SEEK_END)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return out_fd;
+}
+
+int open_pidfd(pid_t c_pid)
+{
+    return syscall(SYS_pidfd_open, c_pid, 0);
+}
+
+pid_t launch_child(char **args, char *out_file, char *log_file, long int SIGTERM_timeout, long int mem_limit, int priority, cpu_set_t *cpus, 
+                   char **error)
+{
+    int pidfd;                              // File descriptor referring to the child.
+    int placed;                             // Indicator of if the calling thread has been placed for the child, or ERROR if it cannot be.
+    char cgroup[FILENAME_MAX] = "";         // Path of the child's cgroup, or empty if jobs are not placed in cgroups.
+    cpu_set_t saved;                        // Affinity of the calling thread, restored once the child has been spawned.
+    pid_t c_pid = ERROR;                    // Process ID of child.
+    struct log_file *log_fp = NULL;         // Logging redirection file, or NULL for stdout.
+    char joined_args[PATH_MAX];             // File and arguments of child, concatenated.
+
+    join_args(args, joined_args);
+
+    if (strcmp(log_file, ""))
+    {
+        log_fp = open_log_file(log_file);
+    }
+
+    log_message(log_fp, "attempting to execute %s", joined_args);
+
+    if ((placed = place_thread(cpus, &saved)) != ERROR)
+    {
+        c_pid = spawn_child(args, out_file, &pidfd);
+
+        if (placed)
+        {
+            restore_thread(&saved);
+        }
+    }
+
+    if (placed == ERROR)
+    {
+        log_message(log_fp, "could not place %s on its cores", joined_args);
+        *error = cpus == NULL ? "every core is dedicated to other jobs" : "could not bind memory to the nodes of the dedicated cores";
+    }
+    else if (c_pid == ERROR)
+    {
+        log_message(log_fp, "could not execute %s", joined_args);
+        *error = "could not execute";
+    }
+    else if (cgroup_tree.root != NULL && place_child(c_pid, mem_limit, cgroup) == ERROR)
+    {
+        log_message(log_fp, "could not place %s with pid %i in a cgroup, killing it", joined_args, c_pid);
+        *error = "could not place in a cgroup";
+
+        /* The child has not been handed to the supervisor, so it is reaped here; a captured child's pipe then hangs up as usual. */
+        if (kill(c_pid, SIGKILL) || waitpid(c_pid, NULL, 0) == ERROR || (pidfd != ERROR && close(pidfd)))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        c_pid = ERROR;
+    }
+    else
+    {
+        log_message(log_fp, "%s has been executed with pid %i", joined_args, c_pid);
+
+        /* Ownership of the pidfd, the cgroup, the cores and the reference to the log file passes to the supervisor. */
+        add_child(c_pid, pidfd, cgroup, cpus, SIGTERM_timeout, priority, joined_args, log_fp);
+
+        return c_pid;
+    }
+
+    close_log_file(log_fp);
+
+    if (cpus != NULL)
+    {
+        release_cpus(cpus);
+    }
+
+    return ERROR;
+}
+
+pid_t spawn_child(char **args, char *out_file, int *pidfd)
+{
+    int capture_fds[2] = {ERROR, ERROR};        // Pipe capturing the child's output, if its output is captured.
+    int out_fd = ERROR;                         // Output file descriptor, if the child's output is captured.
+    int result;                                 // Error number returned by posix_spawn().
+    off_t out_len;                              // Length of the output file, if the child's output is captured.
+    pid_t c_pid;                                // Process ID of child.
+    posix_spawn_file_actions_t file_actions;    // Redirections performed by the child before execution.
+    posix_spawnattr_t attr;                     // Attributes of the child.
+    sigset_t empty_mask;                        // Signal mask to be restored before execution.
+
+    /* A captured child's output file is opened here, so failing to open it still counts as failing to execute the file. */
+    if (capture_list.enabled && strcmp(out_file, ""))
+    {
+        if ((out_fd = open_out_file(out_file, &out_len)) == ERROR)
+        {
+            return ERROR;
+        }
+
+        if (pipe2(capture_fds, O_CLOEXEC))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (posix_spawn_file_actions_init(&file_actions) || posix_spawnattr_init(&attr) || sigemptyset(&empty_mask) || 
+        posix_spawnattr_setsigmask(&attr, &empty_mask) || posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The output file, or the capture pipe, is placed onto stdout and stderr of the child, leaving the overseer's own streams untouched. */
+    if (out_fd != ERROR)
+    {
+        if (posix_spawn_file_actions_adddup2(&file_actions, capture_fds[1], STDOUT_FILENO) || 
+            posix_spawn_file_actions_adddup2(&file_actions, capture_fds[1], STDERR_FILENO))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (strcmp(out_file, "") && 
+             (posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, out_file, O_APPEND | O_CREAT | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO) || 
+              posix_spawn_file_actions_adddup2(&file_actions, STDOUT_FILENO, STDERR_FILENO)))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    result = posix_spawn(&c_pid, args[FILE_ARG_INDEX], &file_actions, &attr, args, environ);
+
+    if (posix_spawn_file_actions_destroy(&file_actions) || posix_spawnattr_destroy(&attr))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Only the child may hold the write end, so that the pipe hangs up once the child and its descendants have exited. */
+    if (out_fd != ERROR && close(capture_fds[1]))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (result)
+    {
+        if (out_fd != ERROR && (close(capture_fds[0]) || close(out_fd)))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        return ERROR;
+    }
+
+    /* The capture is registered before the pid is reported, so a controller can tail the child as soon as it learns of it. */
+    if (out_fd != ERROR)
+    {
+        add_capture(c_pid, capture_fds[0], out_fd, out_len, out_file);
+    }
+
+    /* The child cannot be reaped until the supervisor adopts it, so its process ID cannot yet have been reused. */
+    *pidfd = open_pidfd(c_pid);
+
+    return c_pid;
+}
+
+int place_thread(cpu_set_t *cpus, cpu_set_t *saved)
+{
+    unsigned long int nodemask = 0; // Memory nodes of the dedicated cores.
+    cpu_set_t shared;               // Cores not dedicated to any job.
+
+    if (cpus == NULL)
+    {
+        if (pthread_mutex_lock(&placement.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        CPU_XOR(&shared, &placement.allowed, &placement.used);
+
+        if (pthread_mutex_unlock(&placement.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (CPU_COUNT(&shared) == placement.num_cpus)
+        {
+            return FALSE;
+        }
+
+        /* With every core dedicated, a job without dedicated cores could only run on another job's. */
+        if (CPU_COUNT(&shared) == 0)
+        {
+            return ERROR;
+        }
+    }
+
+    if (sched_getaffinity(0, sizeof(cpu_set_t), saved) || sched_setaffinity(0, sizeof(cpu_set_t), cpus != NULL ? cpus : &shared))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A job sharing cores may run on any node, so only the memory of a job with dedicated cores is bound. */
+    if (cpus != NULL && placement.num_nodes > 1)
+    {
+        for (int i = 0; i < CPU_SETSIZE; i++)
+        {
+            if (CPU_ISSET(i, cpus))
+            {
+                nodemask |= 1UL << placement.nodes[i];
+            }
+        }
+
+        /* Binding needs CAP_SYS_NICE in some containers; a job whose memory would not follow its cores is not launched at all. */
+        if (syscall(SYS_set_mempolicy, MPOL_BIND, &nodemask, MAX_NODES + 1))
+        {
+            restore_thread(saved);
+            return ERROR;
+        }
+    }
+
+    return TRUE;
+}
+
+void restore_thread(cpu_set_t *saved)
+{
+    if (sched_setaffinity(0, sizeof(cpu_set_t), saved))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* This only fails where binding failed too, which left the thread's memory policy unchanged. */
+    if (placement.num_nodes > 1)
+    {
+        syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0);
+    }
+}
+
+int reserve_cpus(int num_cpus, cpu_set_t *cpus)
+{
+    int free_cpus[MAX_NODES] = {};  // Number of free cores of each node.
+    int node = ERROR;               // Node the cores are taken from, or ERROR if they are taken from any.
+    int num_free = 0;               // Number of free cores.
+
+    CPU_ZERO(cpus);
+
+    if (pthread_mutex_lock(&placement.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < CPU_SETSIZE; i++)
+    {
+        if (CPU_ISSET(i, &placement.allowed) && !CPU_ISSET(i, &placement.used))
+        {
+            free_cpus[placement.nodes[i]]++;
+            num_free++;
+        }
+    }
+
+    for (int i = 0; i < placement.num_nodes; i++)
+    {
+        if (free_cpus[i] >= num_cpus && (node == ERROR || free_cpus[i] < free_cpus[node]))
+        {
+            node = i;
+        }
+    }
+
+    for (int i = 0; i < CPU_SETSIZE && num_free >= num_cpus && CPU_COUNT(cpus) < num_cpus; i++)
+    {
+        if (CPU_ISSET(i, &placement.allowed) && !CPU_ISSET(i, &placement.used) && (node == ERROR || placement.nodes[i] == node))
+        {
+            CPU_SET(i, cpus);
+            CPU_SET(i, &placement.used);
+        }
+    }
+
+    if (pthread_mutex_unlock(&placement.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return num_free < num_cpus ? ERROR : 0;
+}
+
+void release_cpus(cpu_set_t *cpus)
+{
+    if (pthread_mutex_lock(&placement.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    CPU_XOR(&placement.used, &placement.used, cpus);
+
+    if (pthread_mutex_unlock(&placement.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+int reap_child(struct child *child)
+{
+    int status;                         // Status of the process.
+    pid_t state_changed;                // Indicator that state of process has changed.
+
+    if ((state_changed = waitpid(child->c_pid, &status, WNOHANG)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* If the process is still running. */
+    if (!state_changed)
+    {
+        return FALSE;
+    }
+
+    /* A process killed by a signal has no exit status, so the signal is reported instead. */
+    if (WIFSIGNALED(status))
+    {
+        log_message(child->log_fp, "%i has been killed by signal %i", child->c_pid, WTERMSIG(status));
+
+        publish_event(EVENT_KILLED, child->c_pid, WTERMSIG(status));
+    }
+    else
+    {
+        log_message(child->log_fp, "%i has terminated with status code %i", child->c_pid, WEXITSTATUS(status));
+
+        publish_event(EVENT_EXITED, child->c_pid, WEXITSTATUS(status));
+    }
+
+    return TRUE;
+}
+
+long int hash_pid(pid_t c_pid)
+{
+    /* Multiplicative hashing keeps the high bits, which depend on every bit of the process ID, so consecutive IDs spread across the table. */
+    return ((unsigned long int)c_pid * FIBONACCI_HASH) >> (sizeof(unsigned long int) * CHAR_BIT - __builtin_ctzl(proc_table.capacity));
+}
+
+long int get_next_expiry(struct timer_wheel *wheel)
+{
+    int index;                      // Index of the first slot to be searched at a level.
+    int shift;                      // Number of bits of the time represented by the levels below.
+    long int first_slot;            // Number (since time zero) of the first slot to be searched at a level.
+    long int expiry;                // Time at which the slot is next processed.
+    long int next_expiry = ERROR;   // Earliest time at which any slot is next processed.
+    uint64_t occupied;              // Occupied slots, rotated so that the first slot to be searched is the least significant bit.
+
+    if (!wheel->num_timers)
+    {
+        return ERROR;
+    }
+
+    for (int level = 0; level < WHEEL_LEVELS; level++)
+    {
+        if (!wheel->occupied[level])
+        {
+            continue;
+        }
+
+        shift = level * WHEEL_BITS;
+        first_slot = wheel->now >> shift;
+
+        /* Above the first level, the current slot has already been cascaded unless the next slot to be processed lies on its boundary. */
+        if (level && (wheel->now & ((1L << shift) - 1)))
+        {
+            first_slot++;
+        }
+
+        index = first_slot & WHEEL_MASK;
+        occupied = (wheel->occupied[level] >> index) | (index ? wheel->occupied[level] << (WHEEL_SLOTS - index) : 0);
+        expiry = (first_slot + __builtin_ctzll(occupied)) << shift;
+
+        if (next_expiry == ERROR || expiry < next_expiry)
+        {
+            next_expiry = expiry;
+        }
+    }
+
+    return next_expiry;
+}
+
+void add_timer(struct timer_wheel *wheel, struct timer *timer, long int expires)
+{
+    int level = 0;                                  // Level of the slot the timer is placed in.
+    long int delta;                                 // Time in milliseconds until the timer expires.
+
+    timer->expires = expires;
+
+    /* Timers which have already expired are placed in the current slot. */
+    if ((delta = expires - wheel->now) < 0)
+    {
+        expires = wheel->now;
+        delta = 0;
+    }
+
+    while (level < WHEEL_LEVELS - 1 && delta >= 1L << (WHEEL_BITS * (level + 1)))
+    {
+        level++;
+    }
+
+    timer->level = level;
+    timer->slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    timer->prev = NULL;
+    timer->next = wheel->slots[level][timer->slot];
+
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer;
+    }
+
+    wheel->slots[level][timer->slot] = timer;
+    wheel->occupied[level] |= 1ULL << timer->slot;
+    wheel->num_timers++;
+    timer->pending = TRUE;
+}
+
+void advance_timers(struct timer_wheel *wheel, long int now)
+{
+    int index;              // Index of the current slot at the first level.
+    long int next_expiry;   // Time at which a slot is next processed.
+    struct timer *timer;    // Pointer to current timer.
+
+    while (wheel->now <= now)
+    {
+        /* At each boundary, move the timers of the next slot of the level above down to lower levels. */
+        for (int level = 1; level < WHEEL_LEVELS && !(wheel->now & ((1L << (WHEEL_BITS * level)) - 1)); level++)
+        {
+            cascade_timers(wheel, level);
+        }
+
+        /* Run every timer in the current slot, including those added to it by the callbacks. */
+        index = wheel->now & WHEEL_MASK;
+        while ((timer = wheel->slots[0][index]) != NULL)
+        {
+            cancel_timer(wheel, timer);
+            timer->expire(wheel, timer);
+        }
+
+        /* Skip straight to the next slot which has to be processed. */
+        if ((next_expiry = get_next_expiry(wheel)) == ERROR || next_expiry > now)
+        {
+            wheel->now = now + 1;
+        }
+        else if (next_expiry > wheel->now)
+        {
+            wheel->now = next_expiry;
+        }
+        else
+        {
+            wheel->now++;
+        }
+    }
+}
+
+void cancel_timer(struct timer_wheel *wheel, struct timer *timer)
+{
+    if (!timer->pending)
+    {
+        return;
+    }
+
+    if (timer->prev == NULL)
+    {
+        wheel->slots[timer->level][timer->slot] = timer->next;
+    }
+    else
+    {
+        timer->prev->next = timer->next;
+    }
+
+    if (timer->next != NULL)
+    {
+        timer->next->prev = timer->prev;
+    }
+
+    if (wheel->slots[timer->level][timer->slot] == NULL)
+    {
+        wheel->occupied[timer->level] &= ~(1ULL << timer->slot);
+    }
+
+    wheel->num_timers--;
+    timer->pending = FALSE;
+}
+
+void cascade_timers(struct timer_wheel *wheel, int level)
+{
+    int index = (wheel->now >> (WHEEL_BITS * level)) & WHEEL_MASK;  // Index of the slot to cascade.
+    struct timer *timer;                                            // Pointer to current timer.
+
+    while ((timer = wheel->slots[level][index]) != NULL)
+    {
+        cancel_timer(wheel, timer);
+        add_timer(wheel, timer, timer->expires);
+    }
+}
+
+void init_timer(struct timer *timer, void (*expire)(struct timer_wheel *, struct timer *), void *data)
+{
+    timer->pending = FALSE;
+    timer->expire = expire;
+    timer->data = data;
+}
+
+void init_timer_wheel(struct timer_wheel *wheel, long int now)
+{
+    memset(wheel, 0, sizeof(struct timer_wheel));
+    wheel->now = now;
+}
+
+struct session *open_session(struct reactor *reactor, int new_fd)
+{
+    struct epoll_event event;                                                   // Event to register.
+    struct session *session = (struct session *)calloc(1, sizeof(struct session)); // Pointer to a new session.
+
+    if (!session || (session->buf = malloc(SESSION_BUF_LEN)) == NULL || pthread_mutex_init(&session->mutex, NULL) || 
+        pthread_mutex_init(&session->send_mutex, NULL) || pthread_cond_init(&session->sent, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    session->fd = new_fd;
+    session->epoll_fd = reactor->epoll_fd;
+    session->reactor = reactor;
+    session->framed = ERROR;
+    session->reading = TRUE;
+    session->refs = 1;
+
+    event.events = EPOLLIN;
+    event.data.ptr = session;
+
+    if (epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD, new_fd, &event))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    session->prev = NULL;
+    session->next = reactor->sessions;
+
+    if (reactor->sessions != NULL)
+    {
+        reactor->sessions->prev = session;
+    }
+
+    reactor->sessions = session;
+
+    return session;
+}
+
+struct log_file *open_log_file(char *path)
+{
+    struct log_file *log_fp;    // Pointer to the current logging redirection file.
+
+    if (pthread_mutex_lock(&log_queue.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    log_fp = log_queue.files;
+    while (log_fp != NULL && strcmp(log_fp->path, path))
+    {
+        log_fp = log_fp->next;
+    }
+
+    if (log_fp != NULL)
+    {
+        log_fp->refs++;
+    }
+    else
+    {
+        if ((log_fp = log_queue.spare_files) != NULL)
+        {
+            log_queue.spare_files = log_fp->next;
+        }
+
+        if ((log_fp == NULL && (log_fp = malloc(sizeof(struct log_file))) == NULL) || 
+            (log_fp->fd = open(path, O_APPEND | O_CLOEXEC | O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH)) == ERROR)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        snprintf(log_fp->path, PATH_MAX, "%s", path);
+
+        log_fp->refs = 1;
+        log_fp->next = log_queue.files;
+        log_queue.files = log_fp;
+    }
+
+    if (pthread_mutex_unlock(&log_queue.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return log_fp;
+}
+
+void add_block(struct arena *arena, size_t len)
+{
+    struct arena_block *block = (struct arena_block *)malloc(sizeof(struct arena_block) + len); // Pointer to the new block.
+
+    if (!block)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    block->next = arena->blocks;
+    block->len = len;
+    arena->blocks = block;
+    arena->used = 0;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+    size_t len;     // Number of bytes of data of a new block.
+    void *ptr;      // Pointer to the allocation.
+
+    size = ARENA_ROUND(size);
+
+    if (arena->blocks == NULL || arena->used + size > arena->blocks->len)
+    {
+        len = arena->blocks == NULL ? ARENA_BLOCK_LEN : arena->blocks->len * 2;
+        add_block(arena, len > size ? len : size);
+    }
+
+    ptr = (char *)(arena->blocks + 1) + arena->used;
+    arena->used += size;
+    arena->total += size;
+
+    return ptr;
+}
+
+char *arena_strdup(struct arena *arena, char *str)
+{
+    return strcpy(arena_alloc(arena, strlen(str) + 1), str);
+}
+
+void free_arena(struct arena *arena)
+{
+    struct arena_block *block; // Pointer to the block being freed.
+
+    while ((block = arena->blocks) != NULL)
+    {
+        arena->blocks = block->next;
+        free(block);
+    }
+
+    free_frames(&arena->frames);
+}
+
+void init_arena(struct arena *arena, size_t len)
+{
+    memset(arena, 0, sizeof(struct arena));
+    add_block(arena, ARENA_ROUND(len));
+}
+
+void reset_arena(struct arena *arena)
+{
+    struct arena_block *block;      // Pointer to the block being freed.
+    size_t total = arena->total;    // Number of bytes allocated since the last reset.
+
+    if (arena->blocks != NULL && arena->blocks->next != NULL)
+    {
+        while ((block = arena->blocks) != NULL)
+        {
+            arena->blocks = block->next;
+            free(block);
+        }
+
+        add_block(arena, total);
+    }
+
+    arena->used = 0;
+    arena->total = 0;
+    arena->frames.len = 0;
+}
+
+char *join_args(char **args, char *joined_args)
+{
+    size_t len = 0; // Length of the joined string.
+
+    joined_args[0] = '\0';
+
+    for (int i = FILE_ARG_INDEX; args[i] != NULL && len < PATH_MAX - 1; i++)
+    {
+        len += snprintf(joined_args + len, PATH_MAX - len, i == FILE_ARG_INDEX ? "%s" : " %s", args[i]);
+    }
+
+    return joined_args;
+}
+
+size_t move_output(struct capture *capture)
+{
+    int avail;                  // Number of bytes waiting in the child's pipe.
+    char discard[PIPE_BUF];     // Buffer output which cannot be written is read into and discarded.
+    size_t len;                 // Number of bytes to be moved into the output file by the current call.
+    size_t moved = 0;           // Number of bytes moved into the output file.
+    ssize_t num_bytes;          // Number of bytes moved by the current call.
+
+    if (ioctl(capture->pipe_fd, FIONREAD, &avail) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!avail)
+    {
+        return 0;
+    }
+
+    /* tee() duplicates the output without consuming it, so every tailer receives exactly the bytes which go on to the output file. */
+    for (struct tailer *tailer = capture->tailers; tailer != NULL; tailer = tailer->next)
+    {
+        if ((num_bytes = tee(capture->pipe_fd, tailer->pipe_fds[1], avail, SPLICE_F_NONBLOCK)) == ERROR)
+        {
+            if (errno != EAGAIN)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            num_bytes = 0;
+        }
+
+        tailer->len += num_bytes;
+        tailer->num_dropped += avail - num_bytes;
+
+        send_output(tailer);
+    }
+
+    prune_tailers(&capture->tailers);
+
+    while (moved < (size_t)avail)
+    {
+        if (capture_list.rotate_len && capture->out_len >= capture_list.rotate_len)
+        {
+            rotate_out_file(capture);
+        }
+
+        len = avail - moved;
+
+        if (capture_list.rotate_len && len > capture_list.rotate_len - capture->out_len)
+        {
+            len = capture_list.rotate_len - capture->out_len;
+        }
+
+        if ((num_bytes = splice(capture->pipe_fd, NULL, capture->out_fd, &capture->out_len, len, SPLICE_F_MOVE)) == ERROR)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            /* Output which cannot be written, such as to a full disk, is discarded, as the child's own writes would have failed. */
+            if ((num_bytes = read(capture->pipe_fd, discard, len < PIPE_BUF ? len : PIPE_BUF)) == ERROR)
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        moved += num_bytes;
+    }
+
+    return moved;
+}
+
+struct request *get_request(struct worker *worker)
+{
+    struct request *req;    // Pointer to the request taken.
+
+    if ((req = pop_request(worker)) != NULL)
+    {
+        return req;
+    }
+
+    for (int i = 1; i < worker_pool.num_workers && __atomic_load_n(&worker_pool.num_queued, __ATOMIC_RELAXED) > 0; i++)
+    {
+        if ((req = pop_request(&worker_pool.workers[(worker->index + i) % worker_pool.num_workers])) != NULL)
+        {
+            return req;
+        }
+    }
+
+    return NULL;
+}
+
+struct request *pop_request(struct worker *worker)
+{
+    struct request *req;    // Pointer to the request taken.
+
+    if (pthread_mutex_lock(&worker->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if ((req = worker->requests) != NULL)
+    {
+        if ((worker->requests = req->next) == NULL)
+        {
+            worker->last_request = NULL;
+        }
+    }
+
+    if (pthread_mutex_unlock(&worker->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (req != NULL)
+    {
+        __atomic_sub_fetch(&worker_pool.num_queued, 1, __ATOMIC_SEQ_CST);
+    }
+
+    return req;
+}
+
+struct child *find_child(pid_t c_pid)
+{
+    long int slot; // Index of current slot.
+
+    if (!proc_table.capacity)
+    {
+        return NULL;
+    }
+
+    for (slot = hash_pid(c_pid); proc_table.slots[slot].c_pid != EMPTY_SLOT; slot = (slot + 1) & (proc_table.capacity - 1))
+    {
+        if (proc_table.slots[slot].c_pid == c_pid)
+        {
+            return proc_table.slots[slot].child;
+        }
+    }
+
+    return NULL;
+}
+
+struct mem_sampler *find_mem_sampler(char *name)
+{
+    for (int i = 0; i < NUM_MEM_SAMPLERS; i++)
+    {
+        if (!strcmp(mem_samplers[i].name, name))
+        {
+            return &mem_samplers[i];
+        }
+    }
+
+    return NULL;
+}
+
+void add_mem_samples(int num_children)
+{
+    time_t raw_time;            // Raw system time of the batch.
+    struct child *child;        // Pointer to current child.
+    struct mem_sample *sample;  // Pointer to the slot of the child's history which receives the sample.
+
+    if ((raw_time = time(NULL)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The sampler thread is the only writer of the histories, so each write need only be bracketed by its child's sequence count. */
+    for (int i = 0; i < num_children; i++)
+    {
+        child = sample_batch.children[i];
+        __atomic_store_n(&child->seq, child->seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        sample = &child->history[child->num_samples % MEM_HISTORY_LEN];
+        sample->time = raw_time;
+        sample->mem_used = sample_batch.mem_used[i];
+        child->num_samples++;
+
+        __atomic_store_n(&child->seq, child->seq + 1, __ATOMIC_RELEASE);
+    }
+
+    publish_samples(raw_time, num_children);
+    check_watchdog(num_children);
+}
+
+void check_watchdog(int num_children)
+{
+    double percent;                 // Memory percentage threshold applying to the current child.
+    long int grace;                 // Grace period applying to the current child.
+    struct child *child;            // Pointer to current child.
+    struct child *tripped = NULL;   // Children which have stayed above their threshold for their grace period.
+    struct sysinfo info;            // System information.
+
+    long int now = get_time_ms();   // Monotonic time in milliseconds of the batch.
+
+    if (sysinfo(&info) || pthread_mutex_lock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < num_children; i++)
+    {
+        child = sample_batch.children[i];
+        percent = child->watchdog_percent ? child->watchdog_percent : watchdog.percent;
+        grace = child->watchdog_percent ? child->watchdog_grace : watchdog.grace;
+
+        if (!percent || sample_batch.mem_used[i] < (percent / HUNDRED_PERCENT) * info.totalram * info.mem_unit)
+        {
+            child->over_since = 0;
+            continue;
+        }
+
+        if (!child->over_since)
+        {
+            child->over_since = now;
+        }
+
+        if (now - child->over_since >= grace && !child->tripped)
+        {
+            child->tripped = TRUE;
+            child->next_tripped = tripped;
+            tripped = child;
+        }
+    }
+
+    if (pthread_mutex_unlock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (tripped == NULL)
+    {
+        return;
+    }
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A child the supervisor has already removed can no longer be signalled, and would never be taken off the list. */
+    for (child = tripped; child != NULL; child = tripped)
+    {
+        tripped = child->next_tripped;
+
+        if (find_child(child->c_pid) == child)
+        {
+            child->refs++;
+            child->next_tripped = tripped_children;
+            tripped_children = child;
+        }
+    }
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    wake_supervisor();
+}
+
+void count_action(struct child *child, char *signal)
+{
+    log_message(child->log_fp, "watchdog: %i stayed above its memory threshold, sent %s", child->c_pid, signal);
+
+    if (pthread_mutex_lock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    watchdog.num_actions++;
+    child->num_actions++;
+
+    if (pthread_mutex_unlock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void enforce_watchdog(struct timer_wheel *wheel, struct child *tripped, int shutting_down)
+{
+    struct child *child;    // Pointer to current child.
+
+    for (child = tripped; child != NULL; child = tripped)
+    {
+        tripped = child->next_tripped;
+
+        /* Only the supervisor removes children from the table, so one found there has not been reaped. */
+        if (!shutting_down && !child->SIGTERM_sent && find_child(child->c_pid) == child)
+        {
+            cancel_timer(wheel, &child->SIGTERM_timer);
+            add_timer(wheel, &child->SIGTERM_timer, get_time_ms());
+        }
+
+        release_child(child);
+    }
+}
+
+void send_policies(struct request *req)
+{
+    char payload[POLICY_LEN];                           // Payload of the current policy.
+    struct child *child;                                // Pointer to current child.
+    struct frame_buf *frames = &req->arena->frames;     // Buffer of encoded frames.
+
+    if (pthread_mutex_lock(&child_mutex) || pthread_mutex_lock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    put_be32(payload, 0);
+    put_be32(payload + sizeof(int32_t), watchdog.percent * HUNDRED_PERCENT + 0.5);
+    put_be64(payload + 2 * sizeof(int32_t), watchdog.grace);
+    put_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t), watchdog.num_actions);
+    add_frame(frames, MSG_POLICY, req->id, payload, POLICY_LEN);
+
+    for (child = children; child != NULL; child = child->next)
+    {
+        if (child->watchdog_percent)
+        {
+            put_be32(payload, child->c_pid);
+            put_be32(payload + sizeof(int32_t), child->watchdog_percent * HUNDRED_PERCENT + 0.5);
+            put_be64(payload + 2 * sizeof(int32_t), child->watchdog_grace);
+            put_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t), child->num_actions);
+            add_frame(frames, MSG_POLICY, req->id, payload, POLICY_LEN);
+        }
+    }
+
+    if (pthread_mutex_unlock(&watchdog.mutex) || pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    add_frame(frames, MSG_END, req->id, NULL, 0);
+    send_replies(req->session, frames);
+}
+
+void set_policy(struct request *req)
+{
+    struct child *child = NULL;                     // Child whose policy is set, or NULL for the global policy.
+
+    pid_t c_pid = get_be32(req->payload);           // Process ID of the child whose policy is set, or 0 for the global policy.
+    double percent = 0;                             // Memory percentage threshold, or 0 to remove the policy.
+    long int grace = 0;                             // Grace period in milliseconds.
+
+    if (req->len == WATCHDOG_LEN)
+    {
+        percent = (double)get_be32(req->payload + sizeof(int32_t)) / HUNDRED_PERCENT;
+        grace = get_be64(req->payload + 2 * sizeof(int32_t));
+    }
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (c_pid && (child = find_child(c_pid)) == NULL)
+    {
+        if (pthread_mutex_unlock(&child_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        send_reply(req, MSG_ERROR, "no such process", strlen("no such process"));
+        return;
+    }
+
+    if (pthread_mutex_lock(&watchdog.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (child == NULL)
+    {
+        watchdog.percent = percent;
+        watchdog.grace = grace;
+    }
+    else
+    {
+        child->watchdog_percent = percent;
+        child->watchdog_grace = grace;
+    }
+
+    if (pthread_mutex_unlock(&watchdog.mutex) || pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    send_reply(req, MSG_END, NULL, 0);
+}
+
+void add_child(pid_t c_pid, int pidfd, char *cgroup, cpu_set_t *cpus, long int SIGTERM_timeout, int priority, char *args, 
+               struct log_file *log_fp)
+{
+    char events_file[FILENAME_MAX];         // Path of the memory.events file of the child's cgroup.
+
+    struct child *child = new_child();      // Pointer to a new child record.
+
+    child->c_pid = c_pid;
+    child->pidfd = pidfd;
+    strcpy(child->cgroup, cgroup);
+
+    if (cpus != NULL)
+    {
+        child->cpus = *cpus;
+    }
+    else
+    {
+        CPU_ZERO(&child->cpus);
+    }
+
+    child->mem_sampler = strcmp(cgroup, "") ? &cgroup_sampler : mem_sampler;
+    child->mem_fd = open_mem_fd(child);
+    child->events_fd = ERROR;
+    child->num_high = 0;
+    child->num_oom_kills = 0;
+    child->watchdog_percent = 0;
+    child->watchdog_grace = 0;
+    child->num_actions = 0;
+    child->over_since = 0;
+    child->tripped = FALSE;
+
+    if (strcmp(cgroup, ""))
+    {
+        snprintf(events_file, FILENAME_MAX, "%s/memory.events", cgroup);
+        child->events_fd = open(events_file, O_RDONLY | O_CLOEXEC);
+    }
+
+    child->SIGTERM_timeout = SIGTERM_timeout;
+    child->priority = priority;
+    child->start_time = get_time_ms();
+    child->SIGTERM_sent = FALSE;
+    child->SIGKILL_sent = FALSE;
+    child->refs = 1;
+    child->seq = 0;
+    child->num_samples = 0;
+
+    /* The file and arguments are stored once per child, rather than with every sample. */
+    strcpy(child->args, args);
+    child->log_fp = log_fp;
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    child->next = pending_children;
+    pending_children = child;
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    wake_supervisor();
+    publish_event(EVENT_STARTED, c_pid, 0);
+}
+
+struct child *new_child()
+{
+    struct child *child; // Pointer to the record.
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if ((child = spare_children) != NULL)
+    {
+        spare_children = child->next;
+    }
+
+    if (pthread_mutex_unlock(&child_mutex) || (child == NULL && (child = (struct child *)malloc(sizeof(struct child))) == NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return child;
+}
+
+void add_capture(pid_t c_pid, int pipe_fd, int out_fd, off_t out_len, char *out_file)
+{
+    struct capture *capture;    // Pointer to a new capture.
+    struct epoll_event event;   // Event to register.
+
+    /* The pipe is registered with the mutex held, so the capture thread cannot see its output before the capture is in the list. */
+    if (pthread_mutex_lock(&capture_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if ((capture = capture_list.spare) != NULL)
+    {
+        capture_list.spare = capture->next;
+    }
+    else if ((capture = (struct capture *)malloc(sizeof(struct capture))) == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(capture->out_file, PATH_MAX, "%s", out_file);
+    capture->c_pid = c_pid;
+    capture->pipe_fd = pipe_fd;
+    capture->out_fd = out_fd;
+    capture->out_len = out_len;
+    capture->tailers = NULL;
+
+    event.events = EPOLLIN;
+    event.data.ptr = capture;
+
+    capture->next = capture_list.captures;
+    capture_list.captures = capture;
+
+    if (epoll_ctl(capture_list.epoll_fd, EPOLL_CTL_ADD, pipe_fd, &event) || pthread_mutex_unlock(&capture_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void add_request(struct reactor *reactor, int new_fd, struct session *session, struct frame_header *header, char *payload)
+{
+    struct request *req = new_request(reactor);                             // Pointer to the request.
+    struct worker *worker = &worker_pool.workers[reactor->next_worker];     // Worker the request is queued on.
+
+    reactor->next_worker = (reactor->next_worker + 1) % worker_pool.num_workers;
+
+    req->new_fd = new_fd;
+    req->session = session;
+    req->next = NULL;
+
+    /* The payload is copied out of the session's buffer, which the reactor reuses, into the record's own buffer. */
+    if (session != NULL)
+    {
+        req->id = header->id;
+        req->type = header->type;
+        req->len = header->length;
+
+        if (req->cap < header->length + 1)
+        {
+            if ((req->payload = realloc(req->payload, header->length + 1)) == NULL)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            req->cap = header->length + 1;
+        }
+
+        memcpy(req->payload, payload, header->length);
+        req->payload[header->length] = '\0';
+    }
+
+    if (pthread_mutex_lock(&worker->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (worker->last_request == NULL)
+    { 
+        worker->requests = req;
+    }
+    else
+    {
+        worker->last_request->next = req;
+    }
+
+    worker->last_request = req;
+
+    if (pthread_mutex_unlock(&worker->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Only a single idle worker is woken, rather than every worker contending for the request. */
+    __atomic_add_fetch(&worker_pool.num_queued, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&worker_pool.num_idle, __ATOMIC_SEQ_CST) > 0)
+    {
+        wake_worker();
+    }
+}
+
+struct request *new_request(struct reactor *reactor)
+{
+    struct request *req; // Pointer to the record.
+
+    /* The finished records are taken all at once, so reactors taking them concurrently never see a record twice. */
+    if (reactor->spare_requests == NULL)
+    {
+        reactor->spare_requests = __atomic_exchange_n(&worker_pool.free_requests, NULL, __ATOMIC_ACQUIRE);
+    }
+
+    if ((req = reactor->spare_requests) != NULL)
+    {
+        reactor->spare_requests = req->next;
+    }
+    else
+    {
+        req = alloc_request();
+    }
+
+    return req;
+}
+
+struct request *alloc_request()
+{
+    struct request *req = (struct request *)malloc(sizeof(struct request)); // Pointer to the record.
+
+    if (!req || (req->payload = malloc(REQUEST_PAYLOAD_LEN)) == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    req->cap = REQUEST_PAYLOAD_LEN;
+
+    return req;
+}
+
+void add_subscriber(struct request *req, pid_t c_pid)
+{
+    struct subscriber *subscriber = (struct subscriber *)calloc(1, sizeof(struct subscriber)); // Pointer to the new subscriber.
+
+    if (!subscriber || pthread_mutex_lock(&req->session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The subscriber keeps the session open after the subscribing request has been finished. */
+    req->session->refs++;
+
+    if (pthread_mutex_unlock(&req->session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    subscriber->session = req->session;
+    subscriber->id = req->id;
+    subscriber->c_pid = c_pid;
+
+    if (pthread_mutex_lock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    subscriber->next = watch_list.subscribers;
+    watch_list.subscribers = subscriber;
+
+    if (pthread_mutex_unlock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void add_tailer(struct request *req, pid_t c_pid)
+{
+    struct capture *capture;    // Pointer to the capture of the child.
+    struct tailer *tailer;      // Pointer to the new tailer.
+
+    if (pthread_mutex_lock(&capture_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A child's capture may outlive it while its descendants hold the pipe, so the most recent capture for a reused pid comes first. */
+    for (capture = capture_list.captures; capture != NULL && capture->c_pid != c_pid; capture = capture->next);
+
+    if (capture == NULL)
+    {
+        if (pthread_mutex_unlock(&capture_list.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        send_reply(req, MSG_ERROR, "output of process is not captured", strlen("output of process is not captured"));
+        return;
+    }
+
+    /* The socket is duplicated so that each tailer of a session can wait for room in it through an epoll registration of its own. */
+    if ((tailer = (struct tailer *)calloc(1, sizeof(struct tailer))) == NULL || pipe2(tailer->pipe_fds, O_CLOEXEC | O_NONBLOCK) || 
+        (tailer->sock_fd = fcntl(req->session->fd, F_DUPFD_CLOEXEC, 0)) == ERROR || pthread_mutex_lock(&req->session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The tailer keeps the session open after the tail request has been finished. */
+    req->session->refs++;
+
+    if (pthread_mutex_unlock(&req->session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A larger pipe lets the tailer fall further behind before its output is dropped; the default is kept if the system limit is lower. */
+    fcntl(tailer->pipe_fds[1], F_SETPIPE_SZ, TAIL_PIPE_LEN);
+
+    tailer->session = req->session;
+    tailer->id = req->id;
+    tailer->c_pid = c_pid;
+    tailer->next = capture->tailers;
+    capture->tailers = tailer;
+
+    if (pthread_mutex_unlock(&capture_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void clean_up_unhandled_reqs()
+{
+    struct request* req; // Pointer to current request.
+
+    for (int i = 0; i < worker_pool.num_workers; i++)
+    {
+        while ((req = worker_pool.workers[i].requests) != NULL)
+        {
+           worker_pool.workers[i].requests = req->next;
+
+           if (req->session == NULL)
+           {
+               close(req->new_fd);
+           }
+           
+           finish_request(req);
+        }
+
+        free_arena(&worker_pool.workers[i].arena);
+    }
+
+    free(worker_pool.workers);
+
+    /* Every record is now either spare or finished. */
+    for (int i = 0; i < reactor_pool.num_reactors; i++)
+    {
+        while ((req = reactor_pool.reactors[i].spare_requests) != NULL)
+        {
+            reactor_pool.reactors[i].spare_requests = req->next;
+
+            free(req->payload);
+            free(req);
+        }
+    }
+
+    free(reactor_pool.reactors);
+
+    while ((req = worker_pool.free_requests) != NULL)
+    {
+        worker_pool.free_requests = req->next;
+
+        free(req->payload);
+        free(req);
+    }
+}
+
+void finish_capture(struct capture *capture)
+{
+    struct capture **link;      // Pointer to the link to the current capture.
+    struct tailer *tailer;      // Pointer to the current tailer.
+
+    /* Tails end with MSG_END once the last of the output has been sent, however far behind the tailer has fallen. */
+    while ((tailer = capture->tailers) != NULL)
+    {
+        capture->tailers = tailer->next;
+        tailer->ending = TRUE;
+
+        if (send_output(tailer))
+        {
+            free_tailer(tailer);
+            continue;
+        }
+
+        tailer->next = capture_list.draining;
+        capture_list.draining = tailer;
+    }
+
+    for (link = &capture_list.captures; *link != capture; link = &(*link)->next);
+
+    *link = capture->next;
+
+    if (epoll_ctl(capture_list.epoll_fd, EPOLL_CTL_DEL, capture->pipe_fd, NULL) || close(capture->pipe_fd) || close(capture->out_fd))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    capture->next = capture_list.spare;
+    capture_list.spare = capture;
+}
+
+void free_tailer(struct tailer *tailer)
+{
+    struct session *session = tailer->session; // Session of the tailer.
+
+    /* Nothing else can follow a frame cut short, so the writers waiting for it are woken to find the session broken. */
+    if (tailer->frame_sent > 0 && (tailer->frame_sent < tailer->frame_len || tailer->output_left > 0))
+    {
+        if (pthread_mutex_lock(&session->send_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (session->sending == tailer)
+        {
+            session->broken = TRUE;
+            session->sending = NULL;
+
+            if (pthread_cond_broadcast(&session->sent))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (pthread_mutex_unlock(&session->send_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if ((tailer->waiting && epoll_ctl(capture_list.tail_epoll_fd, EPOLL_CTL_DEL, tailer->sock_fd, NULL)) || close(tailer->sock_fd) || 
+        close(tailer->pipe_fds[0]) || close(tailer->pipe_fds[1]))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    release_session(tailer->session);
+    free(tailer);
+}
+
+void close_session(struct session *session)
+{
+    if (pthread_mutex_lock(&session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Once reading has stopped, the workers must not re-arm the session's events. */
+    if (session->fd != ERROR && epoll_ctl(session->epoll_fd, EPOLL_CTL_DEL, session->fd, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    session->reading = FALSE;
+
+    if (pthread_mutex_unlock(&session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (session->prev == NULL)
+    {
+        session->reactor->sessions = session->next;
+    }
+    else
+    {
+        session->prev->next = session->next;
+    }
+
+    if (session->next != NULL)
+    {
+        session->next->prev = session->prev;
+    }
+
+    /* Any subscriptions and tails made on the session are dropped by the publisher and capture threads. */
+    wake_publisher(TRUE);
+    wake_capture(TRUE);
+
+    release_session(session);
+}
+
+void close_sessions(struct reactor *reactor)
+{
+    while (reactor->sessions != NULL)
+    {
+        close_session(reactor->sessions);
+    }
+}
+
+void expire_SIGKILL(struct timer_wheel *wheel, struct timer *timer)
+{
+    struct child *child = timer->data;  // Child to kill.
+
+    if (kill(child->c_pid, SIGKILL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    child->SIGKILL_sent = TRUE;
+
+    log_message(child->log_fp, "sent SIGKILL to %i", child->c_pid);
+
+    if (child->tripped)
+    {
+        count_action(child, "SIGKILL");
+    }
+}
+
+void expire_SIGTERM(struct timer_wheel *wheel, struct timer *timer)
+{
+    struct child *child = timer->data;  // Child to terminate.
+
+    if (kill(child->c_pid, SIGTERM))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Memory usage is no longer sampled once the child has been asked to terminate, so the flag is set under the mutex the sampler reads it 
+     * under. */
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    child->SIGTERM_sent = TRUE;
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    log_message(child->log_fp, "sent SIGTERM to %i", child->c_pid);
+
+    if (child->tripped)
+    {
+        count_action(child, "SIGTERM");
+    }
+
+    add_timer(wheel, &child->SIGKILL_timer, timer->expires + SIGKILL_TIMEOUT * MS_PER_SECOND);
+}
+
+void free_child(struct child *child)
+{
+    if ((child->pidfd != ERROR && close(child->pidfd)) || (child->mem_fd != ERROR && close(child->mem_fd)) || 
+        (child->events_fd != ERROR && close(child->events_fd)))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    close_log_file(child->log_fp);
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    child->next = spare_children;
+    spare_children = child;
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void delete_child(struct child *child)
+{
+    long int slot; // Index of current slot.
+
+    for (slot = hash_pid(child->c_pid); proc_table.slots[slot].child != child; slot = (slot + 1) & (proc_table.capacity - 1));
+
+    proc_table.slots[slot].c_pid = TOMBSTONE;
+    proc_table.slots[slot].child = NULL;
+    proc_table.num_children--;
+}
+
+void exec_request(struct request *req)
+{   
+    double mem_percent;             // Memory percentage threshold.
+    int kill_mem_percent = FALSE;   // Indicator of if processes above a certain percentage memory usage should be killed.
+    int show_mem_info = FALSE;      // Indicator of if memory information is to be sent back to the controller.
+    long int SIGTERM_timeout = DEFAULT_SIGTERM_TIMEOUT; // Time in milliseconds before SIGTERM is sent to child.
+    long int mem_limit = 0;         // Memory limit of the child's cgroup in bytes, or 0 for none.
+    int priority = PRIORITY_NORMAL; // Priority class of the child.
+    int num_cpus = 0;               // Number of cores to dedicate to the child.
+    pid_t proc_id = 0;              // The ID of the process for memory information to be sent back.
+    int submit_batch = FALSE;       // Indicator of if a batch of jobs is to be launched.
+    int tail = FALSE;               // Indicator of if the controller is tailing the output of a child.
+    int watchdog = FALSE;           // Indicator of if the request concerns the watchdog.
+    int watch = FALSE;              // Indicator of if the controller is subscribing to child events.
+
+    int is_command;                 // Indicator of if a command was received, or ERROR if the request was rejected.
+    int new_fd = req->new_fd;       // Connection file descriptor of a legacy controller.
+    int num_args = 0;               // Number of arguments of the command, or ERROR if a quote is not closed.
+    char *log_file = "";            // File path of logging redirection file, within the buffer of received arguments.
+    char *out_file = "";            // File path of child output redirection file, within the buffer of received arguments.
+    struct job job;                 // Launch handed to the admission controller and the scheduler, which copy it if they keep it.
+
+    /* The buffers live in the worker's arena, which is reset once the request has been executed. */
+    char **args = arena_alloc(req->arena, sizeof(char *) * PATH_MAX);  // Array of strings to hold executable file path and its arguments.
+    char *buf_recv = arena_alloc(req->arena, PATH_MAX);                 // Buffer of received arguments.
+
+    args[0] = NULL;
+
+    is_command = recv_request(req, buf_recv, &show_mem_info, &proc_id, &kill_mem_percent, &mem_percent, &submit_batch, &watch, &tail, 
+                              &watchdog);
+
+    /* The arguments are split in place, so they point into the buffer rather than being copied out of it. */
+    if (is_command == TRUE)
+    {
+        num_args = split_args(buf_recv, &out_file, &log_file, &SIGTERM_timeout, &mem_limit, &priority, &num_cpus, &show_mem_info, &proc_id, 
+                              &kill_mem_percent, &mem_percent, args);
+    }
+
+    /* A legacy controller's connection is closed once its request has been answered; a session outlives its requests. */
+    if (is_command == ERROR)
+    {
+        if (req->session == NULL && close(new_fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (show_mem_info)
+    {
+        int num_procs;                  // Number of currently running processes.
+        long int *mem_used;             // Memory usage of currently running processes.
+        struct child **proc_children;   // Currently running processes.
+
+        if (proc_id)
+        {
+            send_mem_info_id(proc_id, req);
+        }
+        else
+        {
+            num_procs = get_mem_info_all(req->arena, &proc_children, &mem_used);
+            send_mem_info_all(proc_children, mem_used, num_procs, req);
+
+            for (int i = 0; i < num_procs; i++)
+            {
+                release_child(proc_children[i]);
+            }
+        }
+
+        if (req->session == NULL && close(new_fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (kill_mem_percent)
+    {
+        int num_procs;                  // Number of currently running processes.
+        long int *mem_used;             // Memory usage of currently running processes.
+        struct child **proc_children;   // Currently running processes.
+        
+        if (req->session == NULL && close(new_fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        num_procs = get_mem_info_all(req->arena, &proc_children, &mem_used);
+
+        kill_all_percent(proc_children, mem_used, num_procs, mem_percent);
+
+        for (int i = 0; i < num_procs; i++)
+        {
+            release_child(proc_children[i]);
+        }
+
+        send_reply(req, MSG_END, NULL, 0);
+    }
+    else if (submit_batch)
+    {
+        init_job(&job, req, buf_recv, NULL, NULL, NULL, 0, 0, PRIORITY_NORMAL, 0);
+
+        if (!hold_job(&job))
+        {
+            launch_batch(buf_recv, req);
+        }
+    }
+    else if (watch)
+    {
+        add_subscriber(req, proc_id);
+    }
+    else if (tail)
+    {
+        add_tailer(req, proc_id);
+    }
+    else if (watchdog && req->len == 0)
+    {
+        send_policies(req);
+    }
+    else if (watchdog)
+    {
+        set_policy(req);
+    }
+    else
+    {
+        if (req->session == NULL && close(new_fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (num_args == ERROR)
+        {
+            send_reply(req, MSG_ERROR, "unterminated quote", strlen("unterminated quote"));
+        }
+        else if (num_args == 0)
+        {
+            send_reply(req, MSG_ERROR, "no file to execute", strlen("no file to execute"));
+        }
+        /* A memory limit is enforced by the job's cgroup, so it cannot be honoured unless jobs are placed in cgroups. */
+        else if (mem_limit && cgroup_tree.root == NULL)
+        {
+            send_reply(req, MSG_ERROR, "memory limits require cgroups", strlen("memory limits require cgroups"));
+        }
+        else if (priority == ERROR)
+        {
+            send_reply(req, MSG_ERROR, "unknown priority class", strlen("unknown priority class"));
+        }
+        else if (num_cpus < 0 || num_cpus > placement.num_cpus)
+        {
+            send_reply(req, MSG_ERROR, "not enough cores", strlen("not enough cores"));
+        }
+        else
+        {
+            init_job(&job, req, NULL, args, out_file, log_file, SIGTERM_timeout, mem_limit, priority, num_cpus);
+
+            if (!hold_job(&job))
+            {
+                start_job(&job);
+            }
+        }
+    }
+}
+
+int get_mem_info_all(struct arena *arena, struct child ***proc_children, long int **mem_used)
+{
+    int num_children = 0;   // Number of children referenced.
+    int num_procs = 0;      // Number of processes found.
+    struct child *child;    // Pointer to current child.
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The table holds every running process, so the arrays are never too small. */
+    *proc_children = arena_alloc(arena, sizeof(struct child *) * (proc_table.num_children + 1));
+    *mem_used = arena_alloc(arena, sizeof(long int) * (proc_table.num_children + 1));
+
+    for (child = children; child != NULL; child = child->next)
+    {
+        child->refs++;
+        (*proc_children)[num_children++] = child;
+    }
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The histories are read without holding a lock. Only processes which have been sampled at least once are reported. */
+    for (int i = 0; i < num_children; i++)
+    {
+        child = (*proc_children)[i];
+
+        if (((*mem_used)[num_procs] = read_latest_sample(child)) == ERROR)
+        {
+            release_child(child);
+        }
+        else
+        {
+            (*proc_children)[num_procs++] = child;
+        }
+    }
+
+    return num_procs;
+}
+
+long int get_time_ms()
+{
+    struct timespec now; // Current monotonic time.
+
+    if (clock_gettime(CLOCK_MONOTONIC, &now))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return now.tv_sec * MS_PER_SECOND + now.tv_nsec / NS_PER_MS;
+}
+
+void finish_request(struct request *req)
+{
+    struct epoll_event event;                   // Event to re-arm.
+    struct session *session = req->session;     // Session the request arrived on.
+
+    if (session != NULL)
+    {
+        if (pthread_mutex_lock(&session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        session->num_requests--;
+
+        /* Resume reading a paused session, unless the reactor has stopped reading it. */
+        if (session->paused && session->reading && session->num_requests < SESSION_MAX_REQUESTS)
+        {
+            event.events = EPOLLIN;
+            event.data.ptr = session;
+
+            if (epoll_ctl(session->epoll_fd, EPOLL_CTL_MOD, session->fd, &event))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            session->paused = FALSE;
+        }
+
+        if (pthread_mutex_unlock(&session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        release_session(session);
+    }
+
+    req->next = __atomic_load_n(&worker_pool.free_requests, __ATOMIC_RELAXED);
+
+    while (!__atomic_compare_exchange_n(&worker_pool.free_requests, &req->next, req, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+void format_time(time_t raw_time, char *time_fmt)
+{
+    struct tm current_time; // Broken-down time.
+
+    localtime_r(&raw_time, &current_time);
+
+    sprintf(time_fmt, "%d-%02d-%02d %02d:%02d:%02d", current_time.tm_year + 1900, current_time.tm_mon + 1, current_time.tm_mday, 
+            current_time.tm_hour, current_time.tm_min, current_time.tm_sec);
+}
+
+void handle_SIGINT(int signal_fd)
+{
+    struct signalfd_siginfo info; // Information about the received signal.
+
+    while (read(signal_fd, &info, sizeof(info)) == sizeof(info));
+
+    if (pthread_mutex_lock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    quit = TRUE;
+
+    if (pthread_mutex_unlock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void init_sampler(pthread_t *sampler_threads)
+{
+    pthread_condattr_t attr; // Attributes of the sampler's condition variable.
+
+    if (pthread_condattr_init(&attr) || pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) || pthread_cond_init(&sampler_cond, &attr) || 
+        pthread_condattr_destroy(&attr) || pthread_mutex_init(&sample_batch.mutex, NULL) || pthread_cond_init(&sample_batch.work, NULL) || 
+        pthread_cond_init(&sample_batch.done, NULL) || pthread_mutex_init(&watchdog.mutex, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (pthread_create(&sampler_threads[0], NULL, sample_children, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (long int i = 1; i < SAMPLER_THREADS; i++)
+    {
+        if (pthread_create(&sampler_threads[i], NULL, help_sample, (void *)i))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void init_supervisor(pthread_t *supervisor_thread)
+{
+    struct child *child; // Pointer to the current spare child record.
+
+    if (pthread_mutex_init(&child_mutex, NULL) || (supervisor_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < CHILD_POOL_LEN; i++)
+    {
+        if ((child = (struct child *)malloc(sizeof(struct child))) == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        child->next = spare_children;
+        spare_children = child;
+    }
+
+    if (pthread_create(supervisor_thread, NULL, supervise_children, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void init_reactors(int overseer_port, int *signal_fd)
+{
+    if ((reactor_pool.reactors = calloc(reactor_pool.num_reactors, sizeof(struct reactor))) == NULL || 
+        (reactor_pool.quit_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Every listening socket is open before any reactor accepts, so that the kernel shares out connections from the first. */
+    for (int i = 0; i < reactor_pool.num_reactors; i++)
+    {
+        init_reactor(&reactor_pool.reactors[i], overseer_port, i == 0 ? signal_fd : NULL);
+        reactor_pool.reactors[i].next_worker = i % worker_pool.num_workers;
+    }
+
+    for (int i = 1; i < reactor_pool.num_reactors; i++)
+    {
+        if (pthread_create(&reactor_pool.reactors[i].thread, NULL, accept_connections, &reactor_pool.reactors[i]))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void init_threads(void *(*handle_requests)(void *))
+{
+    if (pthread_mutex_init(&worker_pool.mutex, NULL) || pthread_mutex_init(&quit_mutex, NULL) || 
+        (worker_pool.workers = calloc(worker_pool.num_workers, sizeof(struct worker))) == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < worker_pool.num_workers; i++)
+    {
+        worker_pool.workers[i].index = i;
+
+        if (pthread_mutex_init(&worker_pool.workers[i].mutex, NULL) || pthread_cond_init(&worker_pool.workers[i].wake, NULL))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* Every worker is initialised before any starts, as a worker may steal from any other. */
+    for (int i = 0; i < worker_pool.num_workers; i++)
+    {
+        if (pthread_create(&worker_pool.workers[i].thread, NULL, handle_requests, &worker_pool.workers[i]))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void insert_child(struct child *child)
+{
+    long int slot; // Index of current slot.
+
+    if ((proc_table.num_used + 1) * 4 > proc_table.capacity * 3)
+    {
+        resize_proc_table();
+    }
+
+    for (slot = hash_pid(child->c_pid); proc_table.slots[slot].c_pid != EMPTY_SLOT && proc_table.slots[slot].c_pid != TOMBSTONE; 
+         slot = (slot + 1) & (proc_table.capacity - 1));
+
+    if (proc_table.slots[slot].c_pid == EMPTY_SLOT)
+    {
+        proc_table.num_used++;
+    }
+
+    proc_table.slots[slot].c_pid = child->c_pid;
+    proc_table.slots[slot].child = child;
+    proc_table.num_children++;
+}
+
+void kill_all_percent(struct child **proc_children, long int *mem_used, int num_procs, double mem_percent) 
+{
+    struct sysinfo info; // System information.
+
+    sysinfo(&info);
+
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (mem_used[i] >= (mem_percent/HUNDRED_PERCENT) * info.totalram)
+        {                    
+            kill(proc_children[i]->c_pid, SIGKILL);
+        }
+    }
+}
+
+int hold_job(struct job *job)
+{
+    long int num_held;  // Number of launches held, including this one.
+
+    if (!admission.enabled || pthread_mutex_lock(&admission.mutex))
+    {
+        return FALSE;
+    }
+
+    if (!admission.pressured && admission.held == NULL)
+    {
+        if (pthread_mutex_unlock(&admission.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        return FALSE;
+    }
+
+    job = keep_job(job);
+
+    if (admission.last_held == NULL)
+    {
+        admission.held = job;
+    }
+    else
+    {
+        admission.last_held->next = job;
+    }
+
+    admission.last_held = job;
+    num_held = ++admission.num_held;
+
+    if (pthread_mutex_unlock(&admission.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    log_message(NULL, "holding a launch until pressure drops, %ld held", num_held);
+
+    return TRUE;
+}
+
+void answer_job(struct job *job, pid_t c_pid, char *error)
+{
+    char payload[DISPATCHED_LEN];   // Payload of the reply.
+    struct request req = {};        // Request the job arrived in, through which it is answered.
+
+    req.new_fd = ERROR;
+    req.session = job->session;
+    req.id = job->id;
+
+    /* The batch of a queued job has already been answered, so the job is reported on its own, by its index within the batch. */
+    if (job->index != ERROR)
+    {
+        put_be32(payload, job->index);
+        put_be32(payload + sizeof(int32_t), error == NULL ? c_pid : 0);
+        put_be32(payload + 2 * sizeof(int32_t), error == NULL ? JOB_STARTED : JOB_FAILED);
+        send_reply(&req, MSG_DISPATCHED, payload, DISPATCHED_LEN);
+    }
+    else if (error == NULL)
+    {
+        put_be32(payload, c_pid);
+        send_reply(&req, MSG_STARTED, payload, sizeof(int32_t));
+    }
+    else
+    {
+        send_reply(&req, MSG_ERROR, error, strlen(error));
+    }
+}
+
+void init_job(struct job *job, struct request *req, char *buf, char **args, char *out_file, char *log_file, long int SIGTERM_timeout, 
+              long int mem_limit, int priority, int num_cpus)
+{
+    job->buf = buf;
+    job->args = args;
+    job->out_file = out_file;
+    job->log_file = log_file;
+    job->SIGTERM_timeout = SIGTERM_timeout;
+    job->mem_limit = mem_limit;
+    job->priority = priority;
+    job->num_cpus = num_cpus;
+    job->session = req != NULL ? req->session : NULL;
+    job->id = req != NULL ? req->id : 0;
+    job->index = ERROR;
+    job->arena.blocks = NULL;
+    job->next = NULL;
+}
+
+struct job *keep_job(struct job *job)
+{
+    int num_args = 0;                                   // Number of arguments of the job.
+    size_t len = ARENA_ROUND(sizeof(struct job));       // Number of bytes of the copy and its buffers.
+    struct arena arena;                                 // Arena holding the copy.
+    struct job *kept;                                   // Pointer to the copy.
+
+    if (job->buf != NULL)
+    {
+        len += ARENA_ROUND(strlen(job->buf) + 1);
+    }
+
+    if (job->args != NULL)
+    {
+        for (; job->args[num_args] != NULL; num_args++)
+        {
+            len += ARENA_ROUND(strlen(job->args[num_args]) + 1);
+        }
+
+        len += ARENA_ROUND(sizeof(char *) * (num_args + 1)) + ARENA_ROUND(strlen(job->out_file) + 1) + 
+               ARENA_ROUND(strlen(job->log_file) + 1);
+    }
+
+    /* The copy and its buffers fit in a single block, so that it is freed with a single call to free(). */
+    init_arena(&arena, len);
+    kept = arena_alloc(&arena, sizeof(struct job));
+    *kept = *job;
+
+    if (job->buf != NULL)
+    {
+        kept->buf = arena_strdup(&arena, job->buf);
+    }
+
+    if (job->args != NULL)
+    {
+        kept->args = arena_alloc(&arena, sizeof(char *) * (num_args + 1));
+
+        for (int i = 0; i < num_args; i++)
+        {
+            kept->args[i] = arena_strdup(&arena, job->args[i]);
+        }
+
+        kept->args[num_args] = NULL;
+        kept->out_file = arena_strdup(&arena, job->out_file);
+        kept->log_file = arena_strdup(&arena, job->log_file);
+    }
+
+    kept->arena = arena;
+    kept->next = NULL;
+
+    /* A held or queued job keeps the session open after the request has been finished. */
+    if (kept->session != NULL)
+    {
+        if (pthread_mutex_lock(&kept->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        kept->session->refs++;
+
+        if (pthread_mutex_unlock(&kept->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return kept;
+}
+
+void free_job(struct job *job)
+{
+    struct arena arena = job->arena; // Arena holding the job, which is copied out as freeing it frees the record.
+
+    if (job->session != NULL)
+    {
+        release_session(job->session);
+    }
+
+    free_arena(&arena);
+}
+
+pid_t launch_job(struct job *job)
+{
+    char *error;                    // Reason the job could not be launched.
+    int terminating;                // Indicator that the overseer is terminating.
+    pid_t c_pid;                    // Process ID of child.
+    cpu_set_t cpus;                 // Cores dedicated to the job, if it is pinned.
+
+    if (pthread_mutex_lock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    terminating = quit;
+
+    if (pthread_mutex_unlock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Jobs dispatched or released while the children are being killed would only be killed in turn, so they are rejected instead. */
+    if (terminating)
+    {
+        finish_job(job->priority);
+        answer_job(job, ERROR, "overseer is terminating");
+        return ERROR;
+    }
+
+    if (job->num_cpus && reserve_cpus(job->num_cpus, &cpus) == ERROR)
+    {
+        log_message(NULL, "could not dedicate %i cores to %s, too few are free", job->num_cpus, job->args[FILE_ARG_INDEX]);
+        finish_job(job->priority);
+        answer_job(job, ERROR, "not enough free cores");
+        return ERROR;
+    }
+
+    if ((c_pid = launch_child(job->args, job->out_file, job->log_file, job->SIGTERM_timeout, job->mem_limit, job->priority, 
+                              job->num_cpus ? &cpus : NULL, &error)) == ERROR)
+    {
+        finish_job(job->priority);
+        answer_job(job, ERROR, error);
+    }
+    else
+    {
+        answer_job(job, c_pid, NULL);
+    }
+
+    return c_pid;
+}
+
+void start_job(struct job *job)
+{
+    if (!schedule_job(job))
+    {
+        launch_job(job);
+    }
+}
+
+int find_priority(char *name)
+{
+    for (int i = 0; i < NUM_PRIORITIES; i++)
+    {
+        if (!strcmp(name, scheduler.names[i]))
+        {
+            return i;
+        }
+    }
+
+    return ERROR;
+}
+
+int has_slot(int priority)
+{
+    return (!scheduler.limits[priority] || scheduler.running[priority] < scheduler.limits[priority]) && 
+           (!scheduler.limits[NUM_PRIORITIES] || scheduler.running[NUM_PRIORITIES] < scheduler.limits[NUM_PRIORITIES]);
+}
+
+int schedule_job(struct job *job)
+{
+    int priority = job->priority;   // Priority class of the job.
+    long int num_queued;            // Number of queued jobs, including this one.
+
+    if (!scheduler.enabled)
+    {
+        return FALSE;
+    }
+
+    if (pthread_mutex_lock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A job only overtakes the queue of its own class if that is empty, so that jobs of a class start in the order they arrived. */
+    if (scheduler.queued[priority] == NULL && has_slot(priority))
+    {
+        scheduler.running[priority]++;
+        scheduler.running[NUM_PRIORITIES]++;
+
+        if (pthread_mutex_unlock(&scheduler.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        return FALSE;
+    }
+
+    job = keep_job(job);
+
+    if (scheduler.last_queued[priority] == NULL)
+    {
+        scheduler.queued[priority] = job;
+    }
+    else
+    {
+        scheduler.last_queued[priority]->next = job;
+    }
+
+    scheduler.last_queued[priority] = job;
+    num_queued = ++scheduler.num_queued;
+
+    if (pthread_mutex_unlock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    log_message(NULL, "queueing a %s priority launch until a slot is free, %ld queued", scheduler.names[priority], num_queued);
+
+    return TRUE;
+}
+
+void launch_batch(char *batch, struct request *req)
+{
+    int kill_mem_percent;       // Indicator of if the job is a memkill command.
+    double mem_percent;         // Unused memkill percentage.
+    int num_args;               // Number of arguments of the job.
+    int num_jobs = 0;           // Number of jobs in the batch.
+    pid_t proc_id;              // Unused mem pid.
+    int show_mem_info;          // Indicator of if the job is a mem command.
+    long int SIGTERM_timeout;   // Time in milliseconds before SIGTERM is sent to the job.
+    long int mem_limit;         // Memory limit of the job's cgroup in bytes, or 0 for none.
+    int priority;               // Priority class of the job.
+    int num_cpus;               // Number of cores to dedicate to the job.
+    pid_t c_pid;                // Process ID of the job.
+    char *end;                  // End of the current job.
+    int status;                 // Status of the current job.
+    char *log_file;             // File path of the job's logging redirection file, within the batch.
+    char *out_file;             // File path of the job's output redirection file, within the batch.
+    struct job line_job;        // Current job handed to the scheduler, which is answered in the batch's reply only.
+
+    char **args = arena_alloc(req->arena, sizeof(char *) * PATH_MAX);                   // Array of strings to hold the job's file and arguments.
+    char *statuses = arena_alloc(req->arena, JOB_STATUS_LEN * (strlen(batch) / 2 + 1)); // Pid and status of each job, as sent back.
+
+    /* Each line is a job in the same form as a single command; every job is answered, in order, in a single reply. */
+    for (char *job = batch; *job != '\0'; job = end)
+    {
+        if ((end = strchr(job, '\n')) != NULL)
+        {
+            *end++ = '\0';
+        }
+        else
+        {
+            end = job + strlen(job);
+        }
+
+        if (job[strspn(job, TOKEN_DELIMITERS)] == '\0')
+        {
+            continue;
+        }
+
+        kill_mem_percent = FALSE;
+        show_mem_info = FALSE;
+        SIGTERM_timeout = DEFAULT_SIGTERM_TIMEOUT;
+        mem_limit = 0;
+        priority = PRIORITY_NORMAL;
+        num_cpus = 0;
+        log_file = "";
+        out_file = "";
+
+        num_args = split_args(job, &out_file, &log_file, &SIGTERM_timeout, &mem_limit, &priority, &num_cpus, &show_mem_info, &proc_id, 
+                              &kill_mem_percent, &mem_percent, args);
+        c_pid = 0;
+
+        if (num_args <= 0 || show_mem_info || kill_mem_percent || (mem_limit && cgroup_tree.root == NULL) || priority == ERROR || 
+            num_cpus < 0 || num_cpus > placement.num_cpus)
+        {
+            status = JOB_INVALID;
+        }
+        else
+        {
+            init_job(&line_job, req, NULL, args, out_file, log_file, SIGTERM_timeout, mem_limit, priority, num_cpus);
+            line_job.index = num_jobs;
+
+            if (schedule_job(&line_job))
+            {
+                status = JOB_QUEUED;
+            }
+            else
+            {
+                /* A job launched at once is answered in the batch's reply only. */
+                line_job.session = NULL;
+
+                if ((c_pid = launch_job(&line_job)) == ERROR)
+                {
+                    c_pid = 0;
+                    status = JOB_FAILED;
+                }
+                else
+                {
+                    status = JOB_STARTED;
+                }
+            }
+        }
+
+        put_be32(statuses + num_jobs * JOB_STATUS_LEN, c_pid);
+        put_be32(statuses + num_jobs * JOB_STATUS_LEN + sizeof(int32_t), status);
+        num_jobs++;
+    }
+
+    send_reply(req, MSG_SUBMITTED, statuses, num_jobs * JOB_STATUS_LEN);
+}
+
+int init_admission(pthread_t *admission_thread)
+{
+    char trigger[PSI_BUF_LEN];  // Trigger written to a pressure file.
+    struct epoll_event event;   // Event to register.
+
+    if (pthread_mutex_init(&admission.mutex, NULL) || (admission.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR || 
+        (admission.wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (epoll_ctl(admission.epoll_fd, EPOLL_CTL_ADD, admission.wake_fd, &event))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < NUM_PRESSURES; i++)
+    {
+        admission.fds[i] = ERROR;
+
+        if (!admission.thresholds[i])
+        {
+            continue;
+        }
+
+        /* A trigger is installed by writing it to the pressure file, and stays installed until the file is closed. */
+        snprintf(trigger, PSI_BUF_LEN, "some %ld %d", (long int)(admission.thresholds[i] / HUNDRED_PERCENT * PSI_WINDOW_US), PSI_WINDOW_US);
+
+        if ((admission.fds[i] = open(admission.files[i], O_RDWR | O_NONBLOCK | O_CLOEXEC)) == ERROR || 
+            write(admission.fds[i], trigger, strlen(trigger) + 1) == ERROR)
+        {
+            return ERROR;
+        }
+
+        /* The kernel signals a fired trigger with EPOLLPRI. */
+        event.events = EPOLLPRI;
+        event.data.ptr = &admission.fds[i];
+
+        if (epoll_ctl(admission.epoll_fd, EPOLL_CTL_ADD, admission.fds[i], &event))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pthread_create(admission_thread, NULL, admit_jobs, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return 0;
+}
+
+void init_scheduler(pthread_t *dispatcher_thread)
+{
+    if (pthread_mutex_init(&scheduler.mutex, NULL) || pthread_cond_init(&scheduler.ready, NULL) || 
+        pthread_create(dispatcher_thread, NULL, dispatch_jobs, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void init_capture(pthread_t *capture_thread)
+{
+    struct epoll_event event; // Event to register.
+
+    if (pthread_mutex_init(&capture_list.mutex, NULL) || (capture_list.epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR || 
+        (capture_list.wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) == ERROR || 
+        (capture_list.tail_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (epoll_ctl(capture_list.epoll_fd, EPOLL_CTL_ADD, capture_list.wake_fd, &event))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Tailers waiting for room are registered with an epoll instance nested in the capture thread's, so their sockets are told from pipes. */
+    event.data.ptr = &capture_list.tail_epoll_fd;
+
+    if (epoll_ctl(capture_list.epoll_fd, EPOLL_CTL_ADD, capture_list.tail_epoll_fd, &event) || 
+        pthread_create(capture_thread, NULL, capture_output, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void init_publisher(pthread_t *publisher_thread)
+{
+    if (pthread_mutex_init(&watch_list.mutex, NULL) || pthread_cond_init(&watch_list.ready, NULL) || 
+        pthread_create(publisher_thread, NULL, publish_events, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void listen_to(int *sock_fd, int overseer_port, int backlog)
+{
+    int opt_enable = TRUE;                  // Value of SO_REUSEADDR.
+    struct sockaddr_in overseer_addr = {};  // Overseer internet address.
+
+    if ((*sock_fd = socket(AF_INET, SOCK_STREAM, 0)) == ERROR || setsockopt(*sock_fd, SOL_SOCKET, SO_REUSEADDR, &opt_enable, sizeof(opt_enable)) ||
+         setsockopt(*sock_fd, SOL_SOCKET, SO_REUSEPORT, &opt_enable, sizeof(opt_enable)))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    overseer_addr.sin_family = AF_INET;        
+    overseer_addr.sin_port = overseer_port; 
+    overseer_addr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(*sock_fd, (struct sockaddr *)&overseer_addr, sizeof(struct sockaddr)) || listen(*sock_fd, backlog))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void log_message(struct log_file *log_fp, const char *format, ...)
+{
+    int len;                                    // Length of the formatted message.
+    va_list values;                             // Values referred to by the format.
+
+    struct log_entry *entry = new_log_entry();  // New log entry.
+
+    /* The entry keeps room for the newline after the message, the terminating null byte written by vsnprintf() being overwritten by it. */
+    va_start(values, format);
+    len = vsnprintf(entry->text, LOG_LINE_LEN - 1, format, values);
+    va_end(values);
+
+    if (len < 0)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (len > LOG_LINE_LEN - 2)
+    {
+        len = LOG_LINE_LEN - 2;
+    }
+
+    entry->text[len] = '\n';
+    entry->len = len + 1;
+    entry->log_fp = log_fp;
+    entry->time = time(NULL);
+    entry->release = FALSE;
+
+    push_log_entry(entry);
+}
+
+void close_log_file(struct log_file *log_fp)
+{
+    struct log_entry *entry;    // Entry releasing the reference.
+
+    if (log_fp == NULL)
+    {
+        return;
+    }
+
+    entry = new_log_entry();
+    entry->len = 0;
+    entry->log_fp = log_fp;
+    entry->release = TRUE;
+
+    push_log_entry(entry);
+}
+
+struct log_entry *new_log_entry()
+{
+    struct log_entry *entry; // Pointer to the entry.
+
+    if (pthread_mutex_lock(&log_queue.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if ((entry = log_queue.spare_entries) != NULL)
+    {
+        log_queue.spare_entries = entry->next;
+    }
+
+    if (pthread_mutex_unlock(&log_queue.mutex) || (entry == NULL && (entry = (struct log_entry *)malloc(sizeof(struct log_entry))) == NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return entry;
+}
+
+void init_placement()
+{
+    char cpu_dir[FILENAME_MAX]; // Path of the sysfs directory of the current core.
+    DIR *dir;                   // Sysfs directory of the current core.
+    struct dirent *entry;       // Current entry of the directory.
+
+    if (pthread_mutex_init(&placement.mutex, NULL) || sched_getaffinity(0, sizeof(cpu_set_t), &placement.allowed))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    placement.num_cpus = CPU_COUNT(&placement.allowed);
+    placement.num_nodes = 1;
+
+    for (int i = 0; i < CPU_SETSIZE; i++)
+    {
+        if (!CPU_ISSET(i, &placement.allowed))
+        {
+            continue;
+        }
+
+        snprintf(cpu_dir, FILENAME_MAX, "/sys/devices/system/cpu/cpu%i", i);
+
+        if ((dir = opendir(cpu_dir)) == NULL)
+        {
+            continue;
+        }
+
+        /* The directory links to the node holding the core as nodeN. */
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (!strncmp(entry->d_name, "node", strlen("node")) && atoi(entry->d_name + strlen("node")) < MAX_NODES)
+            {
+                placement.nodes[i] = atoi(entry->d_name + strlen("node"));
+
+                if (placement.nodes[i] >= placement.num_nodes)
+                {
+                    placement.num_nodes = placement.nodes[i] + 1;
+                }
+            }
+        }
+
+        closedir(dir);
+    }
+}
+
+void init_logger(pthread_t *logger_thread)
+{
+    struct log_entry *entry; // Pointer to the current spare entry.
+
+    for (int i = 0; i < LOG_POOL_LEN; i++)
+    {
+        if ((entry = (struct log_entry *)malloc(sizeof(struct log_entry))) == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        entry->next = log_queue.spare_entries;
+        log_queue.spare_entries = entry;
+    }
+
+    if (pthread_mutex_init(&log_queue.mutex, NULL) || (log_queue.wake_fd = eventfd(0, EFD_CLOEXEC)) == ERROR || 
+        pthread_create(logger_thread, NULL, write_logs, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void push_log_entry(struct log_entry *entry)
+{
+    uint64_t wakeup = 1;                                                        // Value to add to the log writer's event file descriptor.
+    struct log_entry *head = __atomic_load_n(&log_queue.entries, __ATOMIC_RELAXED); // Most recently queued entry seen.
+
+    /* A failed compare-and-swap updates head to the entry pushed in the meantime. The entry is not read once pushed, as the log writer may 
+     * already have reused it. */
+    do
+    {
+        entry->next = head;
+    }
+    while (!__atomic_compare_exchange_n(&log_queue.entries, &head, entry, TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    if (head == NULL && write(log_queue.wake_fd, &wakeup, sizeof(wakeup)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void release_log_file(struct log_file *log_fp)
+{
+    struct log_file **link = &log_queue.files;  // Pointer to the link to the current logging redirection file.
+
+    if (pthread_mutex_lock(&log_queue.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!--log_fp->refs)
+    {
+        while (*link != log_fp)
+        {
+            link = &(*link)->next;
+        }
+
+        *link = log_fp->next;
+
+        if (close(log_fp->fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        log_fp->next = log_queue.spare_files;
+        log_queue.spare_files = log_fp;
+    }
+
+    if (pthread_mutex_unlock(&log_queue.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void stop_logger(pthread_t logger_thread)
+{
+    uint64_t wakeup = 1;        // Value to add to the log writer's event file descriptor.
+    struct log_entry *entry;    // Pointer to the current spare entry.
+    struct log_file *log_fp;    // Pointer to the current logging redirection file.
+
+    __atomic_store_n(&log_queue.quit, TRUE, __ATOMIC_RELEASE);
+
+    if (write(log_queue.wake_fd, &wakeup, sizeof(wakeup)) == ERROR || pthread_join(logger_thread, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The files of children which were still held when the overseer terminated remain open. */
+    while ((log_fp = log_queue.files) != NULL)
+    {
+        log_queue.files = log_fp->next;
+
+        if (close(log_fp->fd))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        free(log_fp);
+    }
+
+    while ((log_fp = log_queue.spare_files) != NULL)
+    {
+        log_queue.spare_files = log_fp->next;
+        free(log_fp);
+    }
+
+    while ((entry = log_queue.spare_entries) != NULL)
+    {
+        log_queue.spare_entries = entry->next;
+        free(entry);
+    }
+
+    if (close(log_queue.wake_fd))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void write_log_entries(struct log_entry *entries)
+{
+    int fd;                                 // File descriptor of the destination of the current batch.
+    int num_iovs;                           // Number of I/O vectors of the current batch not yet written.
+    ssize_t num_bytes;                      // Number of bytes written by the current call.
+    time_t stamp_time = ERROR;              // System time the cached timestamp was formatted for.
+    char stamp[TIME_STR_LEN];               // Cached timestamp.
+    size_t stamp_len = 0;                   // Length of the cached timestamp.
+    struct iovec iovs[2 * LOG_BATCH_LEN];   // I/O vectors of the current batch.
+    struct iovec *iov;                      // Pointer to the first I/O vector not yet written.
+    struct log_entry *batch;                // Pointer to the first entry of the current batch.
+    struct log_entry *entry;                // Pointer to the current entry.
+
+    while ((batch = entries) != NULL)
+    {
+        fd = batch->log_fp == NULL ? STDOUT_FILENO : batch->log_fp->fd;
+        num_iovs = 0;
+
+        /* A batch ends at a change of destination or at an entry releasing its file, which may be closed once the batch is written. */
+        do
+        {
+            entry = entries;
+            entries = entry->next;
+
+            if (!entry->len)
+            {
+                continue;
+            }
+
+            /* Timestamps only change once a second, so the formatted one is reused until then. */
+            if (entry->time != stamp_time)
+            {
+                format_time(entry->time, stamp);
+                strcat(stamp, " - ");
+                stamp_len = strlen(stamp);
+                stamp_time = entry->time;
+            }
+
+            memcpy(entry->stamp, stamp, stamp_len);
+
+            iovs[num_iovs].iov_base = entry->stamp;
+            iovs[num_iovs++].iov_len = stamp_len;
+            iovs[num_iovs].iov_base = entry->text;
+            iovs[num_iovs++].iov_len = entry->len;
+        }
+        while (!entry->release && entries != NULL && entries->log_fp == batch->log_fp && num_iovs < 2 * LOG_BATCH_LEN);
+
+        /* Lines which cannot be written are dropped, as they were when written with fprintf(). */
+        iov = iovs;
+        while (num_iovs > 0)
+        {
+            if ((num_bytes = writev(fd, iov, num_iovs)) == ERROR)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                break;
+            }
+
+            while (num_iovs > 0 && (size_t)num_bytes >= iov->iov_len)
+            {
+                num_bytes -= iov->iov_len;
+                iov++;
+                num_iovs--;
+            }
+
+            if (num_iovs > 0)
+            {
+                iov->iov_base = (char *)iov->iov_base + num_bytes;
+                iov->iov_len -= num_bytes;
+            }
+        }
+
+        /* A releasing entry always ends its batch. The batch is handed back whole, so the threads logging contend for the mutex once per batch. */
+        for (entry = batch; entry->next != entries; entry = entry->next);
+
+        if (entry->release)
+        {
+            release_log_file(entry->log_fp);
+        }
+
+        if (pthread_mutex_lock(&log_queue.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        entry->next = log_queue.spare_entries;
+        log_queue.spare_entries = batch;
+
+        if (pthread_mutex_unlock(&log_queue.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void run_reactor(struct reactor *reactor, int *signal_fd)
+{
+    int new_fd;                             // Connection file descriptor.
+    int num_events;                         // Number of events returned by epoll_wait().
+    uint64_t stop = 1;                      // Value to add to the event file descriptor stopping the reactors.
+    char controller_ip[INET_ADDRSTRLEN];    // IP address of controller, formatted on the reactor's stack as reactors run concurrently.
+    struct epoll_event events[MAX_EVENTS];  // Events returned by epoll_wait().
+    struct sockaddr_in controller_addr;     // Internet address of controller.
+
+    while (TRUE)
+    {
+        if ((num_events = epoll_wait(reactor->epoll_fd, events, MAX_EVENTS, ERROR)) == ERROR)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            exit(EXIT_FAILURE);
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            /* The event file descriptor is never read, so it stays readable and stops every reactor. */
+            if (events[i].data.ptr == signal_fd)
+            {
+                handle_SIGINT(*signal_fd);
+
+                if (write(reactor_pool.quit_fd, &stop, sizeof(stop)) == ERROR)
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                return;
+            }
+
+            if (events[i].data.ptr == &reactor_pool.quit_fd)
+            {
+                return;
+            }
+
+            /* Accept every pending connection, so that a burst of connections is handled in a single wakeup. */
+            if (events[i].data.ptr == &reactor->sock_fd)
+            {
+                while ((new_fd = accept_conn(reactor->sock_fd, &controller_addr)) != ERROR)
+                {
+                    inet_ntop(AF_INET, &controller_addr.sin_addr, controller_ip, INET_ADDRSTRLEN);
+                    log_message(NULL, "connection received from %s", controller_ip);
+
+                    open_session(reactor, new_fd);
+                }
+            }
+            else
+            {
+                read_session(events[i].data.ptr);
+            }
+        }
+    }
+}
+
+void read_memory_events(struct child *child)
+{
+    char buf[CGROUP_BUF_LEN];   // Buffer of the memory.events file.
+    char *line;                 // Current line of the file.
+    char *saveptr;              // Position of the next line.
+    long int num_high = 0;      // Number of times the cgroup has been throttled.
+    long int num_oom_kills = 0; // Number of processes of the cgroup killed by the OOM killer.
+    ssize_t num_bytes;          // Number of bytes read.
+
+    if ((num_bytes = pread(child->events_fd, buf, CGROUP_BUF_LEN - 1, 0)) <= 0)
+    {
+        return;
+    }
+
+    buf[num_bytes] = '\0';
+
+    /* The file is "low <n>\nhigh <n>\nmax <n>\noom <n>\noom_kill <n>\n...", each a count since the cgroup was created. */
+    for (line = strtok_r(buf, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr))
+    {
+        if (!strncmp(line, "high ", strlen("high ")))
+        {
+            num_high = atol(line + strlen("high "));
+        }
+        else if (!strncmp(line, "oom_kill ", strlen("oom_kill ")))
+        {
+            num_oom_kills = atol(line + strlen("oom_kill "));
+        }
+    }
+
+    if (num_high > child->num_high)
+    {
+        child->num_high = num_high;
+        log_message(child->log_fp, "%i has been throttled for exceeding its memory.high %ld times", child->c_pid, num_high);
+        publish_event(EVENT_MEMORY_HIGH, child->c_pid, num_high);
+    }
+
+    if (num_oom_kills > child->num_oom_kills)
+    {
+        child->num_oom_kills = num_oom_kills;
+        log_message(child->log_fp, "%i has had %ld processes killed for exceeding its memory.max", child->c_pid, num_oom_kills);
+        publish_event(EVENT_OOM_KILL, child->c_pid, num_oom_kills);
+    }
+}
+
+void remove_child(int epoll_fd, struct timer_wheel *wheel, struct child *child)
+{
+    cancel_timer(wheel, &child->SIGTERM_timer);
+    cancel_timer(wheel, &child->SIGKILL_timer);
+
+    /* The pidfd must leave the supervisor's epoll set explicitly, as closing it does not while a child spawned but not yet executed by a worker 
+     * holds a copy, and the set would then keep reporting a child which has been reaped and freed. */
+    if (child->pidfd != ERROR)
+    {
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_DEL, child->pidfd, NULL) || close(child->pidfd))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        child->pidfd = ERROR;
+    }
+
+    /* Events raised as the child was killed are reported before its cgroup goes, which the kernel only allows once it is empty. */
+    if (child->events_fd != ERROR)
+    {
+        read_memory_events(child);
+
+        if (epoll_ctl(cgroup_tree.epoll_fd, EPOLL_CTL_DEL, child->events_fd, NULL))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (strcmp(child->cgroup, "") && rmdir(child->cgroup) && errno != EBUSY)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (child->prev == NULL)
+    {
+        children = child->next;
+    }
+    else
+    {
+        child->prev->next = child->next;
+    }
+
+    if (child->next != NULL)
+    {
+        child->next->prev = child->prev;
+    }
+
+    delete_child(child);
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (CPU_COUNT(&child->cpus))
+    {
+        release_cpus(&child->cpus);
+        CPU_ZERO(&child->cpus);
+    }
+
+    finish_job(child->priority);
+    release_child(child);
+}
+
+void release_session(struct session *session)
+{
+    int refs; // Number of references remaining.
+
+    if (pthread_mutex_lock(&session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    refs = --session->refs;
+
+    if (pthread_mutex_unlock(&session->mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!refs)
+    {
+        if ((session->fd != ERROR && close(session->fd)) || pthread_mutex_destroy(&session->mutex) || 
+            pthread_mutex_destroy(&session->send_mutex) || pthread_cond_destroy(&session->sent))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        free(session->buf);
+        free(session);
+    }
+}
+
+void release_child(struct child *child)
+{
+    int refs; // Number of references remaining.
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    refs = --child->refs;
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!refs)
+    {
+        free_child(child);
+    }
+}
+
+void resize_proc_table()
+{
+    long int capacity = PROC_TABLE_MIN_SLOTS;   // Number of slots in the new table.
+    struct proc_slot *old_slots;                // Slots of the old table.
+    long int old_capacity;                      // Number of slots in the old table.
+
+    while (capacity < (proc_table.num_children + 1) * 2)
+    {
+        capacity *= 2;
+    }
+
+    old_slots = proc_table.slots;
+    old_capacity = proc_table.capacity;
+
+    /* A table full of tombstones is rehashed at its own size, into its spare. */
+    if (capacity == old_capacity)
+    {
+        proc_table.slots = proc_table.spare;
+        proc_table.spare = NULL;
+        memset(proc_table.slots, 0, capacity * sizeof(struct proc_slot));
+    }
+    else if ((proc_table.slots = calloc(capacity, sizeof(struct proc_slot))) == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    proc_table.capacity = capacity;
+    proc_table.num_children = 0;
+    proc_table.num_used = 0;
+
+    for (long int i = 0; i < old_capacity; i++)
+    {
+        if (old_slots[i].c_pid != EMPTY_SLOT && old_slots[i].c_pid != TOMBSTONE)
+        {
+            insert_child(old_slots[i].child);
+        }
+    }
+
+    /* The spare is allocated as the table grows, so that the tombstones of a steady stream of children are cleared without allocating. */
+    if (capacity == old_capacity)
+    {
+        proc_table.spare = old_slots;
+    }
+    else
+    {
+        free(old_slots);
+        free(proc_table.spare);
+
+        if ((proc_table.spare = malloc(capacity * sizeof(struct proc_slot))) == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void publish_event(int kind, pid_t c_pid, long int value)
+{
+    struct watch_event event = {kind, c_pid, time(NULL), value}; // Event to publish.
+
+    if (pthread_mutex_lock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    for (struct subscriber *subscriber = watch_list.subscribers; subscriber != NULL; subscriber = subscriber->next)
+    {
+        queue_event(subscriber, &event);
+    }
+
+    if (pthread_mutex_unlock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void publish_samples(time_t raw_time, int num_children)
+{
+    struct watch_event event = {EVENT_SAMPLE, 0, raw_time, 0}; // Event to publish.
+
+    if (pthread_mutex_lock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The sampler only ever copies into the subscribers' buffers, so a slow subscriber cannot delay it. */
+    for (struct subscriber *subscriber = watch_list.subscribers; subscriber != NULL; subscriber = subscriber->next)
+    {
+        for (int i = 0; i < num_children; i++)
+        {
+            event.c_pid = sample_batch.children[i]->c_pid;
+            event.value = sample_batch.mem_used[i];
+            queue_event(subscriber, &event);
+        }
+    }
+
+    if (pthread_mutex_unlock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void prune_tailers(struct tailer **tailers)
+{
+    int closed;                 // Indicator of if the tailer's session can no longer be delivered to.
+    int terminating;            // Indicator that the overseer is terminating.
+    struct tailer **link;       // Pointer to the link to the current tailer.
+    struct tailer *tailer;      // Pointer to the current tailer.
+
+    if (pthread_mutex_lock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    terminating = quit;
+
+    if (pthread_mutex_unlock(&quit_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Every session stops being read when the overseer terminates, but its tailers are still sent the rest of the output and MSG_END. */
+    for (link = tailers; (tailer = *link) != NULL;)
+    {
+        if (pthread_mutex_lock(&tailer->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        closed = (!tailer->session->reading && !terminating) || tailer->session->broken;
+
+        if (pthread_mutex_unlock(&tailer->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (!closed)
+        {
+            link = &tailer->next;
+            continue;
+        }
+
+        *link = tailer->next;
+        free_tailer(tailer);
+    }
+}
+
+void prune_subscribers()
+{
+    int closed;                         // Indicator of if the subscriber's session can no longer be delivered to.
+    struct subscriber **link;           // Pointer to the link to the current subscriber.
+    struct subscriber *subscriber;      // Pointer to the current subscriber.
+
+    for (link = &watch_list.subscribers; (subscriber = *link) != NULL;)
+    {
+        if (pthread_mutex_lock(&subscriber->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        closed = !subscriber->session->reading || subscriber->session->broken;
+
+        if (pthread_mutex_unlock(&subscriber->session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (!closed)
+        {
+            link = &subscriber->next;
+            continue;
+        }
+
+        if (subscriber->num_events || subscriber->num_dropped)
+        {
+            watch_list.num_pending--;
+        }
+
+        *link = subscriber->next;
+        release_session(subscriber->session);
+        free(subscriber);
+    }
+}
+
+void queue_event(struct subscriber *subscriber, struct watch_event *event)
+{
+    if (subscriber->c_pid && subscriber->c_pid != event->c_pid)
+    {
+        return;
+    }
+
+    if (!subscriber->num_events && !subscriber->num_dropped && watch_list.num_pending++ == 0 && pthread_cond_signal(&watch_list.ready))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A subscriber which falls behind loses its oldest events, and is told how many. */
+    if (subscriber->num_events == WATCH_BUF_LEN)
+    {
+        subscriber->head = (subscriber->head + 1) % WATCH_BUF_LEN;
+        subscriber->num_events--;
+        subscriber->num_dropped++;
+    }
+
+    subscriber->events[(subscriber->head + subscriber->num_events++) % WATCH_BUF_LEN] = *event;
+}
+
+void read_history(struct child *child, struct mem_sample *history, unsigned long int *num_samples)
+{
+    unsigned long int seq; // Sequence count of the history before it was read.
+
+    do
+    {
+        while ((seq = __atomic_load_n(&child->seq, __ATOMIC_ACQUIRE)) & 1);
+
+        *num_samples = child->num_samples;
+        memcpy(history, child->history, sizeof(child->history));
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&child->seq, __ATOMIC_RELAXED) != seq);
+}
+
+void read_session(struct session *session)
+{
+    int decoded;                // Result of decoding the header of the frame at the start of the buffer.
+    int flags;                  // File status flags of the socket.
+    int paused;                 // Indicator of if the session has been paused.
+    ssize_t num_bytes;          // Number of bytes received by the current call.
+    size_t frame_len;           // Length of the frame at the start of the buffer.
+    struct epoll_event event;   // Event to modify.
+    struct frame_header header; // Header of the frame at the start of the buffer.
+    unsigned char magic[2];     // First bytes received on the connection.
+
+    /* A connection is classified by its first bytes; legacy connections are handed to the workers whole. */
+    if (session->framed == ERROR)
+    {
+        if ((num_bytes = recv(session->fd, magic, sizeof(magic), MSG_PEEK | MSG_DONTWAIT)) == ERROR && (errno == EAGAIN || errno == EINTR))
+        {
+            return;
+        }
+
+        if (num_bytes <= 0)
+        {
+            close_session(session);
+            return;
+        }
+
+        if (magic[0] == PROTOCOL_MAGIC >> 8 && num_bytes == 1)
+        {
+            return;
+        }
+
+        if (magic[0] != PROTOCOL_MAGIC >> 8 || magic[1] != (PROTOCOL_MAGIC & 0xFF))
+        {
+            if (epoll_ctl(session->epoll_fd, EPOLL_CTL_DEL, session->fd, NULL))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            add_request(session->reactor, session->fd, NULL, NULL, NULL);
+            session->fd = ERROR;
+            close_session(session);
+            return;
+        }
+
+        /* Output is spliced onto the socket by the capture thread, which must never block on a controller that has stopped reading. */
+        if ((flags = fcntl(session->fd, F_GETFL)) == ERROR || fcntl(session->fd, F_SETFL, flags | O_NONBLOCK) == ERROR)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        session->framed = TRUE;
+    }
+
+    while (TRUE)
+    {
+        if ((num_bytes = recv(session->fd, session->buf + session->len, SESSION_BUF_LEN - session->len, MSG_DONTWAIT)) == ERROR)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                return;
+            }
+        }
+
+        /* Once the controller stops sending, the session lives on only until its requests have been answered. */
+        if (num_bytes <= 0)
+        {
+            close_session(session);
+            return;
+        }
+
+        session->len += num_bytes;
+
+        /* Queue every complete frame in the buffer. */
+        while (session->len >= FRAME_HEADER_LEN)
+        {
+            if ((decoded = decode_header(session->buf, &header)) == ERROR || header.version != PROTOCOL_VERSION || header.length >= PATH_MAX)
+            {
+                lock_send(session);
+
+                if (!session->broken)
+                {
+                    send_frame(session->fd, MSG_ERROR, decoded == ERROR ? 0 : header.id, "malformed frame or unsupported protocol version", 
+                               strlen("malformed frame or unsupported protocol version"));
+                }
+
+                if (pthread_mutex_unlock(&session->send_mutex))
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                close_session(session);
+                return;
+            }
+
+            if (session->len < (frame_len = FRAME_HEADER_LEN + header.length))
+            {
+                break;
+            }
+
+            if (pthread_mutex_lock(&session->mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            session->refs++;
+            session->num_requests++;
+
+            if (pthread_mutex_unlock(&session->mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            add_request(session->reactor, session->fd, session, &header, session->buf + FRAME_HEADER_LEN);
+
+            session->len -= frame_len;
+            memmove(session->buf, session->buf + frame_len, session->len);
+        }
+
+        if (pthread_mutex_lock(&session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        /* A controller with too many requests in flight is not read from until some have been answered. */
+        if ((paused = session->num_requests >= SESSION_MAX_REQUESTS))
+        {
+            event.events = 0;
+            event.data.ptr = session;
+
+            if (epoll_ctl(session->epoll_fd, EPOLL_CTL_MOD, session->fd, &event))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            session->paused = TRUE;
+        }
+
+        if (pthread_mutex_unlock(&session->mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (paused)
+        {
+            return;
+        }
+    }
+}
+
+void rotate_out_file(struct capture *capture)
+{
+    char rotated_file[PATH_MAX + sizeof(ROTATED_SUFFIX)]; // File path of the rotated output file.
+
+    sprintf(rotated_file, "%s%s", capture->out_file, ROTATED_SUFFIX);
+
+    if (rename(capture->out_file, rotated_file) || close(capture->out_fd) || 
+        (capture->out_fd = open(capture->out_file, O_CLOEXEC | O_CREAT | O_TRUNC | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    capture->out_len = 0;
+}
+
+void send_mem_info_all(struct child **proc_children, long int *mem_used, int num_procs, struct request *req)
+{
+    size_t args_len;                                    // Length of the file and arguments of current process.
+    struct frame_buf *frames = &req->arena->frames;     // Buffer of encoded frames.
+
+    char *buf_send = arena_alloc(req->arena, PATH_MAX); // Buffer to send back to controller.
+
+    for (int i = 0; i < num_procs; i++)
+    {
+        if (req->session != NULL)
+        {
+            args_len = strnlen(proc_children[i]->args, PATH_MAX - MEM_USAGE_LEN);
+            put_be32(buf_send, proc_children[i]->c_pid);
+            put_be64(buf_send + sizeof(int32_t), mem_used[i]);
+            memcpy(buf_send + MEM_USAGE_LEN, proc_children[i]->args, args_len);
+            add_frame(frames, MSG_MEM_USAGE, req->id, buf_send, MEM_USAGE_LEN + args_len);
+        }
+        else
+        {
+            /* A line cut short by a long command still ends in a newline. */
+            if (snprintf(buf_send, PATH_MAX, "%i %li %s\n", proc_children[i]->c_pid, mem_used[i], proc_children[i]->args) >= PATH_MAX)
+            {
+                buf_send[PATH_MAX - 2] = '\n';
+            }
+
+            /* If the controller has gone away, there is no one left to send to. */
+            if (send_all(req->new_fd, buf_send, PATH_MAX) == ERROR)
+            {
+                break;
+            }
+        }
+    }
+
+    /* The whole listing is sent with one call. */
+    if (req->session != NULL)
+    {
+        add_frame(frames, MSG_END, req->id, NULL, 0);
+        send_replies(req->session, frames);
+    }
+}
+
+void send_mem_info_id(pid_t proc_id, struct request *req)
+{
+    struct child *child;                                // Pointer to the process' child record.
+    struct mem_sample *sample;                          // Pointer to current sample.
+    unsigned long int num_samples;                      // Number of samples ever taken of the process.
+    char timestamp[TIME_STR_LEN];                       // Timestamp of current sample.
+    struct frame_buf *frames = &req->arena->frames;     // Buffer of encoded frames.
+
+    char *buf_send = arena_alloc(req->arena, PATH_MAX);                                                 // Buffer to send back to controller.
+    struct mem_sample *history = arena_alloc(req->arena, sizeof(struct mem_sample) * MEM_HISTORY_LEN);  // Snapshot of the process' history.
+
+    if (pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if ((child = find_child(proc_id)) != NULL)
+    {
+        child->refs++;
+    }
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    num_samples = 0;
+
+    if (child != NULL)
+    {
+        read_history(child, history, &num_samples);
+        release_child(child);
+    }
+
+    /* Send the snapshot, oldest sample first, without holding any lock. */
+    for (unsigned long int i = num_samples > MEM_HISTORY_LEN ? num_samples - MEM_HISTORY_LEN : 0; i < num_samples; i++)
+    {
+        sample = &history[i % MEM_HISTORY_LEN];
+
+        if (req->session != NULL)
+        {
+            put_be64(buf_send, sample->time);
+            put_be64(buf_send + sizeof(int64_t), sample->mem_used);
+            add_frame(frames, MSG_MEM_SAMPLE, req->id, buf_send, MEM_SAMPLE_LEN);
+        }
+        else
+        {
+            format_time(sample->time, timestamp);
+            sprintf(buf_send, "%s %li\n", timestamp, sample->mem_used);
+
+            /* If the controller has gone away, there is no one left to send to. */
+            if (send_all(req->new_fd, buf_send, PATH_MAX) == ERROR)
+            {
+                break;
+            }
+        }
+    }
+
+    /* The whole history is sent with one call. */
+    if (req->session != NULL)
+    {
+        add_frame(frames, MSG_END, req->id, NULL, 0);
+        send_replies(req->session, frames);
+    }
+}
+
+void lock_send(struct session *session)
+{
+    if (pthread_mutex_lock(&session->send_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A tailer stopped part way through a frame by a full socket finishes it before anything else is sent. */
+    while (session->sending != NULL)
+    {
+        session->num_waiting++;
+
+        if (pthread_cond_wait(&session->sent, &session->send_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        session->num_waiting--;
+    }
+}
+
+void send_replies(struct session *session, struct frame_buf *frames)
+{
+    if (session == NULL)
+    {
+        frames->len = 0;
+        return;
+    }
+
+    /* Replies to pipelined requests are sent in the order they complete, so writers to the session are serialised. */
+    lock_send(session);
+
+    if (!session->broken && send_frames(session->fd, frames) == ERROR)
+    {
+        session->broken = TRUE;
+    }
+
+    frames->len = 0;
+
+    if (pthread_mutex_unlock(&session->send_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+int send_output(struct tailer *tailer)
+{
+    int done = FALSE;                           // Indicator that the tailer can be freed.
+    int result;                                 // Result of trying to lock the session's send mutex.
+    int waiting = TRUE;                         // Indicator that the tailer holds output the socket has not had room for.
+    ssize_t num_bytes;                          // Number of bytes sent by the current call.
+    struct epoll_event event;                   // Event to register.
+    struct session *session = tailer->session;  // Session of the tailer.
+
+    /* The capture thread serves every captured child, so it never waits for the session's other writers. */
+    if ((result = pthread_mutex_trylock(&session->send_mutex)) && result != EBUSY)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (!result && (session->sending == NULL || session->sending == tailer))
+    {
+        while (!session->broken)
+        {
+            /* Replies waiting for the frame just finished are let through before the next, so a tailer cannot hold the session forever. */
+            if (tailer->frame_sent == tailer->frame_len && !tailer->output_left)
+            {
+                if (session->num_waiting)
+                {
+                    break;
+                }
+                else if (tailer->len > 0)
+                {
+                    tailer->output_left = tailer->len < MAX_PAYLOAD_LEN ? tailer->len : MAX_PAYLOAD_LEN;
+                    encode_header(tailer->frame, MSG_OUTPUT, tailer->id, tailer->output_left);
+                    tailer->frame_len = FRAME_HEADER_LEN;
+                }
+                /* Bytes are only dropped once the pipe is full, so they followed all of the output sent before. */
+                else if (tailer->num_dropped)
+                {
+                    encode_header(tailer->frame, MSG_EVENT, tailer->id, EVENT_LEN);
+                    put_be32(tailer->frame + FRAME_HEADER_LEN, EVENT_OUTPUT_DROPPED);
+                    put_be32(tailer->frame + FRAME_HEADER_LEN + sizeof(int32_t), tailer->c_pid);
+                    put_be64(tailer->frame + FRAME_HEADER_LEN + 2 * sizeof(int32_t), time(NULL));
+                    put_be64(tailer->frame + FRAME_HEADER_LEN + 2 * sizeof(int32_t) + sizeof(int64_t), tailer->num_dropped);
+                    tailer->frame_len = FRAME_HEADER_LEN + EVENT_LEN;
+                    tailer->num_dropped = 0;
+                }
+                else if (tailer->ending && !tailer->ended)
+                {
+                    encode_header(tailer->frame, MSG_END, tailer->id, 0);
+                    tailer->frame_len = FRAME_HEADER_LEN;
+                    tailer->ended = TRUE;
+                }
+                else
+                {
+                    break;
+                }
+
+                tailer->frame_sent = 0;
+            }
+
+            if (tailer->frame_sent < tailer->frame_len)
+            {
+                num_bytes = send(session->fd, tailer->frame + tailer->frame_sent, tailer->frame_len - tailer->frame_sent, 
+                                 MSG_DONTWAIT | MSG_NOSIGNAL);
+            }
+            else
+            {
+                num_bytes = splice(tailer->pipe_fds[0], NULL, session->fd, NULL, tailer->output_left, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            }
+
+            if (num_bytes == ERROR)
+            {
+                /* The rest waits for room in the socket, but a frame cut short by any other failure leaves the session to be abandoned. */
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+
+                session->broken = errno != EINTR;
+                continue;
+            }
+
+            if (tailer->frame_sent < tailer->frame_len)
+            {
+                tailer->frame_sent += num_bytes;
+                continue;
+            }
+
+            tailer->output_left -= num_bytes;
+            tailer->len -= num_bytes;
+        }
+
+        /* Until a frame part way sent is finished, nothing else may be sent to the session. */
+        if (!session->broken && tailer->frame_sent > 0 && (tailer->frame_sent < tailer->frame_len || tailer->output_left > 0))
+        {
+            session->sending = tailer;
+        }
+        else if (session->sending == tailer)
+        {
+            session->sending = NULL;
+
+            if (pthread_cond_broadcast(&session->sent))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        waiting = !session->broken && (tailer->frame_sent < tailer->frame_len || tailer->output_left || tailer->len || tailer->num_dropped || 
+                                       (tailer->ending && !tailer->ended));
+        done = session->broken || (tailer->ended && !waiting);
+    }
+
+    if (!result && pthread_mutex_unlock(&session->send_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* A tailer holding output is woken by room in its socket, rather than waiting for more output from its child. */
+    if (waiting != tailer->waiting)
+    {
+        event.events = EPOLLOUT;
+        event.data.ptr = tailer;
+
+        if (epoll_ctl(capture_list.tail_epoll_fd, waiting ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, tailer->sock_fd, &event))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        tailer->waiting = waiting;
+    }
+
+    return done;
+}
+
+void send_reply(struct request *req, int type, const void *payload, size_t len)
+{
+    char data[FRAME_HEADER_LEN + REPLY_BUF_LEN];    // Encoded frame, if the request has no arena and the frame fits.
+    struct frame_buf local = {NULL, 0, 0};          // Buffer holding the encoded frame, if the request has no arena.
+
+    struct frame_buf *frames = req->arena != NULL ? &req->arena->frames : &local; // Buffer the frame is encoded into.
+
+    if (req->session == NULL)
+    {
+        return;
+    }
+
+    /* Jobs launched outside a worker are answered with a pid or a short error, which is encoded on the stack rather than allocated. */
+    if (req->arena == NULL && len <= REPLY_BUF_LEN)
+    {
+        local.data = data;
+        local.capacity = sizeof(data);
+    }
+
+    add_frame(frames, type, req->id, payload, len);
+    send_replies(req->session, frames);
+
+    if (local.data != data)
+    {
+        free_frames(&local);
+    }
+}
+
+void *publish_events(void *void_var)
+{
+    char payload[EVENT_LEN];                // Payload of the current event.
+    struct frame_buf frames = {NULL, 0, 0}; // Buffer holding the events of the current subscriber.
+    struct watch_event *event;              // Pointer to the current event.
+
+    if (pthread_mutex_lock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (TRUE)
+    {
+        while (!watch_list.quit && !watch_list.num_pending && !watch_list.prune)
+        {
+            if (pthread_cond_wait(&watch_list.ready, &watch_list.mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (watch_list.quit)
+        {
+            break;
+        }
+
+        if (watch_list.prune)
+        {
+            watch_list.prune = FALSE;
+            prune_subscribers();
+        }
+
+        /* Only this thread removes subscribers, so the list may be walked across the unlocked sends. */
+        for (struct subscriber *subscriber = watch_list.subscribers; subscriber != NULL; subscriber = subscriber->next)
+        {
+            if (!subscriber->num_events && !subscriber->num_dropped)
+            {
+                continue;
+            }
+
+            if (subscriber->num_dropped)
+            {
+                put_be32(payload, EVENT_DROPPED);
+                put_be32(payload + sizeof(int32_t), 0);
+                put_be64(payload + 2 * sizeof(int32_t), time(NULL));
+                put_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t), subscriber->num_dropped);
+                add_frame(&frames, MSG_EVENT, subscriber->id, payload, EVENT_LEN);
+            }
+
+            for (int i = 0; i < subscriber->num_events; i++)
+            {
+                event = &subscriber->events[(subscriber->head + i) % WATCH_BUF_LEN];
+
+                put_be32(payload, event->kind);
+                put_be32(payload + sizeof(int32_t), event->c_pid);
+                put_be64(payload + 2 * sizeof(int32_t), event->time);
+                put_be64(payload + 2 * sizeof(int32_t) + sizeof(int64_t), event->value);
+                add_frame(&frames, MSG_EVENT, subscriber->id, payload, EVENT_LEN);
+            }
+
+            subscriber->head = 0;
+            subscriber->num_events = 0;
+            subscriber->num_dropped = 0;
+            watch_list.num_pending--;
+
+            /* The events are sent without holding the mutex, so a slow subscriber only delays delivery to the others. */
+            if (pthread_mutex_unlock(&watch_list.mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            send_replies(subscriber->session, &frames);
+
+            if (pthread_mutex_lock(&watch_list.mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            watch_list.prune |= subscriber->session->broken;
+        }
+    }
+
+    if (pthread_mutex_unlock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    free_frames(&frames);
+
+    return NULL;
+}
+
+void *capture_output(void *void_var)
+{
+    int num_events;                             // Number of events returned by epoll_wait().
+    int num_tail_events;                        // Number of tailers returned by epoll_wait().
+    int timeout = ERROR;                        // Time epoll_wait() waits for in milliseconds, or ERROR to wait indefinitely.
+    long int deadline = ERROR;                  // Monotonic time in milliseconds at which draining tailers are abandoned, or ERROR.
+    uint64_t wakeups;                           // Value read from the capture thread's event file descriptor.
+    sigset_t mask;                              // Set of signals blocked in the capture thread.
+    struct capture *capture;                    // Pointer to the current capture.
+    struct tailer **link;                       // Pointer to the link to the current draining tailer.
+    struct tailer *tailer;                      // Pointer to the current tailer.
+    struct epoll_event events[MAX_EVENTS];      // Events returned by epoll_wait().
+    struct epoll_event tail_events[MAX_EVENTS]; // Tailers whose sockets have room returned by epoll_wait().
+
+    /* Splicing into the socket of a controller which has gone away raises SIGPIPE, which unlike send() has no flag to suppress it. */
+    if (sigemptyset(&mask) || sigaddset(&mask, SIGPIPE) || pthread_sigmask(SIG_BLOCK, &mask, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (TRUE)
+    {
+        if (deadline != ERROR && (timeout = deadline - get_time_ms()) < 0)
+        {
+            timeout = 0;
+        }
+
+        if ((num_events = epoll_wait(capture_list.epoll_fd, events, MAX_EVENTS, timeout)) == ERROR)
+        {
+            if (errno != EINTR)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            num_events = 0;
+        }
+
+        if (pthread_mutex_lock(&capture_list.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            if (events[i].data.ptr == NULL)
+            {
+                if (read(capture_list.wake_fd, &wakeups, sizeof(wakeups)) == ERROR && errno != EAGAIN)
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                continue;
+            }
+
+            if (events[i].data.ptr == &capture_list.tail_epoll_fd)
+            {
+                if ((num_tail_events = epoll_wait(capture_list.tail_epoll_fd, tail_events, MAX_EVENTS, 0)) == ERROR)
+                {
+                    if (errno != EINTR)
+                    {
+                        exit(EXIT_FAILURE);
+                    }
+
+                    num_tail_events = 0;
+                }
+
+                /* Only the tailers of finished captures end, and those are all draining; the rest are pruned with their captures. */
+                for (int j = 0; j < num_tail_events; j++)
+                {
+                    tailer = tail_events[j].data.ptr;
+
+                    if (!send_output(tailer) || !tailer->ending)
+                    {
+                        continue;
+                    }
+
+                    for (link = &capture_list.draining; *link != tailer; link = &(*link)->next);
+
+                    *link = tailer->next;
+                    free_tailer(tailer);
+                }
+
+                continue;
+            }
+
+            capture = events[i].data.ptr;
+            move_output(capture);
+
+            /* Once the child and its descendants have closed the pipe, the output just moved was the last. */
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                finish_capture(capture);
+            }
+        }
+
+        if (__atomic_exchange_n(&capture_list.prune, FALSE, __ATOMIC_ACQ_REL))
+        {
+            for (capture = capture_list.captures; capture != NULL; capture = capture->next)
+            {
+                prune_tailers(&capture->tailers);
+            }
+
+            prune_tailers(&capture_list.draining);
+        }
+
+        /* The children have been killed by the time the thread is instructed to terminate, so only descendants could still write. */
+        if (__atomic_load_n(&capture_list.quit, __ATOMIC_ACQUIRE))
+        {
+            if (deadline == ERROR)
+            {
+                while ((capture = capture_list.captures) != NULL)
+                {
+                    move_output(capture);
+                    finish_capture(capture);
+                }
+
+                deadline = get_time_ms() + TAIL_DRAIN_MS;
+            }
+
+            /* Tailers are given a while to take the rest of their output, then abandoned with their controllers, which have stopped reading. */
+            if (capture_list.draining == NULL || get_time_ms() >= deadline)
+            {
+                while ((tailer = capture_list.draining) != NULL)
+                {
+                    capture_list.draining = tailer->next;
+                    free_tailer(tailer);
+                }
+
+                if (pthread_mutex_unlock(&capture_list.mutex))
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                break;
+            }
+        }
+
+        if (pthread_mutex_unlock(&capture_list.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return NULL;
+}
+
+void *write_logs(void *void_var)
+{
+    uint64_t wakeups;           // Number of wakeups since the last read.
+    struct log_entry *entries;  // Entries taken from the queue, most recent first.
+    struct log_entry *entry;    // Pointer to the current entry.
+    struct log_entry *ordered;  // Entries taken from the queue, in the order they were logged.
+
+    while (TRUE)
+    {
+        if (read(log_queue.wake_fd, &wakeups, sizeof(wakeups)) == ERROR && errno != EINTR)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        entries = __atomic_exchange_n(&log_queue.entries, NULL, __ATOMIC_ACQUIRE);
+
+        /* The queue is a stack, so its entries are reversed into the order they were logged. */
+        ordered = NULL;
+        while ((entry = entries) != NULL)
+        {
+            entries = entry->next;
+            entry->next = ordered;
+            ordered = entry;
+        }
+
+        write_log_entries(ordered);
+
+        /* Once instructed to terminate, no more entries can be pushed, so an empty queue stays empty. */
+        if (__atomic_load_n(&log_queue.quit, __ATOMIC_ACQUIRE) && __atomic_load_n(&log_queue.entries, __ATOMIC_ACQUIRE) == NULL)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+void *sample_children(void *void_var)
+{
+    int num_children;                   // Number of children in the batch.
+    struct child *child;                // Pointer to current child.
+    struct timespec next_tick;          // Monotonic time of the next sample.
+
+    if (clock_gettime(CLOCK_MONOTONIC, &next_tick) || pthread_mutex_lock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (!sample_batch.quit)
+    {
+        /* Sleep indefinitely while there are no children, otherwise until the next tick. */
+        if (children == NULL)
+        {
+            if (pthread_cond_wait(&sampler_cond, &child_mutex) || clock_gettime(CLOCK_MONOTONIC, &next_tick))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            next_tick.tv_sec++;
+            continue;
+        }
+
+        if (pthread_cond_timedwait(&sampler_cond, &child_mutex, &next_tick) != ETIMEDOUT)
+        {
+            continue;
+        }
+
+        next_tick.tv_sec += SAMPLE_INTERVAL_MS / MS_PER_SECOND;
+
+        /* Take a reference to every child which is still being sampled. */
+        num_children = 0;
+        for (child = children; child != NULL; child = child->next)
+        {
+            if (child->SIGTERM_sent)
+            {
+                continue;
+            }
+
+            if (num_children == sample_batch.capacity)
+            {
+                sample_batch.capacity = sample_batch.capacity ? sample_batch.capacity * 2 : SAMPLER_BATCH_SIZE;
+
+                if ((sample_batch.children = realloc(sample_batch.children, sizeof(struct child *) * sample_batch.capacity)) == NULL || 
+                    (sample_batch.mem_used = realloc(sample_batch.mem_used, sizeof(long int) * sample_batch.capacity)) == NULL)
+                {
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            child->refs++;
+            sample_batch.children[num_children++] = child;
+        }
+
+        if (pthread_mutex_unlock(&child_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        sample_all(num_children);
+
+        /* Commit the whole batch to the children's histories. */
+        if (num_children)
+        {
+            add_mem_samples(num_children);
+        }
+
+        for (int i = 0; i < num_children; i++)
+        {
+            release_child(sample_batch.children[i]);
+        }
+
+        if (pthread_mutex_lock(&child_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pthread_mutex_unlock(&child_mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return NULL;
+}
+
+void sample_all(int num_children)
+{
+    int num_slices; // Number of slices the batch is split into.
+
+    /* Small batches are sampled by the sampler thread alone. */
+    if ((num_slices = (num_children + SAMPLER_BATCH_SIZE - 1) / SAMPLER_BATCH_SIZE) > SAMPLER_THREADS)
+    {
+        num_slices = SAMPLER_THREADS;
+    }
+
+    if (num_slices <= 1)
+    {
+        sample_slice(0, 1, num_children);
+        return;
+    }
+
+    if (pthread_mutex_lock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    sample_batch.num_children = num_children;
+    sample_batch.num_slices = num_slices;
+    sample_batch.num_pending = num_slices - 1;
+    sample_batch.generation++;
+
+    if (pthread_cond_broadcast(&sample_batch.work) || pthread_mutex_unlock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    sample_slice(0, num_slices, num_children);
+
+    if (pthread_mutex_lock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (sample_batch.num_pending)
+    {
+        if (pthread_cond_wait(&sample_batch.done, &sample_batch.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pthread_mutex_unlock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+void sample_slice(int slice, int num_slices, int num_children)
+{
+    int end = (long int)num_children * (slice + 1) / num_slices;    // Index after the last child of the slice.
+
+    for (int i = (long int)num_children * slice / num_slices; i < end; i++)
+    {
+        sample_batch.mem_used[i] = get_mem_used(sample_batch.children[i]);
+    }
+}
+
+void *help_sample(void *void_var)
+{
+    int generation = 0;             // Generation of the last batch sampled.
+    int slice = (long int)void_var; // Index of the slice of each batch sampled by this thread.
+
+    if (pthread_mutex_lock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (TRUE)
+    {
+        while (!sample_batch.quit && (sample_batch.generation == generation || slice >= sample_batch.num_slices))
+        {
+            generation = sample_batch.generation;
+
+            if (pthread_cond_wait(&sample_batch.work, &sample_batch.mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        if (sample_batch.quit)
+        {
+            break;
+        }
+
+        generation = sample_batch.generation;
+
+        if (pthread_mutex_unlock(&sample_batch.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        sample_slice(slice, sample_batch.num_slices, sample_batch.num_children);
+
+        if (pthread_mutex_lock(&sample_batch.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (!--sample_batch.num_pending && pthread_cond_signal(&sample_batch.done))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pthread_mutex_unlock(&sample_batch.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return NULL;
+}
+
+void *admit_jobs(void *void_var)
+{
+    int calm;                               // Indicator that every watched resource is below its threshold.
+    int num_events;                         // Number of events returned by epoll_wait().
+    long int last_check = 0;                // Monotonic time in milliseconds of the last check of the stall times.
+    long int now;                           // Current monotonic time in milliseconds.
+    long int total;                         // Total stall time of the current resource.
+    uint64_t wakeups;                       // Value read from the admission thread's event file descriptor.
+    struct epoll_event events[MAX_EVENTS];  // Events returned by epoll_wait().
+
+    while (!__atomic_load_n(&admission.quit, __ATOMIC_ACQUIRE))
+    {
+        /* Only this thread changes whether launches are held, so it reads it without the mutex. */
+        if ((num_events = epoll_wait(admission.epoll_fd, events, MAX_EVENTS, admission.pressured ? ADMISSION_INTERVAL_MS : ERROR)) == ERROR)
+        {
+            if (errno != EINTR)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            num_events = 0;
+        }
+
+        now = get_time_ms();
+
+        for (int i = 0; i < num_events; i++)
+        {
+            if (events[i].data.ptr == NULL)
+            {
+                if (read(admission.wake_fd, &wakeups, sizeof(wakeups)) == ERROR && errno != EAGAIN)
+                {
+                    exit(EXIT_FAILURE);
+                }
+            }
+            /* A trigger has fired, so launches are held until the stall times show that pressure has dropped. */
+            else if (!admission.pressured)
+            {
+                if (pthread_mutex_lock(&admission.mutex))
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                admission.pressured = TRUE;
+
+                if (pthread_mutex_unlock(&admission.mutex))
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                for (int j = 0; j < NUM_PRESSURES; j++)
+                {
+                    if (admission.fds[j] != ERROR)
+                    {
+                        admission.totals[j] = read_stall(admission.fds[j]);
+                    }
+                }
+
+                last_check = now;
+
+                log_message(NULL, "%s pressure is above its threshold, holding launches", 
+                            admission.names[(int *)events[i].data.ptr - admission.fds]);
+            }
+        }
+
+        if (!admission.pressured || now - last_check < ADMISSION_INTERVAL_MS)
+        {
+            continue;
+        }
+
+        /* The share of the interval some tasks spent stalled is compared with the threshold the trigger was installed with. */
+        calm = TRUE;
+        for (int i = 0; i < NUM_PRESSURES; i++)
+        {
+            if (admission.fds[i] == ERROR)
+            {
+                continue;
+            }
+
+            if ((total = read_stall(admission.fds[i])) - admission.totals[i] >= 
+                admission.thresholds[i] / HUNDRED_PERCENT * (now - last_check) * US_PER_MS)
+            {
+                calm = FALSE;
+            }
+
+            admission.totals[i] = total;
+        }
+
+        last_check = now;
+
+        if (!calm)
+        {
+            continue;
+        }
+
+        if (pthread_mutex_lock(&admission.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        admission.pressured = FALSE;
+
+        if (pthread_mutex_unlock(&admission.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        log_message(NULL, "pressure has dropped, releasing %ld held launches", admission.num_held);
+        release_jobs();
+    }
+
+    return NULL;
+}
+
+void *dispatch_jobs(void *void_var)
+{
+    struct job *job;    // Pointer to the job to launch.
+
+    if (pthread_mutex_lock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (!scheduler.quit)
+    {
+        job = NULL;
+
+        /* Buckets are scanned from the highest class down, so a high priority job waits for no more than the next free slot. */
+        for (int i = 0; i < NUM_PRIORITIES && job == NULL; i++)
+        {
+            if (scheduler.queued[i] != NULL && has_slot(i))
+            {
+                job = scheduler.queued[i];
+
+                if ((scheduler.queued[i] = job->next) == NULL)
+                {
+                    scheduler.last_queued[i] = NULL;
+                }
+
+                scheduler.num_queued--;
+                scheduler.running[i]++;
+                scheduler.running[NUM_PRIORITIES]++;
+            }
+        }
+
+        if (job == NULL)
+        {
+            if (pthread_cond_wait(&scheduler.ready, &scheduler.mutex))
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            continue;
+        }
+
+        /* The launch forks, so it is made without the mutex, which every finishing job takes. */
+        if (pthread_mutex_unlock(&scheduler.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        launch_job(job);
+        free_job(job);
+
+        if (pthread_mutex_lock(&scheduler.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (pthread_mutex_unlock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    return NULL;
+}
+
+void finish_job(int priority)
+{
+    if (!scheduler.enabled)
+    {
+        return;
+    }
+
+    if (pthread_mutex_lock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    scheduler.running[priority]--;
+    scheduler.running[NUM_PRIORITIES]--;
+
+    if (pthread_cond_signal(&scheduler.ready) || pthread_mutex_unlock(&scheduler.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
+}
+
+int parse_limits(char *optarg)
+{
+    char *value;    // Value of the current suboption.
+    int limit;      // Index of the limit named by the current suboption.
+
+    while (*optarg != '\0')
+    {
+        if ((limit = getsubopt(&optarg, scheduler.names, &value)) == ERROR || value == NULL || (scheduler.limits[limit] = atol(value)) <= 0)
+        {
+            return ERROR;
+        }
+    }
+
+    scheduler.enabled = TRUE;
+
+    return 0;
+}
+
+int parse_pressure(char *optarg)
+{
+    char *value;    // Value of the current suboption.
+    int resource;   // Index of the resource named by the current suboption.
+
+    while (*optarg != '\0')
+    {
+        if ((resource = getsubopt(&optarg, admission.names, &value)) == ERROR || value == NULL || 
+            (admission.thresholds[resource] = atof(value)) <= 0 || admission.thresholds[resource] > HUNDRED_PERCENT)
+        {
+            return ERROR;
+        }
+    }
+
+    admission.enabled = TRUE;
+
+    return 0;
+}
+
+long int read_stall(int psi_fd)
+{
+    char buf[PSI_BUF_LEN];  // Buffer of the pressure file.
+    char *total;            // Total field of the "some" line.
+    ssize_t num_bytes;      // Number of bytes read.
+
+    if ((num_bytes = pread(psi_fd, buf, PSI_BUF_LEN - 1, 0)) <= 0)
+    {
+        return ERROR;
+    }
+
+    buf[num_bytes] = '\0';
+
+    /* The file is "some avg10=<a> avg60=<a> avg300=<a> total=<us>\nfull ...", and the first total is that of the "some" line. */
+    if ((total = strstr(buf, "total=")) == NULL)
+    {
+        return ERROR;
+    }
+
+    return strtol(total + strlen("total="), NULL, 10);
+}
+
+void release_jobs()
+{
+    struct job *job;        // Pointer to the current held launch.
+    struct request req;     // Request the current held launch arrived in.
+
+    while (TRUE)
+    {
+        if (pthread_mutex_lock(&admission.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        /* Launches are released one at a time, so that any arriving meanwhile queue behind them. */
+        if ((job = admission.held) != NULL)
+        {
+            if ((admission.held = job->next) == NULL)
+            {
+                admission.last_held = NULL;
+            }
+
+            admission.num_held--;
+        }
+
+        if (pthread_mutex_unlock(&admission.mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (job == NULL)
+        {
+            break;
+        }
+
+        /* A released batch is launched from the admission thread's arena, like a request from a worker's. */
+        if (job->args == NULL)
+        {
+            req.new_fd = ERROR;
+            req.session = job->session;
+            req.id = job->id;
+            req.arena = &admission.arena;
+
+            launch_batch(job->buf, &req);
+            reset_arena(&admission.arena);
+        }
+        else
+        {
+            start_job(job);
+        }
+
+        free_job(job);
+    }
+}
+
+void *supervise_children(void *void_var)
+{
+    int epoll_fd;                           // Epoll file descriptor.
+    int num_adopted;                        // Number of children adopted on the current wakeup.
+    int num_cgroup_events;                  // Number of memory.events files returned by epoll_wait().
+    int num_events;                         // Number of events returned by epoll_wait().
+    int shutting_down = FALSE;              // Indicator that the children are being killed because the overseer is terminating.
+    int sigchld_fd = ERROR;                 // Signal file descriptor for SIGCHLD, used when pidfds are not supported.
+    int timeout;                            // Time in milliseconds until the next timer expires.
+    long int next_expiry;                   // Monotonic time in milliseconds at which the next timer expires.
+    uint64_t wakeups;                       // Value read from the supervisor's event file descriptor.
+    sigset_t mask;                          // Set of signals to be received via the signal file descriptor.
+    struct child *child;                    // Pointer to current child.
+    struct child *next;                     // Pointer to the child following the current child.
+    struct child *tripped;                  // Children the watchdog has asked the supervisor to terminate since the last wakeup.
+    struct epoll_event event;               // Event to register.
+    struct epoll_event events[MAX_EVENTS];  // Events returned by epoll_wait().
+    struct epoll_event cgroup_events[MAX_EVENTS];   // Modified memory.events files returned by epoll_wait().
+    struct signalfd_siginfo info;           // Information about a received signal.
+    struct timer_wheel wheel;               // Timing wheel holding the SIGTERM and SIGKILL deadlines of every child.
+
+    if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    init_timer_wheel(&wheel, get_time_ms());
+
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, supervisor_fd, &event))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* The memory.events files of the children's cgroups are polled through an epoll instance of their own, so that their events can be told 
+     * apart from the children's pidfds. */
+    if (cgroup_tree.root != NULL)
+    {
+        event.events = EPOLLIN;
+        event.data.ptr = &cgroup_tree.epoll_fd;
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, cgroup_tree.epoll_fd, &event))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    /* If the kernel does not support pidfds, fall back to being notified of exits by SIGCHLD. */
+    if ((event.data.fd = open_pidfd(getpid())) == ERROR)
+    {
+        if (sigemptyset(&mask) || sigaddset(&mask, SIGCHLD) || (sigchld_fd = signalfd(ERROR, &mask, SFD_CLOEXEC | SFD_NONBLOCK)) == ERROR)
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        event.events = EPOLLIN;
+        event.data.ptr = &sigchld_fd;
+
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sigchld_fd, &event))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+    else if (close(event.data.fd))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (TRUE)
+    {
+        /* Sleep until an event arrives or the next timer expires, or indefinitely if no timers are pending. */
+        if ((next_expiry = get_next_expiry(&wheel)) == ERROR)
+        {
+            timeout = ERROR;
+        }
+        else if (next_expiry - get_time_ms() > INT_MAX)
+        {
+            timeout = INT_MAX;
+        }
+        else if ((timeout = next_expiry - get_time_ms()) < 0)
+        {
+            timeout = 0;
+        }
+
+        if ((num_events = epoll_wait(epoll_fd, events, MAX_EVENTS, timeout)) == ERROR)
+        {
+            if (errno != EINTR)
+            {
+                exit(EXIT_FAILURE);
+            }
+
+            num_events = 0;
+        }
+
+        for (int i = 0; i < num_events; i++)
+        {
+            /* If a pidfd is readable, its child has terminated. */
+            if (events[i].data.ptr != NULL && events[i].data.ptr != &sigchld_fd && events[i].data.ptr != &cgroup_tree.epoll_fd)
+            {
+                child = events[i].data.ptr;
+
+                if (reap_child(child))
+                {
+                    remove_child(epoll_fd, &wheel, child);
+                }
+            }
+            /* If a memory.events file has been modified, report the events of its child's cgroup. */
+            else if (events[i].data.ptr == &cgroup_tree.epoll_fd)
+            {
+                if ((num_cgroup_events = epoll_wait(cgroup_tree.epoll_fd, cgroup_events, MAX_EVENTS, 0)) == ERROR && errno != EINTR)
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                for (int j = 0; j < num_cgroup_events; j++)
+                {
+                    read_memory_events(cgroup_events[j].data.ptr);
+                }
+            }
+            /* If SIGCHLD has been received, check every child. */
+            else if (events[i].data.ptr == &sigchld_fd)
+            {
+                while (read(sigchld_fd, &info, sizeof(info)) == sizeof(info));
+
+                for (child = children; child != NULL; child = next)
+                {
+                    next = child->next;
+
+                    if (reap_child(child))
+                    {
+                        remove_child(epoll_fd, &wheel, child);
+                    }
+                }
+            }
+            else if (read(supervisor_fd, &wakeups, sizeof(wakeups)) == ERROR && errno != EAGAIN)
+            {
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        /* Adopt children which have been launched since the last wakeup, publishing them to the sampler. */
+        if (pthread_mutex_lock(&child_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (children == NULL && pending_children != NULL && pthread_cond_signal(&sampler_cond))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        num_adopted = 0;
+        while (pending_children != NULL)
+        {
+            child = pending_children;
+            pending_children = child->next;
+
+            child->prev = NULL;
+            child->next = children;
+
+            if (children != NULL)
+            {
+                children->prev = child;
+            }
+
+            children = child;
+            insert_child(child);
+            num_adopted++;
+        }
+
+        tripped = tripped_children;
+        tripped_children = NULL;
+
+        if (pthread_mutex_unlock(&child_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        enforce_watchdog(&wheel, tripped, shutting_down);
+
+        /* The adopted children are at the head of the list. */
+        for (child = children; num_adopted > 0; child = next, num_adopted--)
+        {
+            next = child->next;
+
+            init_timer(&child->SIGTERM_timer, expire_SIGTERM, child);
+            init_timer(&child->SIGKILL_timer, expire_SIGKILL, child);
+
+            /* A child launched as the overseer began terminating missed the children being killed, so it is killed as it is adopted. */
+            if (shutting_down)
+            {
+                if (kill(child->c_pid, SIGKILL))
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                child->SIGKILL_sent = TRUE;
+            }
+            else
+            {
+                add_timer(&wheel, &child->SIGTERM_timer, child->start_time + child->SIGTERM_timeout);
+            }
+
+            /* The kernel signals a modified memory.events file with EPOLLPRI, which stays raised until the file is read again. */
+            if (child->events_fd != ERROR)
+            {
+                event.events = EPOLLPRI;
+                event.data.ptr = child;
+
+                if (epoll_ctl(cgroup_tree.epoll_fd, EPOLL_CTL_ADD, child->events_fd, &event))
+                {
+                    exit(EXIT_FAILURE);
+                }
+            }
+
+            /* Register the child's pidfd, or if pidfds are not supported, check whether it terminated before SIGCHLD could be attributed to it. */
+            if (sigchld_fd == ERROR)
+            {
+                if (child->pidfd == ERROR && (child->pidfd = open_pidfd(child->c_pid)) == ERROR)
+                {
+                    exit(EXIT_FAILURE);
+                }
+
+                event.events = EPOLLIN;
+                event.data.ptr = child;
+
+                if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, child->pidfd, &event))
+                {
+                    exit(EXIT_FAILURE);
+                }
+            }
+            else if (reap_child(child))
+            {
+                remove_child(epoll_fd, &wheel, child);
+            }
+        }
+
+        if (pthread_mutex_lock(&quit_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        /* Once the overseer has been instructed to terminate, kill the children at once and keep reaping them until none remain. */
+        if (quit && !shutting_down)
+        {
+            shutting_down = TRUE;
+
+            for (child = children; child != NULL; child = child->next)
+            {
+                cancel_timer(&wheel, &child->SIGTERM_timer);
+                cancel_timer(&wheel, &child->SIGKILL_timer);
+
+                if (!child->SIGKILL_sent)
+                {
+                    if (kill(child->c_pid, SIGKILL))
+                    {
+                        exit(EXIT_FAILURE);
+                    }
+
+                    child->SIGKILL_sent = TRUE;
+                }
+            }
+        }
+
+        if (pthread_mutex_unlock(&quit_mutex))
+        {
+            exit(EXIT_FAILURE);
+        }
+
+        if (shutting_down && children == NULL)
+        {
+            break;
+        }
+
+        advance_timers(&wheel, get_time_ms());
+    }
+
+    if ((sigchld_fd != ERROR && close(sigchld_fd)) || close(epoll_fd))
     {
         exit(EXIT_FAILURE);
     }
+
+    free(proc_table.slots);
+    free(proc_table.spare);
+
+    return NULL;
 }
 
-void init_threads(pthread_t *p_threads, void *(*handle_requests)(void *))
+void stop_sampler(pthread_t *sampler_threads)
 {
-    if (pthread_mutex_init(&request_mutex, NULL) || pthread_mutex_init(&quit_mutex, NULL) || pthread_mutex_init(&mem_mutex, NULL) || 
-    pthread_cond_init(&got_request, NULL))
+    struct child *child; // Pointer to the current spare child record.
+
+    if (pthread_mutex_lock(&child_mutex) || pthread_mutex_lock(&sample_batch.mutex))
     {
         exit(EXIT_FAILURE);
     }
-        
-    for (int i = 0; i < NUM_THREADS; i++)
+
+    sample_batch.quit = TRUE;
+
+    if (pthread_cond_broadcast(&sample_batch.work) || pthread_mutex_unlock(&sample_batch.mutex) || pthread_cond_signal(&sampler_cond) || 
+        pthread_mutex_unlock(&child_mutex))
     {
-        if (pthread_create(&p_threads[i], NULL, handle_requests, NULL))
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < SAMPLER_THREADS; i++)
+    {
+        if (pthread_join(sampler_threads[i], NULL))
         {
             exit(EXIT_FAILURE);
         }
     }
+
+    free(sample_batch.children);
+    free(sample_batch.mem_used);
+
+    while ((child = spare_children) != NULL)
+    {
+        spare_children = child->next;
+        free(child);
+    }
 }
 
-void kill_all_percent(int *proc_ids, long int *mem_used, double mem_percent) 
+void stop_admission(pthread_t admission_thread)
 {
-    struct sysinfo info; // System information.
+    uint64_t wakeup = 1;        // Value to add to the admission thread's event file descriptor.
+    struct job *job;            // Pointer to the current held launch.
+    struct request req = {};    // Request the current held launch arrived in.
 
-    sysinfo(&info);
+    __atomic_store_n(&admission.quit, TRUE, __ATOMIC_RELEASE);
+
+    if (write(admission.wake_fd, &wakeup, sizeof(wakeup)) == ERROR || pthread_join(admission_thread, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    /* Launches still held are never made, so their controllers are told rather than left waiting. */
+    while ((job = admission.held) != NULL)
+    {
+        admission.held = job->next;
 
-    for (int i = 0; i < NUM_THREADS; i++)
+        req.session = job->session;
+        req.id = job->id;
+        send_reply(&req, MSG_ERROR, "overseer is terminating", strlen("overseer is terminating"));
+        free_job(job);
+    }
+
+    for (int i = 0; i < NUM_PRESSURES; i++)
     {
-        if (proc_ids[i])
+        if (admission.fds[i] != ERROR && close(admission.fds[i]))
         {
-            if (mem_used[i] >= (mem_percent/HUNDRED_PERCENT) * info.totalram)
-            {                    
-                kill(proc_ids[i], SIGKILL);
-            }
+            exit(EXIT_FAILURE);
         }
     }
+
+    if (close(admission.epoll_fd) || close(admission.wake_fd))
+    {
+        exit(EXIT_FAILURE);
+    }
+    free_arena(&admission.arena);
 }
 
-void listen_to(int *sock_fd, int overseer_port)
+void stop_scheduler(pthread_t dispatcher_thread)
 {
-    int opt_enable = TRUE;                  // Value of SO_REUSEADDR.
-    struct sockaddr_in overseer_addr = {};  // Overseer internet address.
+    struct job *job;            // Pointer to the current queued job.
 
-    if ((*sock_fd = socket(AF_INET, SOCK_STREAM, 0)) == ERROR || setsockopt(*sock_fd, SOL_SOCKET, SO_REUSEADDR, &opt_enable, sizeof(opt_enable)) ||
-         setsockopt(*sock_fd, SOL_SOCKET, SO_REUSEPORT, &opt_enable, sizeof(opt_enable)))
+    if (pthread_mutex_lock(&scheduler.mutex))
     {
         exit(EXIT_FAILURE);
     }
 
-    overseer_addr.sin_family = AF_INET;        
-    overseer_addr.sin_port = overseer_port; 
-    overseer_addr.sin_addr.s_addr = INADDR_ANY;
+    scheduler.quit = TRUE;
 
-    if (bind(*sock_fd, (struct sockaddr *)&overseer_addr, sizeof(struct sockaddr)) || listen(*sock_fd, NUM_CONNS))
+    if (pthread_cond_signal(&scheduler.ready) || pthread_mutex_unlock(&scheduler.mutex) || pthread_join(dispatcher_thread, NULL))
     {
         exit(EXIT_FAILURE);
     }
-}
 
-void log_args(int num_args, int use_log_file, FILE *log_fp, char **args)
-{
-    for (int i = 0; i < num_args; i++) 
+    /* Jobs still queued are never launched, so their controllers are told rather than left waiting. */
+    for (int i = 0; i < NUM_PRIORITIES; i++)
     {
-        if (use_log_file)
-        {
-            fprintf(log_fp, " %s", args[i]);
-        }
-        else
+        while ((job = scheduler.queued[i]) != NULL)
         {
-            fprintf(stdout, " %s", args[i]);
+            scheduler.queued[i] = job->next;
+
+            answer_job(job, ERROR, "overseer is terminating");
+            free_job(job);
         }
     }
 }
 
-void log_message(int use_log_file, FILE *log_fp, char *message)
+void stop_reactors()
 {
-    if (use_log_file)
+    struct reactor *reactor; // Current reactor.
+
+    for (int i = 1; i < reactor_pool.num_reactors; i++)
+    {
+        if (pthread_join(reactor_pool.reactors[i].thread, NULL))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    for (int i = 0; i < reactor_pool.num_reactors; i++)
     {
-        fprintf(log_fp, "%s", message);
+        reactor = &reactor_pool.reactors[i];
+
+        close_sessions(reactor);
+
+        if (close(reactor->epoll_fd) || close(reactor->sock_fd))
+        {
+            exit(EXIT_FAILURE);
+        }
     }
-    else
+
+    if (close(reactor_pool.quit_fd))
     {
-        fprintf(stdout, "%s", message); 
+        exit(EXIT_FAILURE);
     }
 }
 
-void manage_child(pid_t c_pid, int SIGTERM_timeout, char *current_time, char **args, char* message, int use_log_file, FILE *log_fp) 
+void stop_threads()
 {
-    int exec_time = 0;          // Time (in terms of quarter-seconds) that the prcoess has been running for.
-    long int mem_used;          // Current memory usage of the process.
-    int SIGTERM_sent = FALSE;   // Indicator that SIGTERM has been sent.
-    int SIGKILL_sent = FALSE;   // Indicator that SIGKILL has been sent.
-    int status;                 // Status of the process.
-    pid_t state_changed;        // Indicator that state of process has changed.
+    struct worker *worker; // Current idle worker.
+
+    if (pthread_mutex_lock(&worker_pool.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
 
-    while(TRUE) 
+    /* Workers check the quit flag under the mutex before idling, so none can start idling once it has been set. */
+    __atomic_store_n(&worker_pool.quit, TRUE, __ATOMIC_RELEASE);
+
+    while ((worker = worker_pool.idle) != NULL)
     {
-        if ((state_changed = waitpid(c_pid, &status, WNOHANG)) == ERROR)
+        worker_pool.idle = worker->next_idle;
+        worker->idle = FALSE;
+        __atomic_sub_fetch(&worker_pool.num_idle, 1, __ATOMIC_SEQ_CST);
+
+        if (pthread_cond_signal(&worker->wake))
         {
             exit(EXIT_FAILURE);
         }
+    }
 
-        /* If the child is running and SIGTERM has not yet been sent. */
-        if (!state_changed && !SIGTERM_sent)
-        {
-            /* If the overseer has been instructed to terminate and SIGKILL has not yet been sent. */
-            if (quit && !SIGKILL_sent)
-            {
-                if (kill(c_pid, SIGKILL))
-                {
-                    exit(EXIT_FAILURE);
-                }
-
-                SIGKILL_sent = TRUE;
-            }
-            /* If it isn't time yet to send SIGTERM. */
-            else if (exec_time < SIGTERM_timeout * TIME_FACTOR) 
-            {
-                exec_time++;
+    if (pthread_mutex_unlock(&worker_pool.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
 
-                /* If a second has passed. */
-                if (!(exec_time % TIME_FACTOR))
-                {
-                    mem_used = get_mem_used(c_pid);
+    for (int i = 0; i < worker_pool.num_workers; i++)
+    {
+        if (pthread_join(worker_pool.workers[i].thread, NULL))
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+}
 
-                    get_time(current_time);
+void stop_capture(pthread_t capture_thread)
+{
+    struct capture *capture;    // Pointer to the current spare capture.
 
-                    add_mem_entry(c_pid, current_time, args, mem_used);
-                }
+    __atomic_store_n(&capture_list.quit, TRUE, __ATOMIC_RELEASE);
 
-                usleep(QUARTER_SECOND_US);
-            }
-            else 
-            {
-                if (kill(c_pid, SIGTERM))
-                {
-                    exit(EXIT_FAILURE);
-                }
+    wake_capture(FALSE);
 
-                SIGTERM_sent = TRUE;
+    if (pthread_join(capture_thread, NULL) || close(capture_list.epoll_fd) || close(capture_list.wake_fd) || close(capture_list.tail_epoll_fd))
+    {
+        exit(EXIT_FAILURE);
+    }
 
-                get_time(current_time);
-                sprintf(message, "%s - sent SIGTERM to %i\n", current_time, c_pid);
-                log_message(use_log_file, log_fp, message);
-            }
-        }
-        else
-        {
-            /* If process terminated normally. */
-            if (WIFEXITED(status))
-            {
-                delete_mem_entries(c_pid);
+    while ((capture = capture_list.spare) != NULL)
+    {
+        capture_list.spare = capture->next;
+        free(capture);
+    }
+}
 
-                status = WEXITSTATUS(status);
+void stop_publisher(pthread_t publisher_thread)
+{
+    struct frame_buf frames = {NULL, 0, 0}; // Buffer holding the final frame of each subscription.
+    struct subscriber *subscriber;          // Pointer to the current subscriber.
 
-                get_time(current_time);
-                sprintf(message, "%s - %i has terminated with status code %i\n", current_time, c_pid, status);
-                log_message(use_log_file, log_fp, message);
+    if (pthread_mutex_lock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
 
-                break;
-            }
-            /* If process received a signal. */
-            else if (WIFSIGNALED(status))
-            {
-                /* If the process was terminated by SIGTERM, SIGKILL or SIGINT. */
-                if (WTERMSIG(status) == SIGTERM || WTERMSIG(status) == SIGKILL || WTERMSIG(status) == SIGINT)
-                {
-                    delete_mem_entries(c_pid);
+    watch_list.quit = TRUE;
 
-                    status = WEXITSTATUS(status);
+    if (pthread_cond_signal(&watch_list.ready) || pthread_mutex_unlock(&watch_list.mutex) || pthread_join(publisher_thread, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
 
-                    get_time(current_time);
-                    sprintf(message, "%s - %i has terminated with status code %i\n", current_time, c_pid, status);
-                    log_message(use_log_file, log_fp, message);
+    /* Subscriptions end with MSG_END, so their controllers can tell the overseer terminated rather than failed. */
+    while ((subscriber = watch_list.subscribers) != NULL)
+    {
+        watch_list.subscribers = subscriber->next;
 
-                    break;
-                }
-                /* If the overseer has been instructed to terminate and SIGKILL has not yet been sent. */
-                else if (quit && !SIGKILL_sent)
-                {
-                    if (kill(c_pid, SIGKILL))
-                    {
-                        exit(EXIT_FAILURE);
-                    }
+        add_frame(&frames, MSG_END, subscriber->id, NULL, 0);
+        send_replies(subscriber->session, &frames);
+        release_session(subscriber->session);
+        free(subscriber);
+    }
 
-                    SIGKILL_sent = TRUE;
-                }
-                /* If it isn't time yet to send SIGKILL. */
-                else if (exec_time < (SIGTERM_timeout + SIGKILL_TIMEOUT) * TIME_FACTOR) 
-                {
-                    exec_time++;
+    free_frames(&frames);
+}
 
-                    usleep(QUARTER_SECOND_US);
-                }
-                /* If SIGKILL hasn't been sent yet. */
-                else if (!SIGKILL_sent) 
-                {
-                    if (kill(c_pid, SIGKILL))
-                    {
-                        exit(EXIT_FAILURE);
-                    }
+void wake_capture(int prune)
+{
+    uint64_t wakeup = 1; // Value to add to the capture thread's event file descriptor.
 
-                    SIGKILL_sent = TRUE;
+    /* The mutex is not taken, as the capture thread may hold it while sending to a tailer. */
+    if (prune)
+    {
+        __atomic_store_n(&capture_list.prune, TRUE, __ATOMIC_RELEASE);
+    }
 
-                    get_time(current_time);
-                    sprintf(message, "%s - sent SIGKILL to %i\n", current_time, c_pid);
-                    log_message(use_log_file, log_fp, message);
-                }
-            }
-        }
+    if (write(capture_list.wake_fd, &wakeup, sizeof(wakeup)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
     }
 }
 
-void redir_stream(int *out_fd, char* out_file, int *stdout_old_fd, int *stderr_old_fd)
+void wake_publisher(int prune)
 {
-    if ((*out_fd = open(out_file, O_APPEND | O_CREAT | O_WRONLY, S_IRWXU | S_IRWXG | S_IRWXO)) == ERROR) 
+    if (pthread_mutex_lock(&watch_list.mutex))
     {
         exit(EXIT_FAILURE);
     }
 
-    *stdout_old_fd = dup(STDOUT_FILENO);
-    dup2(*out_fd, STDOUT_FILENO);
+    watch_list.prune |= prune;
 
-    *stderr_old_fd = dup(STDERR_FILENO);
-    dup2(*out_fd, STDERR_FILENO);
+    if (pthread_cond_signal(&watch_list.ready) || pthread_mutex_unlock(&watch_list.mutex))
+    {
+        exit(EXIT_FAILURE);
+    }
 }
 
-void restore_stream(int stdout_old_fd, int stderr_old_fd)
+void wake_supervisor()
 {
-    dup2(stdout_old_fd, STDOUT_FILENO);
-    close(stdout_old_fd);
+    uint64_t wakeup = 1; // Value to add to the supervisor's event file descriptor.
 
-    dup2(stderr_old_fd, STDERR_FILENO);
-    close(stderr_old_fd);
+    if (write(supervisor_fd, &wakeup, sizeof(wakeup)) == ERROR)
+    {
+        exit(EXIT_FAILURE);
+    }
 }
 
-void send_mem_info_all(pid_t *proc_ids, long int *mem_used, char **proc_args, int new_fd)
+void *accept_connections(void *void_var)
 {
-    char *buf_send = calloc(PATH_MAX, sizeof(char)); // Buffer to send back to controller.
+    run_reactor((struct reactor *)void_var, NULL);
 
-    if (!buf_send)
-    {
-        exit(EXIT_FAILURE);
-    }
+    return NULL;
+}
+
+void *handle_requests(void *void_var)
+{
+    struct request *req;                                // Current request.
+    struct worker *worker = (struct worker *)void_var;  // Worker of the thread.
 
-    for (int i = 0; i < NUM_THREADS; i++)
+    while (!__atomic_load_n(&worker_pool.quit, __ATOMIC_ACQUIRE))
     {
-        if (proc_ids[i])
+        if ((req = get_request(worker)) != NULL)
         {
-            sprintf(buf_send, "%i %li %s\n", proc_ids[i], mem_used[i], proc_args[i]);
-
-            if (send(new_fd, buf_send, PATH_MAX, 0) == ERROR)
-            {
-                exit(EXIT_FAILURE);
-            }
+            req->arena = &worker->arena;
+            exec_request(req);
+            finish_request(req);
+            reset_arena(&worker->arena);
+        }
+        else
+        {
+            wait_for_request(worker);
         }
     }
 
-    free(buf_send);
+    return NULL;
 }
 
-void send_mem_info_id(pid_t proc_id, int new_fd)
+void wait_for_request(struct worker *worker)
 {
-    struct mem_entry* entry; // Pointer to entry in memory report. 
+    struct worker **link; // Pointer to the link to the current idle worker.
 
-    char *buf_send = calloc(PATH_MAX, sizeof(char)); // Buffer to send back to controller.
-
-    if (pthread_mutex_lock(&mem_mutex))
+    if (pthread_mutex_lock(&worker_pool.mutex))
     {
         exit(EXIT_FAILURE);
     }
 
-    entry = mem_report;
-    while (entry != NULL)
+    worker->idle = TRUE;
+    worker->next_idle = worker_pool.idle;
+    worker_pool.idle = worker;
+    __atomic_add_fetch(&worker_pool.num_idle, 1, __ATOMIC_SEQ_CST);
+
+    while (worker->idle && !worker_pool.quit && __atomic_load_n(&worker_pool.num_queued, __ATOMIC_SEQ_CST) == 0)
     {
-        if(entry->proc_id == proc_id)
+        if (pthread_cond_wait(&worker->wake, &worker_pool.mutex))
         {
-            sprintf(buf_send, "%s %li\n", entry->timestamp, entry->mem_used);
-
-            if (send(new_fd, buf_send, PATH_MAX, 0) == ERROR)
-            {
-                exit(EXIT_FAILURE);
-            }
+            exit(EXIT_FAILURE);
         }
+    }
 
-        entry = entry->next;
+    /* A worker which stops idling by itself takes itself off the idle workers. */
+    if (worker->idle)
+    {
+        for (link = &worker_pool.idle; *link != worker; link = &(*link)->next_idle);
+
+        *link = worker->next_idle;
+        worker->idle = FALSE;
+        __atomic_sub_fetch(&worker_pool.num_idle, 1, __ATOMIC_SEQ_CST);
     }
 
-    if (pthread_mutex_unlock(&mem_mutex))
+    if (pthread_mutex_unlock(&worker_pool.mutex))
     {
         exit(EXIT_FAILURE);
     }
-
-    free(buf_send);
 }
 
-void *handle_requests(void *void_var)
+void wake_worker()
 {
-    struct request *req; // Current request.
+    struct worker *worker; // Worker woken.
 
-    if (pthread_mutex_lock(&request_mutex) || pthread_mutex_lock(&quit_mutex))
+    if (pthread_mutex_lock(&worker_pool.mutex))
     {
         exit(EXIT_FAILURE);
     }
 
-    while (!quit)
+    if ((worker = worker_pool.idle) != NULL)
     {
-        if (pthread_mutex_unlock(&quit_mutex))
-        {
-            exit(EXIT_FAILURE);
-        }
+        worker_pool.idle = worker->next_idle;
+        worker->idle = FALSE;
+        __atomic_sub_fetch(&worker_pool.num_idle, 1, __ATOMIC_SEQ_CST);
 
-        if (num_requests > 0)
-        {
-            req = get_request();
-
-            if (req)
-            {
-                if (pthread_mutex_unlock(&request_mutex))
-                {
-                    exit(EXIT_FAILURE);
-                }
-
-                exec_request(req->controller_addr, req->new_fd);
-
-                free(req);
-
-                if (pthread_mutex_lock(&request_mutex))
-                {
-                    exit(EXIT_FAILURE);
-                }
-            }
-        }
-        else if (pthread_cond_wait(&got_request, &request_mutex) || pthread_mutex_lock(&quit_mutex))
+        if (pthread_cond_signal(&worker->wake))
         {
             exit(EXIT_FAILURE);
         }
     }
 
-    if (pthread_mutex_unlock(&quit_mutex) || pthread_mutex_unlock(&request_mutex))
+    if (pthread_mutex_unlock(&worker_pool.mutex))
     {
         exit(EXIT_FAILURE);
     }
-
-    return NULL;
 }
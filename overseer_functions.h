@@ -3,59 +3,475 @@
 #ifndef __OVERSEER_FUNCTIONS_H__
 #define __OVERSEER_FUNCTIONS_H__
 
+/* Include Directives */
+
+#include "protocol_functions.h" // Defines struct frame_buf, which is embedded in an arena.
+
 /* Macro Definitions */
 
 #define _GNU_SOURCE                 // ISO C89, ISO C99, POSIX.1, POSIX.2, BSD, SVID, X/Open, LFS, and GNU extensions.
-#define BUSY_WAIT_SLEEP 100000      // Time in microseconds to sleep, in order to avoid busy-waiting.
+#define ADMISSION_INTERVAL_MS 500   // Time in milliseconds between checks of whether the pressure holding launches has dropped.
+#define ARENA_ALIGN 16              // Alignment of every allocation from an arena, that of malloc().
+#define ARENA_BLOCK_LEN 131072      // Size of the first block of an arena, which holds every buffer of a typical request.
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1)) // Size of an allocation from an arena, once aligned.
+#define BYTES_PER_KB 1024           // Number of bytes in a kilobyte.
+#define CGROUP_BUF_LEN 256          // Size of the buffer used to read a cgroup's memory.current or memory.events file.
+#define CHILD_POOL_LEN 64           // Number of child records allocated by init_supervisor() before any child is launched.
+#define DEFAULT_SIGTERM_TIMEOUT 10000   // Default time in milliseconds before SIGTERM is sent to a child.
+#define EMPTY_SLOT 0                // Process ID marking a slot of the process table which has never been used.
 #define ERROR -1                    // Typical value returned by various functions to indicate error. 
 #define FALSE 0                     // Integer representation of truth-value false.
+#define FIBONACCI_HASH 0x9E3779B97F4A7C15UL // 2^64 divided by the golden ratio, used to scatter process IDs across the process table.
 #define FILE_ARG_INDEX 0            // Index of file path to be executed within array of data received from controller.
 #define HUNDRED_PERCENT 100         // One hundred percent.
 #define IP_STR_LEN 15               // The string length of an IPV4 address.
-#define NUM_ARGS 2                  // Expected number of command line arguments.
-#define NUM_CONNS 10                // Number of pending connections the queue will hold.
-#define NUM_ENDS_PIPE 2             // The number of ends in a pipe (read & write).
-#define NUM_THREADS 5               // The number of request-handling threads to be created.
-#define PIPE_READ 0                 // Index of read end of pipe within pipe array.
-#define PIPE_WRITE 1                // Index of write end of pipe within pipe array.
-#define QUARTER_SECOND_US 250000    // Quarter second in microseconds.
-#define PORT_ARG_INDEX 1            // Index of overseer port within command line arguments.
+#define LOG_BATCH_LEN 512           // Maximum number of log lines written by a single call to writev(), each taking two I/O vectors.
+#define LOG_LINE_LEN (PATH_MAX + 256)   // Capacity of a log entry, which holds any line naming a command; longer lines are truncated.
+#define LOG_POOL_LEN 64             // Number of log entries allocated by init_logger() before any line is logged.
+#define MAPS_BUF_LEN 4096           // Size of the buffer used to read a maps file.
+#define MEM_HIGH_PERCENT 90         // Percentage of a job's memory limit at which the kernel starts throttling it (memory.high).
+#define MEM_HISTORY_LEN 1024        // Number of samples retained in the memory history of each child.
+#define MAX_EVENTS 64               // Maximum number of epoll events to be returned by a single call to epoll_wait().
+#define MAX_REACTORS 64             // Maximum number of reactor threads accepted by -a, and the default limit of one per core.
+#define MAX_WORKERS 1024            // Maximum number of request-handling threads accepted by -w.
+#define MAX_NODES 64                // Maximum number of memory nodes told apart by the placement engine, the bits of a node mask.
+#define MS_PER_SECOND 1000          // Number of milliseconds in a second.
+#define NS_PER_MS 1000000           // Number of nanoseconds in a millisecond.
+#define NUM_ARGS 1                  // Expected number of positional command line arguments.
+#define NUM_MEM_SAMPLERS 3          // Number of memory sampler backends.
+#define NUM_PRESSURES 2             // Number of pressure stall information files the admission controller can subscribe to.
+#define NUM_PRIORITIES 3            // Number of priority classes of the scheduler.
+#define NUM_THREADS 5               // Default number of request-handling threads to be created, changed with -w.
+#define PRIORITY_HIGH 0             // Priority class of jobs which are started first.
+#define PRIORITY_LOW 2              // Priority class of jobs which are started only when no other job is waiting for a slot.
+#define PRIORITY_NORMAL 1           // Priority class of jobs which do not request one.
+#define PROC_TABLE_MIN_SLOTS 64     // Initial number of slots in the process table.
+#define PSI_BUF_LEN 256             // Size of the buffer used to read a pressure stall information file.
+#define PSI_WINDOW_US 2000000       // Time window in microseconds of a pressure trigger, the shortest an unprivileged process may use.
+#define REPLY_BUF_LEN 256           // Size of the largest reply payload encoded on the stack when its request has no arena.
+#define REQUEST_PAYLOAD_LEN 256     // Initial capacity of the payload buffer of a request record, which holds a typical command.
+#define REQUEST_POOL_LEN SESSION_MAX_REQUESTS   // Number of request records allocated by each reactor before it accepts, a session's worth.
+#define US_PER_MS 1000              // Number of microseconds in a millisecond.
+#define ROTATED_SUFFIX ".1"         // Suffix appended to the file path of a rotated output file.
+#define SESSION_BUF_LEN (FRAME_HEADER_LEN + PATH_MAX) // Size of the buffer a session's frames are received into, which holds any valid frame.
+#define SAMPLE_INTERVAL_MS 1000     // Time in milliseconds between memory usage samples of a child.
+#define SMAPS_ROLLUP_BUF_LEN 2048   // Size of the buffer used to read a smaps_rollup file.
+#define STATM_BUF_LEN 128           // Size of the buffer used to read a statm file.
+#define TAIL_DRAIN_MS 5000          // Time in milliseconds tailers are still sent the output they hold once the overseer terminates.
+#define TAIL_PIPE_LEN 1048576       // Capacity requested for the pipe buffering the output of a tailed child for one tailer.
+#define SAMPLER_BATCH_SIZE 256      // Number of children sampled per sampler thread before the batch is split across further threads.
+#define SAMPLER_THREADS 4           // Maximum number of threads sampling a batch, including the sampler thread itself.
 #define SIGKILL_TIMEOUT 5           // The amount of time before SIGKILL is sent to a running child process which has already received SIGTERM.
-#define STDOUT_STDERR 2             // Option for redir_stream() to indicate both stdout and stderr should be redirected to the provided file.
-#define TIME_FACTOR 4               // Factor to represent time in half-seconds.
+#define TOMBSTONE -1                // Process ID marking a slot of the process table whose child has been deleted.
 #define TIME_STR_LEN 28             // The string length of a timestamp.
 #define TRUE 1                      // Integer representation of truth-value true.
+#define WHEEL_BITS 6                // Number of bits of a timer's expiry time used to index the slots of each level of the timing wheel.
+#define WATCH_BUF_LEN 256           // Number of events buffered for a subscriber before the oldest are dropped.
+#define WHEEL_LEVELS 6              // Number of levels of the timing wheel (covering 2^36 milliseconds).
+#define WHEEL_MASK 63               // Mask selecting a slot index within a level of the timing wheel.
+#define WHEEL_SLOTS 64              // Number of slots in each level of the timing wheel.
 
 /* Structure Definitions */
 
+struct frame_header;
+struct reactor;
+
+struct arena_block // Structure describing a block of memory allocated from by an arena, followed by its data.
+{
+    struct arena_block *next;   // Pointer to the block filled before this one.
+    size_t len;                 // Number of bytes of data of the block.
+};
+
+struct arena // Structure describing a bump allocator whose allocations are all freed at once, and a frame buffer reused with it.
+{
+    struct arena_block *blocks; // Pointer to the block being allocated from, followed by those filled since the last reset.
+    size_t used;                // Number of bytes allocated from the current block.
+    size_t total;               // Number of bytes allocated since the last reset.
+    struct frame_buf frames;    // Buffer of the frames of the replies being built, whose capacity is kept across resets.
+};
+
+struct session // Structure describing a connection from a controller which speaks the framed protocol, owned by the reactor which accepted it.
+{
+    int fd;                     // File descriptor for the socket of the session.
+    int epoll_fd;               // Epoll file descriptor the session is registered with.
+    struct reactor *reactor;    // Reactor which accepted the connection and reads from it.
+    int framed;                 // Indicator of if the controller speaks the framed protocol, or ERROR until its first bytes arrive.
+    char *buf;                  // Buffer of received bytes not yet forming a complete frame.
+    size_t len;                 // Number of bytes in buf.
+    int refs;                   // Number of references held by the reactor and queued requests.
+    int num_requests;           // Number of requests in flight.
+    int paused;                 // Indicator that reading has been paused until requests in flight have been answered.
+    int reading;                // Indicator that the reactor is still reading from the session.
+    int broken;                 // Indicator that sending to the session has failed.
+    pthread_mutex_t mutex;      // Mutex for the reference count, requests in flight and reading state.
+    pthread_mutex_t send_mutex; // Mutex serialising the replies sent to the session.
+    struct tailer *sending;     // Pointer to the tailer part way through a frame, which nothing else may be sent until it finishes, or NULL.
+    pthread_cond_t sent;        // Condition variable signalled when a tailer finishes the frame it was part way through.
+    int num_waiting;            // Number of writers waiting for a tailer to finish its frame, before which it starts no other.
+    struct session *prev;       // Pointer to previous session.
+    struct session *next;       // Pointer to next session.
+};
+
 struct request // Structure describing a single controller request.
 {
-    struct sockaddr_in controller_addr; // Internet socket address of current request's controller.
-    int new_fd;                         // File descriptor for the socket of current request.  
-    struct request *next;               // Pointer to next request.
+    int new_fd;                 // File descriptor for the socket of current request.  
+    struct session *session;    // Session the request arrived on, or NULL for a legacy controller's connection.
+    uint32_t id;                // Identifier of the request within its session.
+    int type;                   // Type of the request (MSG_*).
+    char *payload;              // NUL-terminated payload of the request.
+    int len;                    // Length of the payload.
+    size_t cap;                 // Capacity of the payload buffer, which is kept when the record is recycled.
+    struct arena *arena;        // Arena of the thread executing the request, reset once it has been executed, or NULL if there is none.
+    struct request *next;       // Pointer to next request.
+};
+
+struct worker // Structure describing a request-handling thread and the queue of requests handed to it.
+{
+    pthread_t thread;               // Thread identifier.
+    int index;                      // Index of the worker in the pool.
+    struct request *requests;       // Pointer to the first request of the queue.
+    struct request *last_request;   // Pointer to the last request of the queue.
+    pthread_mutex_t mutex;          // Mutex for the queue.
+    pthread_cond_t wake;            // Condition variable signalled when the worker is taken off the idle workers.
+    int idle;                       // Indicator that the worker is on the idle workers.
+    struct worker *next_idle;       // Pointer to next idle worker.
+    struct arena arena;             // Arena of the requests executed by the worker.
+};
+
+struct worker_pool // Structure describing the request-handling threads and the request records they recycle.
+{
+    int num_workers;                // Number of workers.
+    struct worker *workers;         // Array of workers.
+    long int num_queued;            // Number of queued requests, changed without locking.
+    int num_idle;                   // Number of idle workers, changed under the mutex but read without locking.
+    int quit;                       // Indicates whether the workers are to terminate.
+    struct worker *idle;            // Pointer to the most recently idle worker.
+    pthread_mutex_t mutex;          // Mutex for the idle workers.
+    struct request *free_requests;  // Pointer to the most recently finished request record, pushed without locking.
+};
+
+struct reactor // Structure describing a thread which accepts connections on its own listening socket and reads from the sessions it opened.
+{
+    pthread_t thread;               // Thread identifier, unused for the first reactor, which runs on the main thread.
+    int epoll_fd;                   // Epoll file descriptor of the reactor.
+    int sock_fd;                    // Listening socket, one of several bound to the port with SO_REUSEPORT so the kernel shares out connections.
+    int next_worker;                // Index of the worker the reactor queues its next request on.
+    struct session *sessions;       // Pointer to first session of linked list owned by the reactor.
+    struct request *spare_requests; // Pointer to the first request record taken by the reactor for reuse.
+};
+
+struct reactor_pool // Structure describing the reactor threads.
+{
+    int num_reactors;               // Number of reactors, or 0 until main() defaults it to one per core the overseer may use.
+    int backlog;                    // Number of pending connections the queue of each listening socket will hold.
+    int quit_fd;                    // Event file descriptor signalled by the first reactor on SIGINT, which stops every other reactor.
+    struct reactor *reactors;       // Array of reactors.
+};
+
+struct mem_sample // Structure describing a single memory usage sample.
+{
+    time_t time;        // System time at which the sample was taken.
+    long int mem_used;  // Process' memory usage (bytes).
+};
+
+struct mem_sampler // Structure describing a memory sampler backend.
+{
+    char *name;                     // Name used to select the backend.
+    char *proc_file;                // Format of the path of the process file read by the backend.
+    long int (*sample)(int mem_fd); // Function which parses the process file into the process' memory usage (bytes).
+};
+
+struct timer_wheel;
+
+struct timer // Structure describing a single deadline held in the timing wheel.
+{
+    long int expires;                                           // Monotonic time in milliseconds at which the timer expires.
+    int pending;                                                // Indicator that the timer is in the timing wheel.
+    int level;                                                  // Level of the slot holding the timer.
+    int slot;                                                   // Index of the slot holding the timer.
+    void (*expire)(struct timer_wheel *wheel, struct timer *);  // Function called when the timer expires.
+    void *data;                                                 // Data passed to expire() through the timer.
+    struct timer *prev;                                         // Pointer to previous timer in the slot.
+    struct timer *next;                                         // Pointer to next timer in the slot.
+};
+
+struct timer_wheel // Structure describing a hierarchical timing wheel with millisecond resolution.
+{
+    long int now;                                       // Monotonic time in milliseconds of the next slot to be processed.
+    int num_timers;                                     // Number of pending timers.
+    uint64_t occupied[WHEEL_LEVELS];                    // Bitmaps of the non-empty slots of each level.
+    struct timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];     // Lists of timers in each slot of each level.
+};
+
+struct child // Structure describing a single child process owned by the supervisor.
+{
+    pid_t c_pid;            // Process ID of child.
+    int mem_fd;             // File descriptor of the process file read by the memory sampler, kept open between samples (ERROR if not open).
+    int pidfd;              // File descriptor referring to the child, which becomes readable when it terminates (ERROR if not used).
+    struct mem_sampler *mem_sampler;    // Memory sampler backend reading mem_fd.
+    char cgroup[FILENAME_MAX];  // Path of the child's cgroup, or empty if it was not placed in one.
+    cpu_set_t cpus;         // Cores dedicated to the child, or none if it is not pinned.
+    int events_fd;          // File descriptor of the memory.events file of the child's cgroup (ERROR if not open).
+    long int num_high;      // Number of times the child's cgroup has been throttled for exceeding memory.high, as last read.
+    long int num_oom_kills; // Number of processes of the child's cgroup killed for exceeding memory.max, as last read.
+    double watchdog_percent;        // Memory percentage threshold of the child's own watchdog policy, or 0 to follow the global policy.
+    long int watchdog_grace;        // Time in milliseconds the child may stay above its own threshold before it is terminated.
+    long int num_actions;           // Number of signals sent to the child by the watchdog.
+    long int over_since;            // Monotonic time in milliseconds since which the child's samples have been above its threshold, or 0.
+    int tripped;                    // Indicator that the watchdog has asked the supervisor to terminate the child.
+    struct child *next_tripped;     // Pointer to next child the watchdog has asked the supervisor to terminate.
+    long int SIGTERM_timeout;       // Time in milliseconds before SIGTERM is sent to child.
+    int priority;                   // Priority class of the child, whose slot is given back when it is removed.
+    long int start_time;            // Monotonic time in milliseconds at which the child was launched.
+    int SIGTERM_sent;               // Indicator that SIGTERM has been sent, written under child_mutex as the sampler reads it.
+    int SIGKILL_sent;               // Indicator that SIGKILL has been sent.
+    int refs;                       // Number of references held to the record (by the supervisor and the sampler).
+    struct timer SIGTERM_timer;     // Timer for the SIGTERM deadline.
+    struct timer SIGKILL_timer;     // Timer for the SIGKILL deadline.
+    unsigned long int seq;          // Sequence count of the history, odd while the sampler is writing to it.
+    unsigned long int num_samples;  // Number of samples ever taken of the child.
+    struct mem_sample history[MEM_HISTORY_LEN]; // Ring buffer of the most recent samples.
+    char args[PATH_MAX];    // File and arguments of child, concatenated.
+    struct log_file *log_fp;    // Logging redirection file, or NULL for stdout.
+    struct child *prev;     // Pointer to previous child.
+    struct child *next;     // Pointer to next child.
+};
+
+struct watch_event // Structure describing a single process event awaiting delivery to a subscriber.
+{
+    int kind;           // Kind of the event (EVENT_*).
+    pid_t c_pid;        // Process ID of the child the event concerns.
+    time_t time;        // System time of the event.
+    long int value;     // Memory usage for a sample, or exit status for an exit.
+};
+
+struct subscriber // Structure describing a controller subscribed to the events of one or every child.
+{
+    struct session *session;                    // Session the subscription arrived on, of which the subscriber holds a reference.
+    uint32_t id;                                // Identifier of the subscribing request, which tags every event.
+    pid_t c_pid;                                // Process ID of the child watched, or 0 for every child.
+    struct watch_event events[WATCH_BUF_LEN];   // Ring buffer of undelivered events.
+    int head;                                   // Index of the oldest undelivered event.
+    int num_events;                             // Number of undelivered events.
+    long int num_dropped;                       // Number of events dropped because the buffer was full since the last delivery.
+    struct subscriber *next;                    // Pointer to the next subscriber.
+};
+
+struct watch_list // Structure describing the subscriptions to child events and the thread delivering them.
+{
+    struct subscriber *subscribers; // Pointer to the first subscriber.
+    int num_pending;                // Number of subscribers with events to deliver.
+    int prune;                      // Indicates whether a session has closed, so its subscribers are to be removed.
+    int quit;                       // Indicates whether the publisher thread is to terminate.
+    pthread_mutex_t mutex;          // Mutex for the subscribers and their buffers.
+    pthread_cond_t ready;           // Condition variable signalled when there is work for the publisher thread.
+};
+
+struct proc_slot // Structure describing a single slot of the process table.
+{
+    pid_t c_pid;            // Process ID of the child, EMPTY_SLOT or TOMBSTONE.
+    struct child *child;    // Pointer to the child.
+};
+
+struct proc_table // Structure describing an open-addressing hash table of children keyed by process ID.
+{
+    struct proc_slot *slots;    // Slots of the table.
+    long int capacity;          // Number of slots, always a power of two.
+    long int num_children;      // Number of slots holding a child.
+    long int num_used;          // Number of slots holding a child or a tombstone.
+    struct proc_slot *spare;    // Slots of the same capacity, into which the table is rehashed to clear its tombstones, or NULL.
+};
+
+struct sample_batch // Structure describing the batch of children sampled on each tick by the sampler threads.
+{
+    struct child **children;    // Children being sampled.
+    long int *mem_used;         // Memory usage sampled for each child.
+    int capacity;               // Capacity of the children and mem_used arrays.
+    int num_children;           // Number of children in the batch.
+    int num_slices;             // Number of slices the batch is split into.
+    int num_pending;            // Number of helper threads yet to finish sampling their slice.
+    int generation;             // Number of batches handed to the helper threads.
+    int quit;                   // Indicates whether the sampler threads are to terminate.
+    pthread_mutex_t mutex;      // Mutex for the batch variables shared with the helper threads.
+    pthread_cond_t work;        // Condition variable signalled when a batch is handed to the helper threads.
+    pthread_cond_t done;        // Condition variable signalled when the helper threads have finished a batch.
+};
+
+struct log_file // Structure describing a logging redirection file, opened once however many children log to it.
+{
+    char path[PATH_MAX];    // File path the file was opened with.
+    int fd;                 // File descriptor of the file.
+    int refs;               // Number of references held by children and queued log lines.
+    struct log_file *next;  // Pointer to the next open log file.
+};
+
+struct log_entry // Structure describing a single line queued for the log writer.
+{
+    struct log_file *log_fp;    // Logging redirection file to write the line to, or NULL for stdout.
+    time_t time;                // System time at which the line was logged.
+    int release;                // Indicator that the reference to log_fp is dropped once the line has been written.
+    size_t len;                 // Length of the text.
+    char stamp[TIME_STR_LEN];   // Timestamp prefixed to the text by the log writer.
+    struct log_entry *next;     // Pointer to the next line.
+    char text[LOG_LINE_LEN];    // Text of the line, without the timestamp.
 };
 
-struct mem_entry // Structure describing a single memory report entry.
+struct log_queue // Structure describing the lines queued by every thread and the thread writing them.
 {
-    pid_t proc_id;          // Process ID of entry.
-    char *timestamp;        // Timestamp of entry.
-    char *args;             // Process' file and arguments.
-    long int mem_used;      // Process' current memory usage (bytes).                 
-    struct mem_entry *next; // Pointer to next entry.          
+    struct log_entry *entries;  // Pointer to the most recently queued line, pushed without locking.
+    int wake_fd;                // Event file descriptor used to wake the log writer when the queue stops being empty.
+    int quit;                   // Indicates whether the log writer is to terminate once the queue is empty.
+    struct log_file *files;     // Pointer to the first open logging redirection file.
+    struct log_entry *spare_entries;    // Pointer to the first written entry kept for reuse.
+    struct log_file *spare_files;       // Pointer to the first closed logging redirection file kept for reuse.
+    pthread_mutex_t mutex;      // Mutex for the open logging redirection files and the spare entries and files.
+};
+
+struct tailer // Structure describing a controller streaming the output of a captured child.
+{
+    struct session *session;    // Session the tail request arrived on, of which the tailer holds a reference.
+    uint32_t id;                // Identifier of the tail request, which tags every frame of output.
+    pid_t c_pid;                // Process ID of the tailed child.
+    int pipe_fds[2];            // Pipe holding the output duplicated for the tailer which has not yet been sent.
+    size_t len;                 // Number of bytes in the pipe.
+    long int num_dropped;       // Number of bytes dropped because the pipe was full since the last delivery.
+    char frame[FRAME_HEADER_LEN + EVENT_LEN]; // Encoded header of the output frame being sent, or an encoded frame without output.
+    size_t frame_len;           // Number of bytes encoded in frame.
+    size_t frame_sent;          // Number of bytes of frame sent.
+    size_t output_left;         // Number of bytes of output of the current frame still to be spliced from the pipe.
+    int ending;                 // Indicator that the child's output has all been moved, so MSG_END is sent after the rest of it.
+    int ended;                  // Indicator that MSG_END has been encoded in frame.
+    int sock_fd;                // Duplicate of the session's socket, registered with the tailers' epoll instance while waiting for room.
+    int waiting;                // Indicator that the tailer holds output the socket has not had room for.
+    struct tailer *next;        // Pointer to the next tailer of the same child, or of the tailers draining.
+};
+
+struct capture // Structure describing the output of a child captured through a pipe, owned by the capture thread.
+{
+    pid_t c_pid;                // Process ID of the child.
+    int pipe_fd;                // Read end of the pipe the child's stdout and stderr are redirected onto.
+    int out_fd;                 // File descriptor of the output file.
+    char out_file[PATH_MAX];    // File path of the output file.
+    off_t out_len;              // Length of the output file, at which the next output is written.
+    struct tailer *tailers;     // Pointer to the first tailer of the child.
+    struct capture *next;       // Pointer to the next capture.
+};
+
+struct capture_list // Structure describing the captured children and the thread moving their output.
+{
+    int enabled;                // Indicator of if the output of children with an output file is captured.
+    long int rotate_len;        // Length in bytes beyond which an output file is rotated, or 0 if it never is.
+    struct capture *captures;   // Pointer to the first capture.
+    struct capture *spare;      // Pointer to the first finished capture kept for reuse.
+    int epoll_fd;               // Epoll file descriptor the pipes of the captures are registered with.
+    int wake_fd;                // Event file descriptor used to wake the capture thread.
+    int tail_epoll_fd;          // Epoll file descriptor the sockets of tailers waiting for room are registered with.
+    struct tailer *draining;    // Pointer to the first tailer of a finished capture still to send the rest of its output.
+    int prune;                  // Indicates whether a session has closed, so its tailers are to be removed.
+    int quit;                   // Indicates whether the capture thread is to terminate.
+    pthread_mutex_t mutex;      // Mutex for the captures, their tailers and the spare captures.
+};
+
+struct cgroup_tree // Structure describing the delegated cgroup v2 subtree in which each job is given a cgroup of its own.
+{
+    char *root;     // Path of the root of the subtree, or NULL if jobs are not placed in cgroups.
+    int epoll_fd;   // Epoll file descriptor the memory.events files of the jobs' cgroups are registered with, polled by the supervisor.
+};
+
+struct watchdog // Structure describing the global watchdog policy, which terminates children whose samples stay above a memory threshold.
+{
+    double percent;         // Memory percentage threshold, or 0 if the policy is not installed.
+    long int grace;         // Time in milliseconds a child may stay above the threshold before it is terminated.
+    long int num_actions;   // Number of signals sent by the watchdog, under any policy.
+    pthread_mutex_t mutex;  // Mutex for the global and per-child policies and action counts.
+};
+
+struct job // Structure describing a launch on its way from a request to the supervisor, which may be held or queued.
+{
+    char *buf;                  // Received command, or the batch of jobs if args is NULL.
+    char **args;                // Array of strings holding the executable file path and its arguments, pointing into buf if it is set.
+    char *out_file;             // File path of child output redirection file.
+    char *log_file;             // File path of logging redirection file.
+    long int SIGTERM_timeout;   // Time in milliseconds before SIGTERM is sent to child.
+    long int mem_limit;         // Memory limit of the child's cgroup in bytes, or 0 for none.
+    int priority;               // Priority class of the job (PRIORITY_*).
+    int num_cpus;               // Number of cores to dedicate to the job, or 0 if it is not pinned.
+    struct session *session;    // Session the launch is answered on, or NULL if no answer is due.
+    uint32_t id;                // Identifier of the request within its session.
+    int index;                  // Index of the job within its batch, or ERROR if it is a launch of its own or a whole batch.
+    struct arena arena;         // Arena holding a job kept by keep_job() and its buffers, or empty for a job of a request.
+    struct job *next;           // Pointer to next job of the same queue.
+};
+
+struct admission // Structure describing the admission controller, which holds launches while memory or CPU pressure is above its threshold.
+{
+    char *names[NUM_PRESSURES + 1];     // Names of the resources, as accepted by -p, followed by NULL.
+    char *files[NUM_PRESSURES];         // Paths of the pressure stall information files of the resources.
+    double thresholds[NUM_PRESSURES];   // Percentage of time some tasks may stall on each resource, or 0 if it is not watched.
+    int fds[NUM_PRESSURES];             // File descriptors of the pressure files, with a trigger installed (ERROR if not watched).
+    long int totals[NUM_PRESSURES];     // Total stall time in microseconds of each resource, as last read.
+    int enabled;                        // Indicator of if launches are subject to admission control.
+    int epoll_fd;                       // Epoll file descriptor the triggers and wake_fd are registered with.
+    int wake_fd;                        // Event file descriptor used to wake the admission thread.
+    int pressured;                      // Indicates whether pressure is above a threshold, so launches are held.
+    int quit;                           // Indicates whether the admission thread is to terminate.
+    long int num_held;                  // Number of launches held.
+    struct arena arena;                 // Arena of the batches released by the admission thread.
+    struct job *held;                   // Pointer to the first held launch.
+    struct job *last_held;              // Pointer to the last held launch.
+    pthread_mutex_t mutex;              // Mutex for the pressured state and the held launches.
+};
+
+struct placement // Structure describing the cores jobs may be pinned to, the memory node of each and which are dedicated to a job.
+{
+    cpu_set_t allowed;          // Cores the overseer may run on.
+    cpu_set_t used;             // Cores dedicated to running jobs.
+    int nodes[CPU_SETSIZE];     // Memory node of each allowed core.
+    int num_cpus;               // Number of allowed cores.
+    int num_nodes;              // Number of memory nodes, up to the highest holding an allowed core.
+    pthread_mutex_t mutex;      // Mutex for the dedicated cores.
+};
+
+struct scheduler // Structure describing the scheduler, which queues launches by priority class while concurrency limits are reached.
+{
+    char *names[NUM_PRIORITIES + 2];        // Names of the priority classes, then "max" for the global limit, followed by NULL, as accepted by -j.
+    long int limits[NUM_PRIORITIES + 1];    // Maximum number of running jobs of each class, then of all classes, or 0 if unlimited.
+    long int running[NUM_PRIORITIES + 1];   // Number of running jobs of each class, then of all classes.
+    struct job *queued[NUM_PRIORITIES];     // Pointers to the first queued job of each class.
+    struct job *last_queued[NUM_PRIORITIES];    // Pointers to the last queued job of each class.
+    long int num_queued;                    // Number of queued jobs.
+    int enabled;                            // Indicator of if launches are subject to concurrency limits.
+    int quit;                               // Indicates whether the dispatcher thread is to terminate.
+    pthread_mutex_t mutex;                  // Mutex for the counts and queues.
+    pthread_cond_t ready;                   // Condition variable signalled when a running job has finished or the dispatcher is to terminate.
 };
 
 /* Global Variables */
 
-extern int num_requests;                // Number of currently pending requests.
+extern int supervisor_fd;               // Event file descriptor used to wake the supervisor.
 extern int quit;                        // Indicates whether the program is to continue executing or not. 
-extern pthread_cond_t got_request;      // Program condition variable.
-extern pthread_mutex_t mem_mutex;       // Mutex for memory variables.
+extern pthread_cond_t sampler_cond;     // Condition variable used to wake the sampler.
+extern pthread_mutex_t child_mutex;     // Mutex for the lists and table of children and their reference counts.
 extern pthread_mutex_t quit_mutex;      // Mutex for quit variable.   
-extern pthread_mutex_t request_mutex;   // Mutex for request variables.  
-struct mem_entry *last_entry;           // Pointer to last report entry of linked list.
-struct mem_entry *mem_report;           // Pointer to first report entry of linked list.
-struct request *last_request;           // Pointer to last request of linked list. 
-struct request *requests;               // Pointer to first request of linked list.
+extern struct mem_sampler mem_samplers[NUM_MEM_SAMPLERS];  // Memory sampler backends.
+extern struct mem_sampler *mem_sampler;                     // Memory sampler backend in use.
+extern struct mem_sampler cgroup_sampler;                   // Memory sampler backend reading the memory.current file of a job's cgroup.
+extern struct cgroup_tree cgroup_tree;                      // Subtree the jobs' cgroups are created in.
+extern struct proc_table proc_table;                        // Table of the children owned by the supervisor, keyed by process ID.
+extern struct sample_batch sample_batch;                    // Batch of children being sampled.
+extern struct watch_list watch_list;                        // Subscriptions to child events.
+extern struct log_queue log_queue;                          // Log lines awaiting the log writer.
+extern struct capture_list capture_list;                    // Children whose output is captured.
+extern struct watchdog watchdog;                            // Global watchdog policy.
+extern struct admission admission;                          // Admission controller gating launches on pressure.
+extern struct placement placement;                          // Placement engine dedicating cores and memory nodes to jobs.
+extern struct scheduler scheduler;                          // Scheduler enforcing concurrency limits by priority class.
+extern struct worker_pool worker_pool;                      // Request-handling threads.
+extern struct reactor_pool reactor_pool;                    // Threads accepting connections and reading sessions.
+extern struct child *children;          // Pointer to first child of linked list owned by the supervisor.
+extern struct child *pending_children;  // Pointer to first child of linked list awaiting adoption by the supervisor.
+extern struct child *spare_children;    // Pointer to first record of linked list kept for reuse once its child has been freed.
+extern struct child *tripped_children;  // Pointer to first child of linked list the watchdog has asked the supervisor to terminate.
 
 /* Function Declarations */
 
@@ -73,264 +489,1852 @@ int accept_conn(int sock_fd, struct sockaddr_in *controller_addr);
 /*
  * Function split_args(): Split up the received string of arguments.
  * 
- * Algorithm: Split the string of received arguments using the space delimiter, check the for flags and commands, and assign to the appropriate variables. 
+ * Algorithm: Split the string with next_token(), so that quoted and escaped arguments are honoured and nothing is copied or allocated. Read 
+ * a mem or memkill command and its argument, then the flags, in any order, up to the first token which is not a flag or up to "--", then 
+ * the file and its arguments.
+ * 
+ * Input: Buffer of received arguments, which is modified (buf), pointers to receive the file paths of the child output and logging 
+ * redirection files, which point into the buffer and are left unchanged if the flag is not given (out_file, log_file), time in milliseconds 
+ * before SIGTERM is sent to child (SIGTERM_timeout), memory limit of the child in bytes (mem_limit), priority class of the child, set to 
+ * ERROR for an unknown class (priority), number of cores to dedicate to the child (num_cpus), indicator of if memory information is to be sent 
+ * back to the controller (show_mem_info), the ID of the process for memory information to be sent back (proc_id), indicator of if processes 
+ * above a certain percentage memory usage should be killed (kill_mem_percent), percentage of memory usage used to kill processes 
+ * (mem_percent), array of strings to receive the executable file and its arguments, which is NULL-terminated (args).
+ * 
+ * Output: The number of arguments (including the file) in args, or ERROR if a quote is not closed.
+ */
+int split_args(char *buf, char **out_file, char **log_file, long int *SIGTERM_timeout, long int *mem_limit, int *priority, int *num_cpus, 
+               int *show_mem_info, int *proc_id, int *kill_mem_percent, double *mem_percent, char **args);
+
+/*
+ * Function recv_request(): Receive a request from a controller.
+ * 
+ * Algorithm: For a legacy controller, receive the padded text command, up to PATH_MAX bytes or the end of the connection. For a request from a 
+ * session, a MSG_EXEC payload is the text command and a MSG_SUBMIT payload is the batch of jobs, while MSG_MEM, MSG_MEMKILL, MSG_WATCH 
+ * and MSG_TAIL are decoded directly and a MSG_WATCHDOG payload is only checked for length, being decoded by its handler; malformed requests 
+ * and unknown types are answered with MSG_ERROR.
+ * 
+ * Input: Request (req), buffer of PATH_MAX bytes to receive the command (buf_recv), the request variables set by split_args() 
+ * (show_mem_info, proc_id, kill_mem_percent, mem_percent), indicator of if buf_recv holds a batch of jobs (submit_batch), indicator of if 
+ * the controller is subscribing to the events of proc_id (watch), indicator of if the controller is tailing the output of proc_id (tail) 
+ * and indicator of if the request concerns the watchdog (watchdog).
+ * 
+ * Output: TRUE if buf_recv holds a command to be split, FALSE if the request has been decoded, or ERROR if the request was rejected.
+ */
+int recv_request(struct request *req, char *buf_recv, int *show_mem_info, pid_t *proc_id, int *kill_mem_percent, double *mem_percent, 
+                 int *submit_batch, int *watch, int *tail, int *watchdog);
+
+/*
+ * Function open_out_file(): Open an output file for captured output, positioned at its end.
+ * 
+ * Algorithm: Open the file without O_APPEND, which splice() rejects, and find its length.
  * 
- * Input: Buffer of received arguments (buf), file path of child output redirection file (out_file), file path of logging redirection file 
- * (log_file), time before SIGTERM is sent to child (SIGTERM_timeout), indicator of if memory information is to be sent back to the controller 
- * (show_mem_info), the ID of the process for memory information to be sent back (proc_id), indicator of if processes above a certain percentage 
- * memory usage should be killed (kill_mem_percent), percentage of memory usage used to kill processes (mem_percent), array of strings to hold 
- * executable file and its arguments (args).
+ * Input: File path of the output file (out_file) and pointer to store its length (out_len).
  * 
- * Output: The number of arguments (not including the file) in args.
+ * Output: File descriptor of the output file, or ERROR if it could not be opened.
  */
-int split_args(char* buf, char* out_file, char *log_file, int *SIGTERM_timeout, int *show_mem_info, int *proc_id, int *kill_mem_percent, double *mem_percent, char **args);
+int open_out_file(char *out_file, off_t *out_len);
 
 /*
- * Function get_mem_used(): Get the current memory usage of the specified process.
+ * Function open_pidfd(): Obtain a file descriptor referring to the specified process.
  * 
- * Algorithm: Open maps file, read each line, get memory usage from start and end address, check if inode is 0, sum memory usage of inodes which are 0.
+ * Algorithm: Call pidfd_open().
  * 
  * Input: Process ID (c_pid).
  * 
- * Output: Memory used by process.
+ * Output: Process file descriptor, or ERROR if pidfds are not supported.
  */
-long int get_mem_used(pid_t c_pid);
+int open_pidfd(pid_t c_pid);
 
 /*
- * Function get_request(): Retrieves a request from the queue.
+ * Function launch_child(): Execute a file and hand the child over to the supervisor.
  * 
- * Algorithm: Get the first request from the queue and set the following request to be the new head.
+ * Algorithm: Log the attempt and spawn the child from the calling thread placed by place_thread(), failing if it cannot be placed. On success, 
+ * place it in a cgroup of its own if jobs are placed in cgroups, log its pid and add it, handing over its pidfd and cgroup; otherwise log the 
+ * failure. A child which cannot be placed in a cgroup is killed and reaped, as it would otherwise run outside its memory limit.
  * 
- * Input: None.
+ * Input: Array of strings holding the executable file path and its arguments (args), file path of child output redirection file (out_file), 
+ * file path of logging redirection file (log_file), time in milliseconds before SIGTERM is sent to child (SIGTERM_timeout) and memory limit 
+ * of the child's cgroup in bytes, or 0 for none (mem_limit), priority class of the child (priority), cores reserved for the child by 
+ * reserve_cpus(), or NULL (cpus), which are given back if the child could not be launched, and pointer to store the reason it could not be 
+ * (error). Empty file paths mean no redirection.
  * 
- * Output: First request in the queue.
+ * Output: Process ID of the child, or ERROR if the child could not be launched.
  */
-struct request *get_request();
+pid_t launch_child(char **args, char *out_file, char *log_file, long int SIGTERM_timeout, long int mem_limit, int priority, cpu_set_t *cpus, 
+                   char **error);
 
 /*
- * Function add_mem_entry(): Add new memory report entry for the specified process. 
+ * Function spawn_child(): Execute a file in a new child without copying the overseer's address space.
  * 
- * Algorithm: Concatenate file path and its arguments, add process ID, timestamp, memory usage and the file path and args to the linked list.
+ * Algorithm: Call posix_spawn(), which shares the address space with the child until it executes the file, with file actions opening the 
+ * output redirection file onto stdout and stderr if applicable, and an empty signal mask. Failure to open the redirection file or to execute 
+ * the file is reported by posix_spawn() itself. When output is captured, the redirection file is opened by the overseer instead, and a pipe 
+ * is placed onto stdout and stderr and handed to the capture thread with the file. The child inherits the calling thread's placement. On 
+ * success, open a pidfd referring to the child.
  * 
- * Input: Process ID (proc_id), timestamp (timestamp), file path and its arguments (args), memory usage (mem_used).
+ * Input: Array of strings holding the executable file path and its arguments (args), file path of child output redirection file (out_file), 
+ * empty for no redirection, and pointer to store the child's pidfd (pidfd), which is ERROR if pidfds are not supported.
  * 
- * Output: None.
+ * Output: Process ID of the child, or ERROR if the file could not be executed.
  */
-void add_mem_entry(pid_t proc_id, char* timestamp, char **args, int mem_used);
+pid_t spawn_child(char **args, char *out_file, int *pidfd);
 
 /*
- * Function add_request(): Add request to the end of the queue.
+ * Function place_thread(): Give the calling thread the placement a child spawned by it is to inherit.
  * 
- * Algorithm: As above.
+ * Algorithm: posix_spawn() has no attribute for either, but a child inherits the CPU affinity and memory policy of the thread spawning it. 
+ * Save the thread's affinity and pin it to the child's dedicated cores, binding its memory to their nodes if there are several nodes. A child 
+ * without dedicated cores is kept off the cores dedicated to others. A thread which cannot be placed is left as it was.
  * 
- * Input: Controller internet address (controller_addr) and connection file descriptor (new_fd). 
+ * Input: Cores dedicated to the child, or NULL (cpus), and pointer to store the thread's own affinity (saved).
  * 
- * Output: None.
+ * Output: TRUE if the thread has been placed and must be restored by restore_thread(), FALSE if it needs no placement, or ERROR if the child 
+ * cannot be placed: a child without dedicated cores when every core is dedicated, or one whose memory cannot be bound to its cores' nodes.
  */
-void add_request(struct sockaddr_in controller_addr, int new_fd);
+int place_thread(cpu_set_t *cpus, cpu_set_t *saved);
 
 /*
- * Function clean_up_unhandled_reqs(): Clean up requests that had not yet been handled.
+ * Function restore_thread(): Restore the placement of a thread placed by place_thread().
  * 
- * Algorithm: Free all linked list nodes.
+ * Algorithm: Restore the thread's affinity and, if there are several nodes, its default memory policy.
  * 
- * Input: None.
+ * Input: Affinity saved by place_thread() (saved).
  * 
  * Output: None.
  */
-void clean_up_unhandled_reqs();
+void restore_thread(cpu_set_t *saved);
+
+/*
+ * Function reserve_cpus(): Dedicate cores to a job.
+ * 
+ * Algorithm: Count the free cores of each node. Take the lowest-numbered free cores of the node with the fewest free cores that still fits the 
+ * job, keeping larger nodes whole for larger jobs, or of any nodes if none fits it alone, and mark them as in use.
+ * 
+ * Input: Number of cores (num_cpus) and pointer to store the set of cores (cpus).
+ * 
+ * Output: 0, or ERROR if fewer cores are free.
+ */
+int reserve_cpus(int num_cpus, cpu_set_t *cpus);
 
 /*
- * Function delete_mem_entries(): Delete all memory report entries for the specified process. 
+ * Function release_cpus(): Give back the cores dedicated to a job which has exited or could not be launched.
  * 
- * Algorithm: Traverse through the linked list, check if a node has the specified process ID and then remove if it does.
+ * Algorithm: Mark the cores as free.
  * 
- * Input: Process ID (proc_id).
+ * Input: Set of cores returned by reserve_cpus() (cpus).
  * 
  * Output: None.
+ */
+void release_cpus(cpu_set_t *cpus);
+
+/*
+ * Function reap_child(): Reap the specified child if it has terminated.
+ * 
+ * Algorithm: Check if the state of the process has changed, and if it has, log and publish its exit status, or the signal that killed it.
+ * 
+ * Input: Child to reap (child).
  * 
+ * Output: Indication of whether the child has terminated.
  */
-void delete_mem_entries(pid_t proc_id);
+int reap_child(struct child *child);
 
 /*
- * Function exec_request(): Execute the first request in the queue. 
+ * Function init_cgroup_tree(): Prepare a delegated cgroup v2 subtree for the jobs' cgroups.
  * 
- * Algorithm: Receive arguments from controller, split the string of arguments, if applicable send memory report back to controller, if applicable 
- * kill all process above a certain percentage of memory usage, if applicable execute and oversee the specified file and arguments.
+ * Algorithm: Enable the memory controller for the children of the root of the subtree and create the epoll file descriptor the memory.events 
+ * files are registered with. The overseer itself must not be in the subtree, as a cgroup with processes cannot delegate controllers.
  * 
- * Input: Controller internet address (controller_addr) and connection file descriptor (new_fd).
+ * Input: Path of the root of the subtree (root).
  * 
- * Output: None.
+ * Output: 0 on success, or ERROR if the memory controller could not be enabled.
  */
-void exec_request(struct sockaddr_in controller_addr, int new_fd);
+int init_cgroup_tree(char *root);
 
 /*
- * Function get_mem_info_all(): Get memory information of all running processes.
+ * Function write_cgroup_file(): Write a value to an interface file of a cgroup.
  * 
  * Algorithm: As above.
  * 
- * Input: IDs of currently running processes (proc_ids), memory usage of currently running processes (mem_used), file and arguments of currently 
- * running processes (proc_args).
+ * Input: Path of the cgroup (cgroup), name of the interface file (file) and value to write (value).
  * 
- * Output: None.
+ * Output: 0 on success, or ERROR if the file could not be written.
  */
-void get_mem_info_all(pid_t *proc_ids, long int *mem_used, char **proc_args);
+int write_cgroup_file(char *cgroup, char *file, char *value);
 
 /*
- * Function get_time(): Get the current system time. 
+ * Function open_mem_fd(): Open the file read by the memory sampler of the specified child.
  * 
- * Algorithm: Retrieve the current system time and format it into a string.
+ * Algorithm: Open the memory.current file of the child's cgroup if it was placed in one, otherwise the process file of the selected backend.
  * 
- * Input: Current time string (current_time_fmt).
+ * Input: Child to sample (child).
  * 
- * Output: None.
+ * Output: File descriptor, or ERROR if the file could not be opened.
  */
-void get_time(char *current_time_fmt);
+int open_mem_fd(struct child *child);
 
 /*
- * Function handle_SIGINT(): SIGINT handling function.
+ * Function get_mem_used(): Get the current memory usage of a process.
  * 
- * Algorithm: Set quit to TRUE.
+ * Algorithm: Sample the file which is kept open for the process using the child's backend.
  * 
- * Input: None.
+ * Input: Child to sample (child).
+ * 
+ * Output: Memory used by process, or 0 if it could not be sampled.
+ */
+long int get_mem_used(struct child *child);
+
+/*
+ * Function read_latest_sample(): Read the latest sample of a child's memory history without blocking the sampler.
+ * 
+ * Algorithm: Wait for the child's sequence count to be even, read the latest sample, and retry if the sequence count has since changed.
+ * 
+ * Input: Child to read (child), to which the caller holds a reference.
+ * 
+ * Output: Memory usage of the latest sample (bytes), or ERROR if the child has not been sampled yet.
+ */
+long int read_latest_sample(struct child *child);
+
+/*
+ * Function sample_memory_current(): Parse the memory usage of a cgroup from its memory.current file.
+ * 
+ * Algorithm: Read the file, which holds the memory charged to the cgroup in bytes.
+ * 
+ * Input: File descriptor of the memory.current file (mem_fd).
+ * 
+ * Output: Memory usage (bytes), or ERROR if the file could not be read.
+ */
+long int sample_memory_current(int mem_fd);
+
+/*
+ * Function sample_maps(): Memory sampler backend which sums the anonymous mappings in /proc/<pid>/maps.
+ * 
+ * Algorithm: Re-read the file from the start with pread() into a fixed buffer, parse each line in place, check if inode is 0, and sum the sizes 
+ * of the mappings which are. Reports virtual size.
+ * 
+ * Input: File descriptor of the maps file (mem_fd).
+ * 
+ * Output: Memory used by process, or ERROR.
+ */
+long int sample_maps(int mem_fd);
+
+/*
+ * Function sample_smaps_rollup(): Memory sampler backend which reads the resident set size from /proc/<pid>/smaps_rollup.
+ * 
+ * Algorithm: Re-read the file with pread() into a fixed buffer and parse the Rss field.
+ * 
+ * Input: File descriptor of the smaps_rollup file (mem_fd).
+ * 
+ * Output: Memory used by process, or ERROR.
+ */
+long int sample_smaps_rollup(int mem_fd);
+
+/*
+ * Function sample_statm(): Memory sampler backend which reads the resident set size from /proc/<pid>/statm.
+ * 
+ * Algorithm: Re-read the file with pread() into a fixed buffer and multiply the resident field by the page size.
+ * 
+ * Input: File descriptor of the statm file (mem_fd).
+ * 
+ * Output: Memory used by process, or ERROR.
+ */
+long int sample_statm(int mem_fd);
+
+/*
+ * Function init_reactor(): Initialise the listening socket and epoll instance of a reactor.
+ * 
+ * Algorithm: Open a non-blocking listening socket of its own, create an epoll instance and register the listening socket, the event file 
+ * descriptor stopping the reactors and, if given, the signal file descriptor with it, identified by their addresses. Allocate REQUEST_POOL_LEN 
+ * spare request records, so that a session's requests in flight are served without allocating.
+ * 
+ * Input: Reactor (reactor), overseer port number (overseer_port) and signal file descriptor, or NULL if the reactor does not handle SIGINT 
+ * (signal_fd).
  * 
  * Output: None.
+ */
+void init_reactor(struct reactor *reactor, int overseer_port, int *signal_fd);
+
+/*
+ * Function init_signal_fd(): Initialise the signal file descriptor used to receive SIGINT.
+ * 
+ * Algorithm: Block SIGINT and SIGCHLD (the mask is inherited by every thread created afterwards) and create a signal file descriptor to read 
+ * SIGINT from instead.
  * 
+ * Input: None.
+ * 
+ * Output: Signal file descriptor.
  */
-void handle_SIGINT();
+int init_signal_fd();
 
 /*
- * Function init_SIGINT_handling(): Initialise handler for SIGINT.
+ * Function get_time_ms(): Get the current monotonic time.
  * 
  * Algorithm: As above.
  * 
  * Input: None.
  * 
+ * Output: Monotonic time in milliseconds.
+ */
+long int get_time_ms();
+
+/*
+ * Function hash_pid(): Hash a process ID to a slot of the process table.
+ * 
+ * Algorithm: Multiply the process ID by FIBONACCI_HASH and keep as many of the highest bits as are needed to index the table.
+ * 
+ * Input: Process ID (c_pid).
+ * 
+ * Output: Index of the process ID's home slot.
+ */
+long int hash_pid(pid_t c_pid);
+
+/*
+ * Function get_next_expiry(): Get the time at which the timing wheel next has to be advanced.
+ * 
+ * Algorithm: For each level, find the first occupied slot from the current slot onwards using the level's bitmap, and take the earliest time at 
+ * which any of those slots is processed (run for the first level, cascaded for the others).
+ * 
+ * Input: Timing wheel (wheel).
+ * 
+ * Output: Monotonic time in milliseconds, or ERROR if no timers are pending.
+ */
+long int get_next_expiry(struct timer_wheel *wheel);
+
+/*
+ * Function open_session(): Start reading from a newly accepted connection.
+ * 
+ * Algorithm: Allocate a session holding the reactor's reference, register it with the reactor and add it to the reactor's list of sessions.
+ * 
+ * Input: Reactor which accepted the connection (reactor) and connection file descriptor (new_fd).
+ * 
+ * Output: Pointer to the session.
+ */
+struct session *open_session(struct reactor *reactor, int new_fd);
+
+/*
+ * Function open_log_file(): Obtain a reference to a logging redirection file, opening it in append mode unless it is already open.
+ * 
+ * Algorithm: Search the open logging redirection files for the file path with the mutex held, taking a reference to a match, or otherwise open 
+ * the file into a spare record, or a new one if there is none, and add it with one reference.
+ * 
+ * Input: File path of the logging redirection file (path).
+ * 
+ * Output: Pointer to the logging redirection file.
+ */
+struct log_file *open_log_file(char *path);
+
+/*
+ * Function place_child(): Place a newly spawned child in a cgroup of its own, limiting its memory if requested.
+ * 
+ * Algorithm: Create a cgroup named after the child's pid under the root of the subtree, write the limit to memory.max and MEM_HIGH_PERCENT of 
+ * it to memory.high, and move the child into the cgroup, removing the cgroup again if any step fails. The child runs in the overseer's 
+ * cgroup until it is moved, as posix_spawn() cannot start it in another: from its exec to the write to cgroup.procs it is not limited, and 
+ * what it allocates meanwhile stays charged to the overseer's cgroup, as cgroup v2 does not move charges. clone3() with CLONE_INTO_CGROUP 
+ * would close the window, but not without copying the overseer's page tables, which posix_spawn() avoids.
+ * 
+ * Input: Process ID of the child (c_pid), memory limit in bytes, or 0 for none (mem_limit), and buffer of FILENAME_MAX bytes to store the 
+ * path of the cgroup (cgroup).
+ * 
+ * Output: 0, or ERROR if the child could not be placed in the cgroup.
+ */
+int place_child(pid_t c_pid, long int mem_limit, char *cgroup);
+
+/*
+ * Function add_block(): Give an arena a new block to allocate from.
+ * 
+ * Algorithm: Allocate the block and push it onto the arena's blocks.
+ * 
+ * Input: Arena (arena) and number of bytes of data of the block (len).
+ * 
  * Output: None.
  */
-void init_SIGINT_handling();
+void add_block(struct arena *arena, size_t len);
+
+/*
+ * Function arena_alloc(): Allocate memory from an arena, which is freed when the arena is reset or freed.
+ * 
+ * Algorithm: Bump the offset into the current block by the size rounded up to ARENA_ALIGN. If the block is full, add a block at least twice 
+ * its size, or of ARENA_BLOCK_LEN bytes for the first block.
+ * 
+ * Input: Arena (arena) and number of bytes (size).
+ * 
+ * Output: Pointer to the uninitialised memory.
+ */
+void *arena_alloc(struct arena *arena, size_t size);
 
 /*
- * Function log_args(): Prints arguments to stdout or specified redirection file.
+ * Function arena_strdup(): Copy a string into an arena.
  * 
  * Algorithm: As above.
  * 
- * Input: Number of arguments (num_args), indicator of if redirection file should be used (use_log_file), redirection file stream (log_fp), 
- * arguments to print (args).
+ * Input: Arena (arena) and string (str).
  * 
- * Output: None.
+ * Output: Pointer to the copy.
  */
-void log_args(int num_args, int use_log_file, FILE *log_fp, char **args);
+char *arena_strdup(struct arena *arena, char *str);
 
 /*
- * Function log_message(): Prints logging message to stdout or specified redirection file.
+ * Function free_arena(): Free every block of an arena and its frame buffer.
  * 
  * Algorithm: As above.
  * 
- * Input: Indicator of if redirection file should be used (use_log_file), redirection file stream (log_fp), message to log (message).
+ * Input: Arena (arena).
  * 
  * Output: None.
  */
-void log_message(int use_log_file, FILE *log_fp, char *log_message);
+void free_arena(struct arena *arena);
 
 /*
- * Function manage_child(): Manage and oversee the specified process.
+ * Function init_arena(): Initialise an arena with a single block.
  * 
- * Algorithm: Check every quarter second if the state of the process has changed, make entries in the memory report each second, send SIGTERM or 
- * SIGKILL if the process exceeds its specified timeout.
+ * Algorithm: As above.
  * 
- * Input: Process ID (c_pid), time before SIGTERM is sent to child (SIGTERM_timeout), current time string (current_time), file and arguments (args), 
- * message to log (message), indicator of if redirection file should be used (use_log_file) and redirection file stream (log_fp).
+ * Input: Arena (arena) and number of bytes it is to hold (len).
  * 
  * Output: None.
  */
-void manage_child(pid_t c_pid, int SIGTERM_timeout, char *current_time, char **args, char* message, int use_log_file, FILE *log_fp);
+void init_arena(struct arena *arena, size_t len);
 
 /*
- * Function init_threads(): Initialise POSIX threads.
+ * Function reset_arena(): Free every allocation of an arena at once.
  * 
- * Algorithm: Initialise mutexes and the condition variable, and create the threads.
+ * Algorithm: Rewind the current block and empty the frame buffer. If allocations overflowed into further blocks since the last reset, replace 
+ * them all with a single block holding as much as was allocated, so that an arena settles on one block which it never reallocates.
  * 
- * Input: Array of thread IDs (p_threads) and pointer to function to handle controller requests (handle_requests).
+ * Input: Arena (arena).
  * 
  * Output: None.
  */
-void init_threads(pthread_t *p_threads, void *(*handle_requests)(void *));
+void reset_arena(struct arena *arena);
 
 /*
- * Function kill_all_percent(): Kill all processes using more than the specified percentage of the system memory.
+ * Function join_args(): Concatenate a file and its arguments, separated by spaces.
  * 
- * Algorithm: Get the total amount of usable memory using sysinfo, check if any processes are using more than the specified percentage of memory and 
- * kill all that are.
+ * Algorithm: As above.
  * 
- * Input: IDs of currently running processes (proc_ids), memory usage of currently running processes (mem_used) and percentage threshold (mem_percent).
+ * Input: NULL-terminated array of strings holding the file path and its arguments (args), no longer than PATH_MAX once joined, and buffer of 
+ * PATH_MAX bytes to join them into (joined_args).
  * 
- * Output: None.
+ * Output: Pointer to the joined string.
  */
-void kill_all_percent(int *proc_ids, long int *mem_used, double mem_percent);
+char *join_args(char **args, char *joined_args);
 
 /*
- * Function listen_to(): Listen for connections on socket.
+ * Function move_output(): Move the output waiting in a captured child's pipe to its tailers and output file without copying it to userspace.
  * 
- * Algorithm: Open and bind a socket, and start listening for connections.
+ * Algorithm: Duplicate the waiting output into the pipe of each tailer with tee(), counting what does not fit as dropped, and send each what 
+ * its socket has room for. Then splice() the output into the output file, rotating the file whenever it reaches the rotation length.
  * 
- * Input: Socket file descriptor (sock_fd) and overseer port number (overseer_port).
+ * Input: Capture (capture).
  * 
- * Output: None.
+ * Output: Number of bytes moved.
  */
-void listen_to(int *sock_fd, int overseer_port);
+size_t move_output(struct capture *capture);
 
 /*
- * Function redir_stream(): Redirect stdout and stderr to the specified file.
+ * Function get_request(): Take a request for a worker to execute.
  * 
- * Algorithm: Open the specified file, create a copy of the stdout and stderr streams and redirect to the file.
+ * Algorithm: Take the first request of the worker's own queue. If it is empty while requests are queued, steal the first request of the 
+ * queue of each other worker in turn, starting from the next one.
  * 
- * Input: Redirection file descriptor (out_fd), redirection file path (out_file), copy of stdout (stdout_old_fd) and copy of stderr (stderr_old_fd).
+ * Input: Worker (worker).
  * 
- * Output: None.
+ * Output: Request, or NULL if none was found.
  */
-void redir_stream(int *out_fd, char* out_file, int *stdout_old_fd, int *stderr_old_fd);
+struct request *get_request(struct worker *worker);
 
 /*
- * Function restore_stream(): Restore stdout and stderr after redirection.
+ * Function pop_request(): Take the first request of a worker's queue.
  * 
- * Algorithm: As above.
+ * Algorithm: As above, under the queue's mutex.
  * 
- * Input: Copy of stdout (stdout_old_fd) and copy of stderr (stderr_old_fd).
+ * Input: Worker whose queue is taken from (worker).
+ * 
+ * Output: Request, or NULL if the queue is empty.
+ */
+struct request *pop_request(struct worker *worker);
+
+/*
+ * Function new_request(): Take a request record for a reactor to fill.
+ * 
+ * Algorithm: Take a spare record of the reactor, taking every record the workers have finished once the spares run out, or allocate a new 
+ * one with alloc_request() if there are none.
+ * 
+ * Input: Reactor (reactor).
+ * 
+ * Output: Pointer to the record.
+ */
+struct request *new_request(struct reactor *reactor);
+
+/*
+ * Function alloc_request(): Allocate a request record.
+ * 
+ * Algorithm: Allocate the record and a payload buffer of REQUEST_PAYLOAD_LEN bytes, which add_request() only grows for a longer payload.
+ * 
+ * Input: None.
+ * 
+ * Output: Pointer to the record.
+ */
+struct request *alloc_request();
+
+/*
+ * Function wait_for_request(): Idle a worker until a request is queued.
+ * 
+ * Algorithm: Push the worker onto the idle workers and count it, then wait until the reactor takes it off them, unless requests are already 
+ * queued or the workers are to terminate. The worker counts itself as idle before checking the queued requests, and the reactor counts a 
+ * request as queued before checking the idle workers, so either the worker sees the request or the reactor sees the worker.
+ * 
+ * Input: Worker (worker).
  * 
  * Output: None.
  */
-void restore_stream(int stdout_old_fd, int stderr_old_fd);
+void wait_for_request(struct worker *worker);
 
 /*
- * Function send_mem_info_all(): Send memory information of all running processes to controller.
+ * Function wake_worker(): Wake an idle worker.
  * 
- * Algorithm: As above.
+ * Algorithm: Take the most recently idle worker off the idle workers and signal it.
  * 
- * Input: IDs of currently running processes (proc_ids), memory usage of currently running processes (mem_used), file and arguments of currently 
- * running processes (proc_args), connection file descriptor (new_fd).
+ * Input: None.
  * 
  * Output: None.
  */
-void send_mem_info_all(pid_t *proc_ids, long int *mem_used, char **proc_args, int new_fd);
+void wake_worker();
 
 /*
- * Function send_mem_info_id(): Send memory report for specified process ID.
+ * Function find_child(): Find a child owned by the supervisor by process ID in O(1).
+ * 
+ * Algorithm: Hash the process ID to a slot of the process table and probe linearly, skipping tombstones, until the child or an empty slot is 
+ * found. The caller holds the child mutex.
+ * 
+ * Input: Process ID (c_pid).
+ * 
+ * Output: Pointer to the child, or NULL if the supervisor owns no child with the process ID.
+ */
+struct child *find_child(pid_t c_pid);
+
+/*
+ * Function find_mem_sampler(): Find a memory sampler backend by name.
  * 
  * Algorithm: As above.
  * 
- * Input: Process ID to send memory report for (proc_id), connection file descriptor (new_fd).
+ * Input: Name of the backend (name).
  * 
- * Output: None.
+ * Output: Pointer to the backend, or NULL if there is none with the name.
  */
-void send_mem_info_id(pid_t proc_id, int new_fd);
+struct mem_sampler *find_mem_sampler(char *name);
 
 /*
- * Function handle_requests(): Retrieves requests from the queue and handles them. 
+ * Function add_child(): Hand a newly launched child over to the supervisor.
  * 
- * Algorithm: While the program hasn't been instructed to terminate, get a request from the queue and execute it.
+ * Algorithm: Take a child record from new_child() and copy its cgroup, cores and arguments into it, open its memory sampler file and, if it was 
+ * placed in a cgroup, the cgroup's memory.events file, add it to the list of pending children and wake the supervisor to adopt it.
  * 
- * Input: None.
+ * Input: Process ID (c_pid), file descriptor referring to the child (pidfd), or ERROR if none, path of the child's cgroup, or empty if none 
+ * (cgroup), dedicated cores, or NULL (cpus), time in milliseconds before SIGTERM is sent to child (SIGTERM_timeout), priority class 
+ * (priority), file and arguments concatenated by join_args() (args) and logging redirection file, or NULL for stdout (log_fp). Ownership of 
+ * pidfd, the cgroup, the cores and the reference to log_fp passes to the supervisor.
+ * 
+ * Output: None.
+ */
+void add_child(pid_t c_pid, int pidfd, char *cgroup, cpu_set_t *cpus, long int SIGTERM_timeout, int priority, char *args, 
+               struct log_file *log_fp);
+
+/*
+ * Function new_child(): Take a child record for a newly launched child.
+ * 
+ * Algorithm: Take a spare record freed by free_child() with the child mutex held, or allocate one if there is none.
+ * 
+ * Input: None.
+ * 
+ * Output: Pointer to the record.
+ */
+struct child *new_child();
+
+/*
+ * Function add_capture(): Hand the output of a newly spawned child over to the capture thread.
+ * 
+ * Algorithm: With the capture mutex held, take a spare capture, or allocate one if there is none, add it to the list of captures and register 
+ * its pipe with the capture thread's epoll file descriptor.
+ * 
+ * Input: Process ID (c_pid), read end of the pipe the child writes to (pipe_fd), output file descriptor (out_fd) and its length (out_len), 
+ * and file path of the output file (out_file). Ownership of pipe_fd and out_fd passes to the capture thread.
+ * 
+ * Output: None.
+ */
+void add_capture(pid_t c_pid, int pipe_fd, int out_fd, off_t out_len, char *out_file);
+
+/*
+ * Function add_tailer(): Start streaming the output of a captured child to a controller.
+ * 
+ * Algorithm: Find the capture of the child with the mutex held and add a tailer with its own pipe to it, taking a reference to the session. 
+ * If the child's output is not captured, reply with MSG_ERROR.
+ * 
+ * Input: Tail request (req) and process ID of the child (c_pid).
+ * 
+ * Output: None.
+ */
+void add_tailer(struct request *req, pid_t c_pid);
+
+/*
+ * Function add_timer(): Add a timer to the timing wheel in O(1).
+ * 
+ * Algorithm: Choose the lowest level whose range covers the time until expiry, index its slot with the corresponding bits of the expiry time, 
+ * and push the timer onto the slot's list. Timers which have already expired are placed in the current slot.
+ * 
+ * Input: Timing wheel (wheel), timer to add (timer) and monotonic time in milliseconds at which it expires (expires).
+ * 
+ * Output: None.
+ */
+void add_timer(struct timer_wheel *wheel, struct timer *timer, long int expires);
+
+/*
+ * Function advance_timers(): Advance the timing wheel to the specified time, running every timer which has expired.
+ * 
+ * Algorithm: For each slot which has to be processed up to the specified time, cascade the timers of the levels above at each boundary and run 
+ * the timers of the current slot of the first level; empty slots are skipped over using get_next_expiry().
+ * 
+ * Input: Timing wheel (wheel) and current monotonic time in milliseconds (now).
+ * 
+ * Output: None.
+ */
+void advance_timers(struct timer_wheel *wheel, long int now);
+
+/*
+ * Function cancel_timer(): Remove a timer from the timing wheel in O(1) if it is pending.
+ * 
+ * Algorithm: Unlink the timer from its slot's list and clear the slot's bit if it has become empty.
+ * 
+ * Input: Timing wheel (wheel) and timer to cancel (timer).
+ * 
+ * Output: None.
+ */
+void cancel_timer(struct timer_wheel *wheel, struct timer *timer);
+
+/*
+ * Function cascade_timers(): Move the timers of the current slot of the specified level to lower levels.
+ * 
+ * Algorithm: Remove each timer from the slot and add it again relative to the current time.
+ * 
+ * Input: Timing wheel (wheel) and level to cascade (level).
+ * 
+ * Output: None.
+ */
+void cascade_timers(struct timer_wheel *wheel, int level);
+
+/*
+ * Function init_timer(): Initialise a timer.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Timer (timer), function called when the timer expires (expire) and data passed to it through the timer (data).
+ * 
+ * Output: None.
+ */
+void init_timer(struct timer *timer, void (*expire)(struct timer_wheel *, struct timer *), void *data);
+
+/*
+ * Function init_timer_wheel(): Initialise an empty timing wheel.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Timing wheel (wheel) and current monotonic time in milliseconds (now).
+ * 
+ * Output: None.
+ */
+void init_timer_wheel(struct timer_wheel *wheel, long int now);
+
+/*
+ * Function add_mem_samples(): Add the samples of the current batch to the memory histories of its children. 
+ * 
+ * Algorithm: Write each sample into the next slot of its child's ring buffer, overwriting the oldest sample once the buffer is full. Each write 
+ * is bracketed by increments of the child's sequence count, so that readers never block the sampler and retry if they observe a write.
+ * 
+ * Input: Number of children in the batch (num_children).
+ * 
+ * Output: None.
+ */
+void add_mem_samples(int num_children);
+
+/*
+ * Function check_watchdog(): Evaluate the samples of the current batch against the watchdog policies.
+ * 
+ * Algorithm: For each child, apply its own policy if it has one, otherwise the global policy. Note when a child's sample first exceeds the 
+ * threshold, forget it when a sample falls below, and once the child has stayed above it for the grace period, queue it for the supervisor 
+ * to terminate, taking a reference, and wake the supervisor. A child which has already left the process table is not queued.
+ * 
+ * Input: Number of children in the batch (num_children).
+ * 
+ * Output: None.
+ */
+void check_watchdog(int num_children);
+
+/*
+ * Function count_action(): Count a signal sent to a child by the watchdog.
+ * 
+ * Algorithm: Log the action and increment the global and per-child action counts.
+ * 
+ * Input: Child signalled (child) and name of the signal (signal).
+ * 
+ * Output: None.
+ */
+void count_action(struct child *child, char *signal);
+
+/*
+ * Function enforce_watchdog(): Terminate the children the watchdog has queued.
+ * 
+ * Algorithm: For each child which is still owned by the supervisor and has not been signalled, move its SIGTERM timer to the current time, so 
+ * that it is sent SIGTERM and then SIGKILL as if it had exceeded its timeout. Then drop the watchdog's reference to each child.
+ * 
+ * Input: Timing wheel (wheel), list of children taken from tripped_children (tripped) and indicator that the children are already being 
+ * killed because the overseer is terminating (shutting_down).
+ * 
+ * Output: None.
+ */
+void enforce_watchdog(struct timer_wheel *wheel, struct child *tripped, int shutting_down);
+
+/*
+ * Function send_policies(): Send the watchdog policies and the number of actions taken under them to a controller.
+ * 
+ * Algorithm: Send the global policy as a MSG_POLICY with pid 0, followed by one for each child with a policy of its own, and end with MSG_END.
+ * 
+ * Input: Request being answered (req).
+ * 
+ * Output: None.
+ */
+void send_policies(struct request *req);
+
+/*
+ * Function set_policy(): Install or remove a watchdog policy.
+ * 
+ * Algorithm: Decode the pid, and for an installation the percentage and grace period, of the MSG_WATCHDOG payload. Pid 0 selects the global 
+ * policy; any other must be a running child. Installing a child's policy resets the time since which it has been above its threshold. Answer 
+ * with MSG_END, or MSG_ERROR if there is no such child.
+ * 
+ * Input: Request being answered (req).
+ * 
+ * Output: None.
+ */
+void set_policy(struct request *req);
+
+/*
+ * Function add_request(): Queue a request for the workers.
+ * 
+ * Algorithm: Fill a recycled request record, append it to the queue of the reactor's next worker in turn and count it as queued, then wake 
+ * an idle worker if there is one, which steals the request unless it is its own.
+ * 
+ * Input: Reactor the request arrived on (reactor), connection file descriptor (new_fd), session the request arrived on (session), or NULL 
+ * for a legacy controller's connection, and the header (header) and payload (payload) of the request's frame, which are copied.
+ * 
+ * Output: None.
+ */
+void add_request(struct reactor *reactor, int new_fd, struct session *session, struct frame_header *header, char *payload);
+
+/*
+ * Function add_subscriber(): Subscribe the controller which sent a request to the events of one or every child.
+ * 
+ * Algorithm: Take a reference to the request's session and add a subscriber, tagged with the request's identifier, to the watch list.
+ * 
+ * Input: Subscribing request (req) and process ID of the child to watch, or 0 for every child (c_pid).
+ * 
+ * Output: None.
+ */
+void add_subscriber(struct request *req, pid_t c_pid);
+
+/*
+ * Function clean_up_unhandled_reqs(): Clean up requests that had not yet been handled, once the workers have terminated.
+ * 
+ * Algorithm: Close the connections of legacy requests and finish every request left in the workers' queues, then free the workers, every 
+ * request record and the reactors.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void clean_up_unhandled_reqs();
+
+/*
+ * Function finish_capture(): Finish a capture once its child's output has all been moved.
+ * 
+ * Algorithm: Send each tailer as much of the output it still holds, followed by MSG_END, as its socket has room for, freeing those which are 
+ * done and moving the rest to the draining tailers. Then remove the capture from the list, close its file descriptors and keep it for reuse. 
+ * The caller holds the capture mutex.
+ * 
+ * Input: Capture (capture).
+ * 
+ * Output: None.
+ */
+void finish_capture(struct capture *capture);
+
+/*
+ * Function free_tailer(): Release a tailer's session and free it.
+ * 
+ * Algorithm: Stop waiting for room in the socket and close the tailer's file descriptors. A tailer part way through a frame leaves the session 
+ * broken, waking the writers waiting for it. Then release the session and free the tailer.
+ * 
+ * Input: Tailer (tailer).
+ * 
+ * Output: None.
+ */
+void free_tailer(struct tailer *tailer);
+
+/*
+ * Function close_session(): Stop reading from a session.
+ * 
+ * Algorithm: Deregister the session from its reactor, mark it as no longer being read so that it is never re-armed, unlink it from the 
+ * reactor's list of sessions and drop the reactor's reference to it. The connection stays open until every request in flight has been answered.
+ * 
+ * Input: Session to close (session).
+ * 
+ * Output: None.
+ */
+void close_session(struct session *session);
+
+/*
+ * Function close_sessions(): Stop reading from every session of a reactor.
+ * 
+ * Algorithm: Call close_session() on each session in the reactor's list.
+ * 
+ * Input: Reactor (reactor).
+ * 
+ * Output: None.
+ */
+void close_sessions(struct reactor *reactor);
+
+/*
+ * Function expire_SIGKILL(): Timer function which sends SIGKILL to a child which has not terminated after SIGTERM.
+ * 
+ * Algorithm: Send SIGKILL, and count the action if the watchdog asked for the child to be terminated.
+ * 
+ * Input: Timing wheel (wheel) and expired timer (timer).
+ * 
+ * Output: None.
+ */
+void expire_SIGKILL(struct timer_wheel *wheel, struct timer *timer);
+
+/*
+ * Function expire_SIGTERM(): Timer function which sends SIGTERM to a child which has exceeded its timeout.
+ * 
+ * Algorithm: Send SIGTERM, mark the child so that its memory usage is no longer sampled and arm the SIGKILL timer. Count the action if the 
+ * watchdog asked for it.
+ * 
+ * Input: Timing wheel (wheel) and expired timer (timer).
+ * 
+ * Output: None.
+ */
+void expire_SIGTERM(struct timer_wheel *wheel, struct timer *timer);
+
+/*
+ * Function free_child(): Free a child record once the child has terminated.
+ * 
+ * Algorithm: Close the child's pidfd, memory sampler file, memory.events file and logging redirection file if there are any, and keep the 
+ * record for reuse by new_child().
+ * 
+ * Input: Child to free (child).
+ * 
+ * Output: None.
+ */
+void free_child(struct child *child);
+
+/*
+ * Function delete_child(): Delete a child from the process table in O(1).
+ * 
+ * Algorithm: Find the child's slot and mark it as a tombstone, so that probes for children placed after it continue past it. The caller holds 
+ * the child mutex.
+ * 
+ * Input: Child to delete (child).
+ * 
+ * Output: None.
+ */
+void delete_child(struct child *child);
+
+/*
+ * Function exec_request(): Execute the first request in the queue. 
+ * 
+ * Algorithm: Receive arguments from controller, split the string of arguments, if applicable send memory report back to controller, if applicable 
+ * kill all process above a certain percentage of memory usage, if applicable launch a batch of jobs, if applicable execute the specified file 
+ * and arguments and hand the child over to the supervisor. Requests from a session are answered with frames tagged with their identifier.
+ * 
+ * Input: Request to execute (req).
+ * 
+ * Output: None.
+ */
+void exec_request(struct request *req);
+
+/*
+ * Function finish_request(): Release a request once it has been executed.
+ * 
+ * Algorithm: If the request arrived on a session, count it as answered, resume reading the session if it was paused and is still being read, 
+ * and drop the request's reference to it. Push the record onto the finished records for the reactor to reuse.
+ * 
+ * Input: Request to finish (req).
+ * 
+ * Output: None.
+ */
+void finish_request(struct request *req);
+
+/*
+ * Function get_mem_info_all(): Get memory information of all running processes.
+ * 
+ * Algorithm: Size the arrays from the process table and take a reference to each running process under the child mutex, then read the latest 
+ * sample of each without holding a lock, releasing those which have not been sampled yet.
+ * 
+ * Input: Arena the arrays are allocated from (arena) and pointers to receive the arrays of currently running processes (proc_children) and 
+ * their memory usage (mem_used). The caller releases the references.
+ * 
+ * Output: Number of running processes found.
+ */
+int get_mem_info_all(struct arena *arena, struct child ***proc_children, long int **mem_used);
+
+/*
+ * Function format_time(): Format the specified system time. 
+ * 
+ * Algorithm: Convert the time to local time and format it into a string.
+ * 
+ * Input: System time (raw_time) and time string (time_fmt).
+ * 
+ * Output: None.
+ */
+void format_time(time_t raw_time, char *time_fmt);
+
+/*
+ * Function handle_SIGINT(): SIGINT handling function.
+ * 
+ * Algorithm: Drain the signal file descriptor and set quit to TRUE.
+ * 
+ * Input: Signal file descriptor (signal_fd).
+ * 
+ * Output: None.
+ * 
+ */
+void handle_SIGINT(int signal_fd);
+
+/*
+ * Function log_message(): Queue a logging message for stdout or the specified redirection file.
+ * 
+ * Algorithm: Format the message into a log entry taken by new_log_entry(), truncating it to LOG_LINE_LEN, stamp it with the current system 
+ * time and push it onto the log queue. The timestamp is formatted and the line written by the log writer, so the caller never blocks on the 
+ * file.
+ * 
+ * Input: Logging redirection file, or NULL for stdout (log_fp), printf() format of the message, without the timestamp or trailing newline 
+ * (format), and the values it refers to.
+ * 
+ * Output: None.
+ */
+void log_message(struct log_file *log_fp, const char *format, ...);
+
+/*
+ * Function close_log_file(): Drop a reference to a logging redirection file once every line already logged to it has been written.
+ * 
+ * Algorithm: Push an empty log entry which releases the reference, so the log writer closes the file only after the lines queued before it.
+ * 
+ * Input: Logging redirection file, or NULL for stdout (log_fp).
+ * 
+ * Output: None.
+ */
+void close_log_file(struct log_file *log_fp);
+
+/*
+ * Function new_log_entry(): Take a log entry to queue a line in.
+ * 
+ * Algorithm: Take a spare entry written by the log writer with the log queue mutex held, or allocate one if there is none.
+ * 
+ * Input: None.
+ * 
+ * Output: Pointer to the entry.
+ */
+struct log_entry *new_log_entry();
+
+/*
+ * Function init_placement(): Initialise the placement engine with the cores the overseer may run on and their memory nodes.
+ * 
+ * Algorithm: Read the overseer's affinity, and find the node of each allowed core from the nodeN entry of its sysfs directory, assuming node 0 
+ * if there is none.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void init_placement();
+
+/*
+ * Function init_logger(): Initialise the log queue and create the log writer thread.
+ * 
+ * Algorithm: Allocate LOG_POOL_LEN spare log entries, so that lines are logged without allocating, then create the thread.
+ * 
+ * Input: Pointer to store the log writer thread identifier (logger_thread).
+ * 
+ * Output: None.
+ */
+void init_logger(pthread_t *logger_thread);
+
+/*
+ * Function push_log_entry(): Push a log entry onto the log queue without locking.
+ * 
+ * Algorithm: Link the entry in front of the most recently queued one with a compare-and-swap, retrying if another thread pushed first. If the 
+ * queue was empty, wake the log writer, which otherwise still has the entry's predecessors to write and will find it when it next empties the 
+ * queue.
+ * 
+ * Input: Log entry (entry).
+ * 
+ * Output: None.
+ */
+void push_log_entry(struct log_entry *entry);
+
+/*
+ * Function release_log_file(): Drop a reference to a logging redirection file, closing it and removing it from the cache with the last.
+ * 
+ * Algorithm: As above, keeping the record of a closed file for reuse.
+ * 
+ * Input: Logging redirection file (log_fp).
+ * 
+ * Output: None.
+ */
+void release_log_file(struct log_file *log_fp);
+
+/*
+ * Function stop_reactors(): Stop the reactors once the first has returned, and stop reading from every session.
+ * 
+ * Algorithm: Join the threads of the other reactors, which the first has signalled to stop, then close the sessions, listening socket and 
+ * epoll instance of each reactor, and the event file descriptor stopping them.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void stop_reactors();
+
+/*
+ * Function stop_threads(): Terminate the request-handling threads.
+ * 
+ * Algorithm: Set the quit flag, take every idle worker off the idle workers and signal it, and join every thread.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void stop_threads();
+
+/*
+ * Function stop_logger(): Write every queued log line and terminate the log writer.
+ * 
+ * Algorithm: Set the quit flag, wake the log writer and join it, then close the logging redirection files still open and free them and the 
+ * spare entries and files. Must be called once no other thread can log.
+ * 
+ * Input: Log writer thread identifier (logger_thread).
+ * 
+ * Output: None.
+ */
+void stop_logger(pthread_t logger_thread);
+
+/*
+ * Function write_log_entries(): Write a list of log entries and keep them for reuse.
+ * 
+ * Algorithm: Stamp each entry with its system time, formatted again only when the second changes, and gather consecutive entries for the same 
+ * destination into one writev() of up to LOG_BATCH_LEN lines, continuing after partial writes. Drop the references of releasing entries once 
+ * the lines before them have been written, then hand the batch back to the spare entries under a single lock.
+ * 
+ * Input: Pointer to the first entry, in the order they were logged (entries).
+ * 
+ * Output: None.
+ */
+void write_log_entries(struct log_entry *entries);
+
+/*
+ * Function init_sampler(): Initialise the sampler.
+ * 
+ * Algorithm: Initialise the sampler's condition variable on the monotonic clock and the batch's synchronisation variables, and create the 
+ * sampler thread and its helpers.
+ * 
+ * Input: Array of sampler thread IDs (sampler_threads).
+ * 
+ * Output: None.
+ */
+void init_sampler(pthread_t *sampler_threads);
+
+/*
+ * Function init_supervisor(): Initialise the supervisor.
+ * 
+ * Algorithm: Initialise the pending children mutex and the supervisor's event file descriptor, allocate CHILD_POOL_LEN spare child records, 
+ * so that children are launched without allocating, and create the supervisor thread.
+ * 
+ * Input: Supervisor thread ID (supervisor_thread).
+ * 
+ * Output: None.
+ */
+void init_supervisor(pthread_t *supervisor_thread);
+
+/*
+ * Function init_reactors(): Initialise the reactors and create a thread for each but the first, which the main thread runs.
+ * 
+ * Algorithm: Create the event file descriptor stopping the reactors, initialise each reactor with its own listening socket, giving the 
+ * signal file descriptor to the first only, and start the others' threads. Each reactor queues its first request on a different worker.
+ * 
+ * Input: Overseer port number (overseer_port) and signal file descriptor (signal_fd).
+ * 
+ * Output: None.
+ */
+void init_reactors(int overseer_port, int *signal_fd);
+
+/*
+ * Function init_threads(): Initialise the worker pool and create the request-handling threads.
+ * 
+ * Algorithm: Initialise the mutexes and condition variables, and create a thread for each worker, passing it its worker.
+ * 
+ * Input: Pointer to function to handle controller requests (handle_requests).
+ * 
+ * Output: None.
+ */
+void init_threads(void *(*handle_requests)(void *));
+
+/*
+ * Function insert_child(): Insert a child into the process table in O(1) amortised.
+ * 
+ * Algorithm: Resize the table if it would become more than three quarters full of children and tombstones, then hash the process ID to a slot 
+ * and probe linearly for the first empty slot or tombstone. The caller holds the child mutex.
+ * 
+ * Input: Child to insert (child).
+ * 
+ * Output: None.
+ */
+void insert_child(struct child *child);
+
+/*
+ * Function kill_all_percent(): Kill all processes using more than the specified percentage of the system memory.
+ * 
+ * Algorithm: Get the total amount of usable memory using sysinfo, check if any processes are using more than the specified percentage of memory and 
+ * kill all that are.
+ * 
+ * Input: Currently running processes (proc_children), memory usage of currently running processes (mem_used), number of currently running 
+ * processes (num_procs) and percentage threshold (mem_percent).
+ * 
+ * Output: None.
+ */
+void kill_all_percent(struct child **proc_children, long int *mem_used, int num_procs, double mem_percent);
+
+/*
+ * Function find_priority(): Find a priority class by name.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Name of the class (name).
+ * 
+ * Output: Priority class (PRIORITY_*), or ERROR if there is no such class.
+ */
+int find_priority(char *name);
+
+/*
+ * Function free_job(): Free a job kept by keep_job() once it has been launched or rejected.
+ * 
+ * Algorithm: Release the reference to its session if it holds one, and free its arena, which holds the record and its buffers.
+ * 
+ * Input: Job to free (job).
+ * 
+ * Output: None.
+ */
+void free_job(struct job *job);
+
+/*
+ * Function has_slot(): Check whether a job of a priority class may start under the concurrency limits. The caller holds the scheduler mutex.
+ * 
+ * Algorithm: Check that neither the class nor all classes together have reached their limit.
+ * 
+ * Input: Priority class (priority).
+ * 
+ * Output: TRUE if the job may start, otherwise FALSE.
+ */
+int has_slot(int priority);
+
+/*
+ * Function hold_job(): Hold a launch back if pressure is above a threshold.
+ * 
+ * Algorithm: If launches are held, or earlier launches are still waiting, append the launch to the held launches, so that launches are made in 
+ * the order they arrived.
+ * 
+ * Input: Launch to hold (job), which is copied by keep_job() if it is held.
+ * 
+ * Output: TRUE if the launch has been held, otherwise FALSE.
+ */
+int hold_job(struct job *job);
+
+/*
+ * Function launch_job(): Launch a single job for which a slot has been reserved and answer the request it arrived in.
+ * 
+ * Algorithm: Reject the job if the overseer is terminating. Otherwise reserve the job's dedicated cores, if any, and launch the child, then 
+ * answer with its pid, or with an error if too few cores were free or the child could not be launched, in which case the job's slot is 
+ * given back.
+ * 
+ * Input: Job to launch (job).
+ * 
+ * Output: Process ID of the child, or ERROR if the child could not be launched.
+ */
+pid_t launch_job(struct job *job);
+
+/*
+ * Function answer_job(): Answer the request a job arrived in once it has been launched, or will never be.
+ * 
+ * Algorithm: Answer a queued job of a batch with a MSG_DISPATCHED frame holding its index within the batch, its pid and JOB_STARTED, or 0 and 
+ * JOB_FAILED on error. Answer any other job with its pid in a MSG_STARTED frame, or the error in a MSG_ERROR frame.
+ * 
+ * Input: Job to answer (job), process ID of its child (c_pid) and description of the error, or NULL if the job was launched (error).
+ * 
+ * Output: None.
+ */
+void answer_job(struct job *job, pid_t c_pid, char *error);
+
+/*
+ * Function init_job(): Describe a launch by the buffers of the request it arrived in.
+ * 
+ * Algorithm: Fill the record without copying the buffers, which only live as long as the request.
+ * 
+ * Input: Record to fill (job), request to answer, or NULL if no answer is due (req), received batch, or NULL (buf), NULL-terminated array of 
+ * strings holding the executable file path and its arguments, or NULL for a batch (args), file paths of the output and logging redirection 
+ * files (out_file, log_file), time in milliseconds before SIGTERM is sent to child (SIGTERM_timeout), memory limit in bytes (mem_limit), 
+ * priority class (priority) and number of cores to dedicate to the job (num_cpus).
+ * 
+ * Output: None.
+ */
+void init_job(struct job *job, struct request *req, char *buf, char **args, char *out_file, char *log_file, long int SIGTERM_timeout, 
+              long int mem_limit, int priority, int num_cpus);
+
+/*
+ * Function keep_job(): Copy a job so that it outlives the request it arrived in, when it is held or queued.
+ * 
+ * Algorithm: Size an arena of a single block for the record and copies of its buffers, copy them into it, and take a reference to the job's 
+ * session if it has one.
+ * 
+ * Input: Job to copy (job).
+ * 
+ * Output: Pointer to the copy, freed by free_job().
+ */
+struct job *keep_job(struct job *job);
+
+/*
+ * Function schedule_job(): Reserve a slot for a job, or queue it if its class or all classes are at their concurrency limit.
+ * 
+ * Algorithm: If scheduling is disabled, do nothing. If the job's class has no job queued ahead of it and has_slot() allows it, count it as 
+ * running; otherwise append it to the queue of its class.
+ * 
+ * Input: Job to schedule (job), which is copied by keep_job() if it is queued.
+ * 
+ * Output: TRUE if the job has been queued, otherwise FALSE.
+ */
+int schedule_job(struct job *job);
+
+/*
+ * Function start_job(): Launch a job now, or queue it until a slot is free.
+ * 
+ * Algorithm: Schedule the job and, if it was not queued, launch it.
+ * 
+ * Input: Job to start (job).
+ * 
+ * Output: None.
+ */
+void start_job(struct job *job);
+
+/*
+ * Function launch_batch(): Launch every job of a batch and answer with the pid and status of each.
+ * 
+ * Algorithm: Split the batch into lines, skipping blank ones. Split each line like a single command and start it, recording JOB_INVALID for a mem 
+ * or memkill command, a line without a file or with an unclosed quote, an unknown priority class or more cores than the overseer may use, 
+ * JOB_QUEUED if the scheduler queued the job, and JOB_FAILED if the file could not be executed. Send every pid and status in a single 
+ * MSG_SUBMITTED frame. A queued job keeps the session, and is answered on its own by answer_job() once it has been dispatched.
+ * 
+ * Input: Batch of jobs separated by newlines (batch) and request it arrived in (req), whose arena holds the buffers.
+ * 
+ * Output: None.
+ */
+void launch_batch(char *batch, struct request *req);
+
+/*
+ * Function init_admission(): Subscribe to pressure notifications and create the admission thread.
+ * 
+ * Algorithm: For each resource with a threshold, open its pressure file and install a trigger which fires when some tasks stall on the 
+ * resource for more than the threshold of PSI_WINDOW_US, then register it with the admission thread's epoll instance.
+ * 
+ * Input: Pointer to store the admission thread identifier (admission_thread).
+ * 
+ * Output: 0 on success, or ERROR if a trigger could not be installed.
+ */
+int init_admission(pthread_t *admission_thread);
+
+/*
+ * Function init_scheduler(): Initialise the scheduler and create the dispatcher thread.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Pointer to store the dispatcher thread identifier (dispatcher_thread).
+ * 
+ * Output: None.
+ */
+void init_scheduler(pthread_t *dispatcher_thread);
+
+/*
+ * Function init_capture(): Initialise the capture list and create the capture thread.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Pointer to store the capture thread identifier (capture_thread).
+ * 
+ * Output: None.
+ */
+void init_capture(pthread_t *capture_thread);
+
+/*
+ * Function init_publisher(): Initialise the watch list and create the thread delivering child events to subscribers.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Pointer to the publisher thread identifier (publisher_thread).
+ * 
+ * Output: None.
+ */
+void init_publisher(pthread_t *publisher_thread);
+
+/*
+ * Function listen_to(): Listen for connections on socket.
+ * 
+ * Algorithm: Open a socket, allowing other sockets to be bound to the same port with SO_REUSEPORT, bind it, and start listening for 
+ * connections.
+ * 
+ * Input: Socket file descriptor (sock_fd), overseer port number (overseer_port) and number of pending connections the queue will hold 
+ * (backlog).
+ * 
+ * Output: None.
+ */
+void listen_to(int *sock_fd, int overseer_port, int backlog);
+
+/*
+ * Function resize_proc_table(): Rehash the process table into a new array of slots.
+ * 
+ * Algorithm: Take a table of at least twice the number of children, and at least PROC_TABLE_MIN_SLOTS, then reinsert every child, which 
+ * discards the tombstones. A table of the old capacity is the cleared spare, and the old table becomes the spare. A larger table is 
+ * allocated, the old table and spare are freed, and a spare of the new capacity is allocated with it.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void resize_proc_table();
+
+/*
+ * Function run_reactor(): Wait for and dispatch events until the overseer is instructed to terminate.
+ * 
+ * Algorithm: Block in epoll_wait() until an event arrives; if the listening socket is readable, accept every pending connection and open a 
+ * session for each; if a session is readable, read from it; if the signal file descriptor is readable, set quit, signal the other reactors 
+ * to stop and return; if the reactors have been signalled to stop, return. No wakeups occur while the overseer is idle.
+ * 
+ * Input: Reactor (reactor) and signal file descriptor, or NULL if the reactor does not handle SIGINT (signal_fd).
+ * 
+ * Output: None.
+ */
+void run_reactor(struct reactor *reactor, int *signal_fd);
+
+/*
+ * Function read_session(): Read the requests a controller has sent on a session.
+ * 
+ * Algorithm: On the first bytes, hand a legacy controller's connection to the workers whole. Otherwise receive everything available without 
+ * blocking, queue a request for each complete frame and keep any partial frame for later. Answer a malformed frame or one of another version 
+ * with MSG_ERROR and close the session, close it at the end of the connection, and pause it once SESSION_MAX_REQUESTS requests are in flight.
+ * 
+ * Input: Session to read from (session).
+ * 
+ * Output: None.
+ */
+void read_session(struct session *session);
+
+/*
+ * Function release_session(): Drop a reference to a session.
+ * 
+ * Algorithm: Decrement the reference count under the session's mutex and close the connection and free the session once no references remain.
+ * 
+ * Input: Session to release (session).
+ * 
+ * Output: None.
+ */
+void release_session(struct session *session);
+
+/*
+ * Function release_child(): Drop a reference to a child record.
+ * 
+ * Algorithm: Decrement the reference count under the child mutex and free the record once no references remain.
+ * 
+ * Input: Child to release (child).
+ * 
+ * Output: None.
+ */
+void release_child(struct child *child);
+
+/*
+ * Function read_memory_events(): Report the memory events of a child's cgroup which have occurred since they were last read.
+ * 
+ * Algorithm: Re-read the memory.events file, which also re-arms its notification, and parse its high and oom_kill counters. If either has 
+ * grown, log it and publish an EVENT_MEMORY_HIGH or EVENT_OOM_KILL event to the watch subscribers.
+ * 
+ * Input: Child whose cgroup's memory.events file has been modified (child).
+ * 
+ * Output: None.
+ */
+void read_memory_events(struct child *child);
+
+/*
+ * Function remove_child(): Remove a terminated child from the supervisor's list and table and release it.
+ * 
+ * Algorithm: Cancel the child's timers, remove its pidfd from the supervisor's epoll set and close it, stop watching its cgroup's memory.events 
+ * file and remove the cgroup, unlink the child from the doubly linked list, delete it from the process table, give back its scheduler slot 
+ * and dedicated cores, and drop the supervisor's reference to it.
+ * 
+ * Input: Supervisor's epoll file descriptor (epoll_fd), timing wheel (wheel) and child to remove (child).
+ * 
+ * Output: None.
+ */
+void remove_child(int epoll_fd, struct timer_wheel *wheel, struct child *child);
+
+/*
+ * Function lock_send(): Take a session's send mutex once no tailer is part way through a frame.
+ * 
+ * Algorithm: Lock the send mutex, then wait on the session's condition variable until no tailer holds the session, counted among the 
+ * writers waiting so that the tailer yields once its frame is finished.
+ * 
+ * Input: Session (session).
+ * 
+ * Output: None.
+ */
+void lock_send(struct session *session);
+
+/*
+ * Function send_replies(): Send frames to a session.
+ * 
+ * Algorithm: Under the session's send mutex, taken with lock_send(), send the frames with one call unless sending has already failed, and 
+ * mark the session as broken if it fails. Nothing is sent for a legacy controller. The frame buffer is emptied.
+ * 
+ * Input: Session to send to, NULL for a legacy controller (session) and frame buffer (frames).
+ * 
+ * Output: None.
+ */
+void send_replies(struct session *session, struct frame_buf *frames);
+
+/*
+ * Function send_reply(): Send a single frame answering a request to its session.
+ * 
+ * Algorithm: Encode the frame, tagged with the request's identifier, into the request's arena, or on the stack if it has none and the payload 
+ * fits REPLY_BUF_LEN, and send it with send_replies().
+ * 
+ * Input: Request (req), type of the message (type), payload (payload) and its length (len).
+ * 
+ * Output: None.
+ */
+void send_reply(struct request *req, int type, const void *payload, size_t len);
+
+/*
+ * Function sample_all(): Sample the memory usage of every child in the batch.
+ * 
+ * Algorithm: If the batch is larger than SAMPLER_BATCH_SIZE, split it into slices, hand all but the first to the helper threads, sample the first 
+ * and wait for the helpers; otherwise sample the whole batch.
+ * 
+ * Input: Number of children in the batch (num_children).
+ * 
+ * Output: None.
+ */
+void sample_all(int num_children);
+
+/*
+ * Function sample_slice(): Sample the memory usage of the children in one slice of the batch.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Index of the slice (slice), number of slices (num_slices) and number of children in the batch (num_children).
+ * 
+ * Output: None.
+ */
+void sample_slice(int slice, int num_slices, int num_children);
+
+/*
+ * Function stop_sampler(): Instruct the sampler threads to terminate and wait for them.
+ * 
+ * Algorithm: Set the batch's quit indicator, wake the sampler and its helpers, join them and free the batch arrays. The supervisor has freed 
+ * every child and the sampler has dropped its references, so the spare child records are freed too.
+ * 
+ * Input: Array of sampler thread IDs (sampler_threads).
+ * 
+ * Output: None.
+ */
+void stop_sampler(pthread_t *sampler_threads);
+
+/*
+ * Function publish_event(): Publish a child's start or exit to its subscribers.
+ * 
+ * Algorithm: Under the watch list's mutex, queue the event, stamped with the current time, for each subscriber watching the child.
+ * 
+ * Input: Kind of the event (kind), process ID of the child (c_pid) and exit status, or 0 (value).
+ * 
+ * Output: None.
+ */
+void publish_event(int kind, pid_t c_pid, long int value);
+
+/*
+ * Function publish_samples(): Publish the memory usage of the batch just sampled to the subscribers.
+ * 
+ * Algorithm: Under the watch list's mutex, queue a sample event for each child of the batch for each subscriber watching it.
+ * 
+ * Input: System time of the batch (raw_time) and number of children in the batch (num_children).
+ * 
+ * Output: None.
+ */
+void publish_samples(time_t raw_time, int num_children);
+
+/*
+ * Function prune_tailers(): Remove the tailers of a list whose sessions can no longer be delivered to.
+ * 
+ * Algorithm: Remove the tailers whose sessions are broken, or have stopped being read unless the overseer is terminating. The capture mutex 
+ * must be held.
+ * 
+ * Input: Pointer to the link to the first tailer of the list, that of a capture or of the draining tailers (tailers).
+ * 
+ * Output: None.
+ */
+void prune_tailers(struct tailer **tailers);
+
+/*
+ * Function prune_subscribers(): Remove the subscribers whose sessions can no longer be delivered to.
+ * 
+ * Algorithm: With the watch list's mutex held, unlink and free each subscriber whose session has stopped reading or failed to send, and release 
+ * its session.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void prune_subscribers();
+
+/*
+ * Function queue_event(): Queue an event for a subscriber if it watches the child concerned.
+ * 
+ * Algorithm: With the watch list's mutex held, append the event to the subscriber's ring buffer, dropping the oldest event if it is full, and 
+ * signal the publisher thread if the subscriber had nothing to deliver.
+ * 
+ * Input: Subscriber (subscriber) and event (event).
+ * 
+ * Output: None.
+ */
+void queue_event(struct subscriber *subscriber, struct watch_event *event);
+
+/*
+ * Function read_history(): Snapshot a child's memory history without blocking the sampler.
+ * 
+ * Algorithm: Wait for the child's sequence count to be even, copy the ring buffer and number of samples, and retry if the sequence count has 
+ * since changed.
+ * 
+ * Input: Child to read (child), to which the caller holds a reference, buffer of MEM_HISTORY_LEN samples to receive the snapshot (history) and 
+ * number of samples ever taken of the child (num_samples).
+ * 
+ * Output: None.
+ */
+void read_history(struct child *child, struct mem_sample *history, unsigned long int *num_samples);
+
+/*
+ * Function rotate_out_file(): Rotate the output file of a capture.
+ * 
+ * Algorithm: Rename the output file by appending ROTATED_SUFFIX, replacing any earlier rotated file, and open a new, empty output file.
+ * 
+ * Input: Capture (capture).
+ * 
+ * Output: None.
+ */
+void rotate_out_file(struct capture *capture);
+
+/*
+ * Function send_output(): Send a tailer as much of the output held in its pipe as its socket has room for, without ever blocking.
+ * 
+ * Algorithm: Give up if the session's send mutex is held or another tailer is part way through a frame. Otherwise, resume the frame left 
+ * unfinished, then, unless other writers are waiting for it, send the output as MSG_OUTPUT frames, each header followed by the payload spliced straight from the pipe into the 
+ * non-blocking socket, then any dropped bytes and, once the capture has finished, MSG_END, stopping when the socket is full. A tailer stopped 
+ * part way through a frame holds the session until it finishes it. A tailer with anything left waits for room in the socket through the 
+ * tailers' epoll instance.
+ * 
+ * Input: Tailer (tailer).
+ * 
+ * Output: TRUE if the tailer has sent MSG_END or sending to its session has failed, so it can be freed, otherwise FALSE.
+ */
+int send_output(struct tailer *tailer);
+
+/*
+ * Function send_mem_info_all(): Send memory information of all running processes to controller.
+ * 
+ * Algorithm: For a request from a session, encode a MSG_MEM_USAGE frame per process followed by MSG_END and send them with one call; for a 
+ * legacy controller, send a PATH_MAX text line per process. Stop sending if the controller has gone away.
+ * 
+ * Input: Currently running processes (proc_children), memory usage of currently running processes (mem_used), number of currently running 
+ * processes (num_procs) and request (req).
+ * 
+ * Output: None.
+ */
+void send_mem_info_all(struct child **proc_children, long int *mem_used, int num_procs, struct request *req);
+
+/*
+ * Function send_mem_info_id(): Send memory report for specified process ID.
+ * 
+ * Algorithm: Find the process and take a reference to it under the child mutex, snapshot its history without holding a lock, release it and 
+ * send each sample of the snapshot, oldest first, encoded as for send_mem_info_all().
+ * 
+ * Input: Process ID to send memory report for (proc_id) and request (req).
+ * 
+ * Output: None.
+ */
+void send_mem_info_id(pid_t proc_id, struct request *req);
+
+/*
+ * Function stop_admission(): Terminate the admission thread and reject the launches still held.
+ * 
+ * Algorithm: Set the quit flag, wake the admission thread and join it, then answer each held launch with MSG_ERROR, release its session and 
+ * free it, and close the file descriptors.
+ * 
+ * Input: Admission thread identifier (admission_thread).
+ * 
+ * Output: None.
+ */
+void stop_admission(pthread_t admission_thread);
+
+/*
+ * Function stop_scheduler(): Terminate the dispatcher thread and reject the jobs still queued.
+ * 
+ * Algorithm: Set the quit flag, signal the dispatcher thread and join it, then answer each queued job with an error if an answer is due and 
+ * free it.
+ * 
+ * Input: Dispatcher thread identifier (dispatcher_thread).
+ * 
+ * Output: None.
+ */
+void stop_scheduler(pthread_t dispatcher_thread);
+
+/*
+ * Function stop_capture(): Move the output still waiting and terminate the capture thread.
+ * 
+ * Algorithm: Set the quit flag, wake the capture thread and join it, then close its file descriptors and free the spare captures.
+ * 
+ * Input: Capture thread identifier (capture_thread).
+ * 
+ * Output: None.
+ */
+void stop_capture(pthread_t capture_thread);
+
+/*
+ * Function stop_publisher(): Instruct the publisher thread to terminate, then end every subscription.
+ * 
+ * Algorithm: Set the quit flag, wait for the publisher thread, then send MSG_END to each subscriber, release its session and free it.
+ * 
+ * Input: Publisher thread identifier (publisher_thread).
+ * 
+ * Output: None.
+ */
+void stop_publisher(pthread_t publisher_thread);
+
+/*
+ * Function wake_capture(): Wake the capture thread.
+ * 
+ * Algorithm: Set the prune flag if requested and write to the capture thread's event file descriptor.
+ * 
+ * Input: Indicator of if a session has closed, so its tailers are to be removed (prune).
+ * 
+ * Output: None.
+ */
+void wake_capture(int prune);
+
+/*
+ * Function wake_publisher(): Wake the publisher thread.
+ * 
+ * Algorithm: Under the watch list's mutex, request a prune if applicable and signal the publisher thread.
+ * 
+ * Input: Indicator of if a session has closed, so its subscribers are to be removed (prune).
+ * 
+ * Output: None.
+ */
+void wake_publisher(int prune);
+
+/*
+ * Function wake_supervisor(): Wake the supervisor.
+ * 
+ * Algorithm: Write to the supervisor's event file descriptor.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void wake_supervisor();
+
+/*
+ * Function publish_events(): Delivers the events queued for each subscriber.
+ * 
+ * Algorithm: Wait until a subscriber has events, a session has closed or the thread is instructed to terminate. Remove the subscribers of closed 
+ * sessions, then for each subscriber with events, encode a MSG_EVENT frame for each (preceded by one counting any dropped events), empty its 
+ * buffer and send the frames with the mutex released.
+ * 
+ * Input: Unused (void_var).
+ * 
+ * Output: NULL.
+ */
+void *publish_events(void *void_var);
+
+/*
+ * Function capture_output(): Capture thread, which moves the output of every captured child.
+ * 
+ * Algorithm: Wait on the epoll file descriptor for output to arrive in a pipe, and move it. Once a child's pipe has hung up, finish its 
+ * capture. Remove the tailers of closed sessions when instructed. Once instructed to terminate, move the output still waiting and finish 
+ * every capture.
+ * 
+ * Input: Unused (void_var).
+ * 
+ * Output: NULL.
+ */
+void *capture_output(void *void_var);
+
+/*
+ * Function write_logs(): Log writer thread, which writes the lines queued by every other thread.
+ * 
+ * Algorithm: Wait on the event file descriptor until the queue stops being empty, take every queued entry at once, reverse them into the order 
+ * they were logged and write them. Terminate once the quit flag is set and the queue is empty.
+ * 
+ * Input: Unused (void_var).
+ * 
+ * Output: NULL.
+ */
+void *write_logs(void *void_var);
+
+/*
+ * Function help_sample(): Samples one slice of each large batch on behalf of the sampler thread.
+ * 
+ * Algorithm: Wait for a new batch which includes this thread's slice, sample the slice and signal the sampler when every helper has finished.
+ * 
+ * Input: Index of the slice sampled by this thread (void_var).
+ * 
+ * Output: None.
+ */
+void *help_sample(void *void_var);
+
+/*
+ * Function sample_children(): Samples the memory usage of every running child once per tick.
+ * 
+ * Algorithm: Sleep until the next one-second tick (or indefinitely while there are no children), take a reference to every child which has not 
+ * been sent SIGTERM, sample them all as one batch, commit the samples to the children's histories and release the references.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void *sample_children(void *void_var);
+
+/*
+ * Function admit_jobs(): Hold launches while pressure is above a threshold, and release them once it drops.
+ * 
+ * Algorithm: Sleep until a trigger fires, then hold launches and check every ADMISSION_INTERVAL_MS how long tasks have stalled on each 
+ * watched resource since the last check. Once every resource is below its threshold, stop holding launches and release the held ones in the 
+ * order they arrived. Terminate once the quit flag is set.
+ * 
+ * Input: Unused (void_var).
+ * 
+ * Output: NULL.
+ */
+void *admit_jobs(void *void_var);
+
+/*
+ * Function dispatch_jobs(): Start queued jobs as running jobs finish.
+ * 
+ * Algorithm: Wait until a running job finishes, then take the first queued job of the highest priority class which has_slot() allows, count 
+ * it as running, and launch it without holding the mutex. Repeat until no queued job may start, and terminate once the quit flag is set.
+ * 
+ * Input: Unused (void_var).
+ * 
+ * Output: NULL.
+ */
+void *dispatch_jobs(void *void_var);
+
+/*
+ * Function finish_job(): Give back the slot of a job which has finished, or could not be launched.
+ * 
+ * Algorithm: If scheduling is enabled, decrement the running counts of the job's class and of all classes and signal the dispatcher.
+ * 
+ * Input: Priority class of the job (priority).
+ * 
+ * Output: None.
+ */
+void finish_job(int priority);
+
+/*
+ * Function parse_limits(): Parse the concurrency limits of the -j option.
+ * 
+ * Algorithm: Parse each comma-separated "class=count" suboption, where class is a name of scheduler.names and count is positive, and enable 
+ * scheduling.
+ * 
+ * Input: Argument of the -j option (optarg).
+ * 
+ * Output: 0 on success, or ERROR if a suboption is invalid.
+ */
+int parse_limits(char *optarg);
+
+/*
+ * Function parse_pressure(): Parse the thresholds of the -p option.
+ * 
+ * Algorithm: Parse each comma-separated "resource=percent" suboption, where resource is a name of admission.names and percent is in (0, 100], 
+ * and enable admission control.
+ * 
+ * Input: Argument of the -p option (optarg).
+ * 
+ * Output: 0 on success, or ERROR if a suboption is invalid.
+ */
+int parse_pressure(char *optarg);
+
+/*
+ * Function read_stall(): Read the total time some tasks have stalled on a resource.
+ * 
+ * Algorithm: Re-read the pressure file and parse the total of its "some" line.
+ * 
+ * Input: File descriptor of the pressure file (psi_fd).
+ * 
+ * Output: Total stall time in microseconds, or ERROR if the file could not be read.
+ */
+long int read_stall(int psi_fd);
+
+/*
+ * Function release_jobs(): Launch the held launches in the order they arrived, for as long as launches are not held.
+ * 
+ * Algorithm: Take each held launch from the head of the list and launch its batch, or start its job through the scheduler.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void release_jobs();
+
+/*
+ * Function supervise_children(): Owns and oversees every running child. 
+ * 
+ * Algorithm: Sleep until woken, until a child terminates or until the next timer expires. Reap children as soon as their pidfd becomes 
+ * readable (or, where pidfds are not supported, when SIGCHLD is received), adopt pending children (waking the sampler if they are the first) and 
+ * arm their timers, and run expired timers from the timing wheel. Once the overseer has been instructed to terminate, kill every child and return when none remain.
+ * 
+ * Input: None.
+ * 
+ * Output: None.
+ */
+void *supervise_children(void *void_var);
+
+/*
+ * Function accept_connections(): Run a reactor on its own thread.
+ * 
+ * Algorithm: As above.
+ * 
+ * Input: Reactor of the thread (void_var).
+ * 
+ * Output: None.
+ */
+void *accept_connections(void *void_var);
+
+/*
+ * Function handle_requests(): Retrieves requests from the queues and handles them. 
+ * 
+ * Algorithm: While the workers haven't been instructed to terminate, get a request and execute it, or idle until one is queued.
+ * 
+ * Input: Worker of the thread (void_var).
  * 
  * Output: None.
  */
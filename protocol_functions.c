@@ -0,0 +1,281 @@
+/* This source file defines all of the functions of the wire protocol shared by overseer.c and controller.c */
+
+/* Include Directives */
+
+#include <arpa/inet.h>              // Definitions for internet operations.
+#include <endian.h>                 // Functions for converting between host and big-endian byte order.
+#include <errno.h>                  // Defines macros for values that are used for error reporting.
+#include <poll.h>                   // Definitions for the poll() function.
+#include <stdlib.h>                 // Standard library definitions.
+#include <string.h>                 // String manipulation functions.
+#include <sys/socket.h>             // Main sockets header.
+#include "protocol_functions.h"     // Defines all of the macros and declares all of the functions of the wire protocol.
+
+/* Function Definitions */
+
+int decode_header(const void *buf, struct frame_header *header)
+{
+    memcpy(header, buf, FRAME_HEADER_LEN);
+
+    if (ntohs(header->magic) != PROTOCOL_MAGIC)
+    {
+        return ERROR;
+    }
+
+    header->magic = PROTOCOL_MAGIC;
+    header->length = ntohl(header->length);
+    header->id = ntohl(header->id);
+
+    return 0;
+}
+
+int next_token(char **pos, char **token)
+{
+    char quote = '\0';      // Quote character of the quoted string being read, or NUL outside quotes.
+    char *read = *pos;      // Position of the next character of the command.
+    char *write;            // Position of the next character of the token, which never runs ahead of read.
+
+    read += strspn(read, TOKEN_DELIMITERS);
+
+    if (*read == '\0')
+    {
+        *pos = read;
+        return FALSE;
+    }
+
+    *token = write = read;
+
+    for (; *read != '\0' && (quote != '\0' || strchr(TOKEN_DELIMITERS, *read) == NULL); read++)
+    {
+        /* A backslash escapes any character outside quotes, only a double quote or backslash within double quotes, and nothing within 
+         * single quotes. */
+        if (*read == '\\' && read[1] != '\0' && (quote == '\0' || (quote == '"' && (read[1] == '"' || read[1] == '\\'))))
+        {
+            *write++ = *++read;
+        }
+        else if (quote != '\0' && *read == quote)
+        {
+            quote = '\0';
+        }
+        else if (quote == '\0' && (*read == '"' || *read == '\''))
+        {
+            quote = *read;
+        }
+        else
+        {
+            *write++ = *read;
+        }
+    }
+
+    if (quote != '\0')
+    {
+        return ERROR;
+    }
+
+    *pos = *read != '\0' ? read + 1 : read;
+    *write = '\0';
+
+    return TRUE;
+}
+
+int recv_all(int sock_fd, void *buf, size_t len)
+{
+    ssize_t num_bytes; // Number of bytes received by the current call.
+
+    while (len > 0)
+    {
+        if ((num_bytes = recv(sock_fd, buf, len, 0)) == ERROR && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (num_bytes <= 0)
+        {
+            return ERROR;
+        }
+
+        buf = (char *)buf + num_bytes;
+        len -= num_bytes;
+    }
+
+    return 0;
+}
+
+int recv_frame(int sock_fd, struct frame_header *header, void *payload, size_t max_len)
+{
+    char buf[FRAME_HEADER_LEN]; // Received header.
+
+    if (recv_all(sock_fd, buf, FRAME_HEADER_LEN) == ERROR || decode_header(buf, header) == ERROR)
+    {
+        return ERROR;
+    }
+
+    /* The payload of a frame from another version is left unread, as its layout is unknown. */
+    if (header->version != PROTOCOL_VERSION)
+    {
+        return 0;
+    }
+
+    if (header->length > max_len || recv_all(sock_fd, payload, header->length) == ERROR)
+    {
+        return ERROR;
+    }
+
+    return header->length;
+}
+
+int send_all(int sock_fd, const void *buf, size_t len)
+{
+    ssize_t num_bytes;                          // Number of bytes sent by the current call.
+    struct pollfd poll_fd = {sock_fd, POLLOUT, 0};  // Socket, waited on while it is full.
+
+    while (len > 0)
+    {
+        if ((num_bytes = send(sock_fd, buf, len, MSG_NOSIGNAL)) == ERROR)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            /* A non-blocking socket is waited on until it has room, so callers see the same behaviour whichever kind they pass. */
+            if ((errno == EAGAIN || errno == EWOULDBLOCK) && (poll(&poll_fd, 1, ERROR) != ERROR || errno == EINTR))
+            {
+                continue;
+            }
+
+            return ERROR;
+        }
+
+        buf = (const char *)buf + num_bytes;
+        len -= num_bytes;
+    }
+
+    return 0;
+}
+
+int send_frame(int sock_fd, int type, uint32_t id, const void *payload, size_t len)
+{
+    int result;                             // Result of sending the frame.
+    struct frame_buf frames = {NULL, 0, 0}; // Buffer holding the encoded frame.
+
+    add_frame(&frames, type, id, payload, len);
+    result = send_frames(sock_fd, &frames);
+    free_frames(&frames);
+
+    return result;
+}
+
+int send_frames(int sock_fd, struct frame_buf *frames)
+{
+    int result = send_all(sock_fd, frames->data, frames->len); // Result of sending the frames.
+
+    frames->len = 0;
+
+    return result;
+}
+
+int64_t get_be64(const void *buf)
+{
+    uint64_t value; // Encoded integer.
+
+    memcpy(&value, buf, sizeof(value));
+
+    return be64toh(value);
+}
+
+int32_t get_be32(const void *buf)
+{
+    uint32_t value; // Encoded integer.
+
+    memcpy(&value, buf, sizeof(value));
+
+    return ntohl(value);
+}
+
+char *quote_arg(char *buf, const char *arg)
+{
+    /* An argument which the tokenizer would split or unquote is wrapped in double quotes, escaping the characters special within them. */
+    if (*arg != '\0' && arg[strcspn(arg, TOKEN_DELIMITERS "\"'\\")] == '\0')
+    {
+        return stpcpy(buf, arg);
+    }
+
+    *buf++ = '"';
+
+    for (; *arg != '\0'; arg++)
+    {
+        if (*arg == '"' || *arg == '\\')
+        {
+            *buf++ = '\\';
+        }
+
+        *buf++ = *arg;
+    }
+
+    *buf++ = '"';
+    *buf = '\0';
+
+    return buf;
+}
+
+void add_frame(struct frame_buf *frames, int type, uint32_t id, const void *payload, size_t len)
+{
+    if (frames->len + FRAME_HEADER_LEN + len > frames->capacity)
+    {
+        while (frames->len + FRAME_HEADER_LEN + len > frames->capacity)
+        {
+            frames->capacity = frames->capacity ? frames->capacity * 2 : MAX_PAYLOAD_LEN;
+        }
+
+        if ((frames->data = realloc(frames->data, frames->capacity)) == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    encode_header(frames->data + frames->len, type, id, len);
+
+    if (len)
+    {
+        memcpy(frames->data + frames->len + FRAME_HEADER_LEN, payload, len);
+    }
+
+    frames->len += FRAME_HEADER_LEN + len;
+}
+
+void encode_header(void *buf, int type, uint32_t id, size_t len)
+{
+    struct frame_header header; // Header of the frame.
+
+    header.magic = htons(PROTOCOL_MAGIC);
+    header.version = PROTOCOL_VERSION;
+    header.type = type;
+    header.length = htonl(len);
+    header.id = htonl(id);
+
+    memcpy(buf, &header, FRAME_HEADER_LEN);
+}
+
+void free_frames(struct frame_buf *frames)
+{
+    free(frames->data);
+
+    frames->data = NULL;
+    frames->len = 0;
+    frames->capacity = 0;
+}
+
+void put_be64(void *buf, int64_t value)
+{
+    uint64_t encoded = htobe64(value); // Encoded integer.
+
+    memcpy(buf, &encoded, sizeof(encoded));
+}
+
+void put_be32(void *buf, int32_t value)
+{
+    uint32_t encoded = htonl(value); // Encoded integer.
+
+    memcpy(buf, &encoded, sizeof(encoded));
+}
@@ -0,0 +1,251 @@
+/* This header file defines all of the macros and declares all of the functions of the wire protocol shared by overseer.c and controller.c */
+
+#ifndef __PROTOCOL_FUNCTIONS_H__
+#define __PROTOCOL_FUNCTIONS_H__
+
+/* Include Directives */
+
+#include <stddef.h>                 // Defines size_t.
+#include <stdint.h>                 // Defines exact-width integer types.
+
+/* Macro Definitions */
+
+#define ERROR -1                    // Typical value returned by various functions to indicate error.
+#define DISPATCHED_LEN 12           // Length of a MSG_DISPATCHED payload: index of the job within its batch (4 bytes), pid (4 bytes) and status (4 bytes).
+#define EVENT_DROPPED 3             // Kind of a MSG_EVENT counting the events dropped because the subscriber fell behind; value is the count.
+#define EVENT_EXITED 2              // Kind of a MSG_EVENT reporting that a process has exited; value is its exit status.
+#define EVENT_KILLED 7              // Kind of a MSG_EVENT reporting that a process has been killed by a signal; value is the signal number.
+#define EVENT_LEN 24                // Length of a MSG_EVENT payload: kind (4 bytes), pid (4 bytes), time (8 bytes) and value (8 bytes).
+#define EVENT_MEMORY_HIGH 5         // Kind of a MSG_EVENT reporting that a process' cgroup has been throttled for exceeding memory.high; value is the count.
+#define EVENT_SAMPLE 0              // Kind of a MSG_EVENT reporting a memory usage sample; value is the memory usage.
+#define EVENT_OOM_KILL 6            // Kind of a MSG_EVENT reporting that a process of a cgroup has been killed for exceeding memory.max; value is the count.
+#define EVENT_OUTPUT_DROPPED 4      // Kind of a MSG_EVENT counting the bytes of output dropped because the tailer fell behind; value is the count.
+#define EVENT_STARTED 1             // Kind of a MSG_EVENT reporting that a process has been launched.
+#define FALSE 0                     // Integer representation of truth-value false.
+#define FRAME_HEADER_LEN 12         // Length of a frame header on the wire.
+#define JOB_FAILED 1                // Status of a job of a batch whose file could not be executed.
+#define JOB_INVALID 2               // Status of a job of a batch which is not an executable command.
+#define JOB_QUEUED 3                // Status of a job of a batch which waits for a slot of the scheduler, and whose pid follows in a MSG_DISPATCHED.
+#define JOB_STARTED 0               // Status of a job of a batch which has been launched.
+#define JOB_STATUS_LEN 8            // Length of the entry for one job in a MSG_SUBMITTED payload: pid (4 bytes) and status (4 bytes).
+#define MAX_PAYLOAD_LEN 65536       // Maximum length of the payload of a single frame.
+#define MEM_SAMPLE_LEN 16           // Length of a MSG_MEM_SAMPLE payload: time (8 bytes) and memory usage (8 bytes).
+#define MEM_USAGE_LEN 12            // Length of the fixed part of a MSG_MEM_USAGE payload: pid (4 bytes) and memory usage (8 bytes).
+#define MSG_EXEC 1                  // Request to execute a file; payload is the command text.
+#define MSG_MEM 2                   // Request for memory information; payload is a pid (4 bytes), 0 for every process.
+#define MSG_MEMKILL 3               // Request to kill processes above a memory threshold; payload is the percentage in hundredths (4 bytes).
+#define MSG_MEM_USAGE 4             // Reply describing one process; payload is a pid, memory usage and the file and arguments.
+#define MSG_MEM_SAMPLE 5            // Reply describing one sample of a process' memory history.
+#define MSG_END 6                   // Reply marking the end of the replies to a request; no payload.
+#define MSG_ERROR 7                 // Reply describing why a request was rejected; payload is the message text.
+#define MSG_STARTED 8               // Reply describing a launched process; payload is its pid (4 bytes).
+#define MSG_SUBMIT 9                // Request to launch a batch of jobs; payload is one command per line.
+#define MSG_SUBMITTED 10            // Reply to MSG_SUBMIT; payload is the pid (0 if none) and status (JOB_*) of each job, in order.
+#define MSG_WATCH 11                // Request to subscribe to process events; payload is a pid (4 bytes), 0 for every process.
+#define MSG_EVENT 12                // Event pushed to a subscriber until its connection closes, or MSG_END when the overseer terminates.
+#define MSG_TAIL 13                 // Request to stream the output of a captured process; payload is a pid (4 bytes).
+#define MSG_OUTPUT 14               // Output of a tailed process; payload is the bytes written by the process, at most MAX_PAYLOAD_LEN.
+#define MSG_WATCHDOG 15             // Request to query (no payload), remove (pid) or install (WATCHDOG_LEN) a watchdog policy; pid 0 is global.
+#define MSG_POLICY 16               // Reply describing one watchdog policy, the global one first; payload is POLICY_LEN bytes.
+#define MSG_DISPATCHED 17           // Reply describing a queued job of a batch once it has been launched; payload is DISPATCHED_LEN bytes.
+#define POLICY_LEN 24               // Length of a MSG_POLICY payload: pid (4 bytes), percentage in hundredths (4 bytes), grace period in milliseconds (8 bytes) and actions taken (8 bytes).
+#define PROTOCOL_MAGIC 0xC0DE       // First two bytes of every frame, which can never begin a legacy text command.
+#define PROTOCOL_VERSION 2          // Version of the protocol spoken by this build.
+#define SESSION_MAX_REQUESTS 64     // Number of requests a session may have in flight before the overseer stops reading from it.
+#define TOKEN_DELIMITERS " \t"      // Characters separating the arguments of a command, outside quotes.
+#define TRUE 1                      // Integer representation of truth-value true.
+#define WATCHDOG_LEN 16             // Length of a MSG_WATCHDOG payload installing a policy: pid (4 bytes), percentage in hundredths (4 bytes) and grace period in milliseconds (8 bytes).
+
+/* Structure Definitions */
+
+struct frame_header // Structure describing the header which precedes every frame, whose fields are in network byte order on the wire.
+{
+    uint16_t magic;     // PROTOCOL_MAGIC.
+    uint8_t version;    // PROTOCOL_VERSION of the sender.
+    uint8_t type;       // Type of the message (MSG_*).
+    uint32_t length;    // Length of the payload which follows.
+    uint32_t id;        // Identifier of the request, chosen by the controller and echoed on every reply to it.
+};
+
+struct frame_buf // Structure describing a buffer of encoded frames to be sent with a single call.
+{
+    char *data;         // Encoded frames.
+    size_t len;         // Number of bytes of encoded frames.
+    size_t capacity;    // Capacity of data.
+};
+
+/* Function Declarations */
+
+/*
+ * Function decode_header(): Decode a frame header received into a buffer.
+ *
+ * Algorithm: Copy the header out of the buffer, check the magic and convert the fields to host byte order.
+ *
+ * Input: Buffer holding at least FRAME_HEADER_LEN bytes (buf) and header to decode into (header).
+ *
+ * Output: 0 on success, or ERROR if the buffer does not start with PROTOCOL_MAGIC.
+ */
+int decode_header(const void *buf, struct frame_header *header);
+
+/*
+ * Function next_token(): Split the next argument off a command, as sent in a MSG_EXEC payload, a batch or a line of a manifest.
+ *
+ * Algorithm: Skip TOKEN_DELIMITERS, then read up to the next delimiter outside quotes in a single pass. Single quotes preserve every character 
+ * up to the closing quote, double quotes preserve every character but a backslash escaping a double quote or backslash, and a backslash outside 
+ * quotes escapes any character. The quotes and escaping backslashes are removed by moving the token back over them within the command, and 
+ * the token is NUL-terminated where it ends, so nothing is copied out of the command or allocated.
+ *
+ * Input: Pointer to the position in the command at which to continue, which is advanced past the token (pos), and pointer to receive the 
+ * token, which points into the command (token).
+ *
+ * Output: TRUE if a token was found, FALSE at the end of the command, or ERROR if a quote is not closed.
+ */
+int next_token(char **pos, char **token);
+
+/*
+ * Function recv_all(): Receive exactly the specified number of bytes.
+ *
+ * Algorithm: Call recv() until all the bytes have been received, retrying if interrupted.
+ *
+ * Input: Socket file descriptor (sock_fd), buffer (buf) and number of bytes to receive (len).
+ *
+ * Output: 0 on success, or ERROR if an error occurred or the peer closed the connection first.
+ */
+int recv_all(int sock_fd, void *buf, size_t len);
+
+/*
+ * Function recv_frame(): Receive a single frame.
+ *
+ * Algorithm: Receive and decode the header, then receive the payload into the buffer. A frame whose payload would not fit is rejected.
+ *
+ * Input: Socket file descriptor (sock_fd), header to receive (header), buffer to receive the payload (payload) and its capacity (max_len).
+ *
+ * Output: Length of the payload, or ERROR if the frame could not be received or is malformed. If the peer speaks a different version, the
+ * header is still received so the caller can report it.
+ */
+int recv_frame(int sock_fd, struct frame_header *header, void *payload, size_t max_len);
+
+/*
+ * Function send_all(): Send exactly the specified number of bytes.
+ *
+ * Algorithm: Call send() with MSG_NOSIGNAL until all the bytes have been sent, retrying if interrupted, so that a peer which has gone away
+ * causes an error rather than SIGPIPE. A non-blocking socket which is full is polled until it has room.
+ *
+ * Input: Socket file descriptor (sock_fd), buffer (buf) and number of bytes to send (len).
+ *
+ * Output: 0 on success, or ERROR if an error occurred.
+ */
+int send_all(int sock_fd, const void *buf, size_t len);
+
+/*
+ * Function send_frame(): Send a single frame.
+ *
+ * Algorithm: Encode the frame into a frame buffer and flush it.
+ *
+ * Input: Socket file descriptor (sock_fd), type of the message (type), identifier of the request (id), payload (payload) and its length (len).
+ *
+ * Output: 0 on success, or ERROR if an error occurred.
+ */
+int send_frame(int sock_fd, int type, uint32_t id, const void *payload, size_t len);
+
+/*
+ * Function send_frames(): Send every frame held in a frame buffer and empty it.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Socket file descriptor (sock_fd) and frame buffer (frames).
+ *
+ * Output: 0 on success, or ERROR if an error occurred.
+ */
+int send_frames(int sock_fd, struct frame_buf *frames);
+
+/*
+ * Function get_be64(): Decode a 64-bit integer stored in network byte order.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointer to the encoded integer (buf).
+ *
+ * Output: Decoded integer.
+ */
+int64_t get_be64(const void *buf);
+
+/*
+ * Function get_be32(): Decode a 32-bit integer stored in network byte order.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointer to the encoded integer (buf).
+ *
+ * Output: Decoded integer.
+ */
+int32_t get_be32(const void *buf);
+
+/*
+ * Function quote_arg(): Write an argument so that next_token() reads it back unchanged.
+ *
+ * Algorithm: Copy an argument without delimiters, quotes or backslashes as it is, and wrap any other argument in double quotes, escaping the 
+ * double quotes and backslashes within it.
+ *
+ * Input: Buffer with room for at least twice the length of the argument and three more bytes (buf) and argument to write (arg).
+ *
+ * Output: Pointer to the NUL terminating the written argument.
+ */
+char *quote_arg(char *buf, const char *arg);
+
+/*
+ * Function add_frame(): Encode a frame onto the end of a frame buffer.
+ *
+ * Algorithm: Grow the buffer if necessary, then append the header and payload.
+ *
+ * Input: Frame buffer (frames), type of the message (type), identifier of the request (id), payload (payload) and its length (len).
+ *
+ * Output: None.
+ */
+void add_frame(struct frame_buf *frames, int type, uint32_t id, const void *payload, size_t len);
+
+/*
+ * Function encode_header(): Encode a frame header into a buffer.
+ *
+ * Algorithm: Convert the fields to network byte order and copy the header into the buffer.
+ *
+ * Input: Buffer of at least FRAME_HEADER_LEN bytes (buf), message type (type), request id (id) and payload length (len).
+ *
+ * Output: None.
+ */
+void encode_header(void *buf, int type, uint32_t id, size_t len);
+
+/*
+ * Function free_frames(): Free the memory held by a frame buffer.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Frame buffer (frames).
+ *
+ * Output: None.
+ */
+void free_frames(struct frame_buf *frames);
+
+/*
+ * Function put_be64(): Encode a 64-bit integer in network byte order.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointer to the destination (buf) and integer to encode (value).
+ *
+ * Output: None.
+ */
+void put_be64(void *buf, int64_t value);
+
+/*
+ * Function put_be32(): Encode a 32-bit integer in network byte order.
+ *
+ * Algorithm: As above.
+ *
+ * Input: Pointer to the destination (buf) and integer to encode (value).
+ *
+ * Output: None.
+ */
+void put_be32(void *buf, int32_t value);
+
+#endif // __PROTOCOL_FUNCTIONS_H__
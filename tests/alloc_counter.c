@@ -0,0 +1,119 @@
+/* This source file defines a malloc interposer, preloaded into the overseer by the allocation test, which counts its heap allocations */
+
+/* Include Directives */
+
+#include <errno.h>                      // Defines macros for values that are used for error reporting.
+#include <fcntl.h>                      // File control options.
+#include <stdlib.h>                     // Standard library definitions.
+#include <sys/mman.h>                   // Declares memory mapping functions.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "alloc_counter.h"              // Defines the layout of the counters shared with the allocation test.
+
+/* Global Variables */
+
+long int *counts = NULL;                // Counters shared with the allocation test, or NULL until they have been mapped.
+
+/* Function Declarations */
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+
+/* Function Definitions */
+
+/*
+ * Function map_counts(): Map the counters shared with the allocation test when the interposer is loaded.
+ *
+ * Algorithm: Map the file named by ALLOC_COUNT_ENV, and remove the interposer from the environment, so that the children the overseer launches
+ * neither load it nor add to the counters. Allocations made before the file is mapped are not counted.
+ *
+ * Input: None.
+ *
+ * Output: None.
+ */
+__attribute__((constructor)) void map_counts()
+{
+    int fd;                                 // File descriptor of the counters file.
+    long int *mapped;                       // Counters, once mapped.
+
+    char *path = getenv(ALLOC_COUNT_ENV);   // Path of the counters file.
+
+    unsetenv("LD_PRELOAD");
+
+    if (path == NULL || (fd = open(path, O_RDWR | O_CLOEXEC)) == -1)
+    {
+        return;
+    }
+
+    if ((mapped = mmap(NULL, NUM_COUNTS * sizeof(long int), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) != MAP_FAILED)
+    {
+        counts = mapped;
+    }
+
+    close(fd);
+}
+
+/*
+ * Function count(): Count a call to the allocator.
+ *
+ * Algorithm: Atomically increment the counter, as every thread of the overseer allocates.
+ *
+ * Input: Index of the counter (index).
+ *
+ * Output: None.
+ */
+void count(int index)
+{
+    if (counts != NULL)
+    {
+        __atomic_add_fetch(&counts[index], 1, __ATOMIC_RELAXED);
+    }
+}
+
+/* Each entry point of the allocator counts the call and hands it to glibc's own implementation. */
+void *malloc(size_t size)
+{
+    count(COUNT_ALLOCS);
+
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size)
+{
+    count(COUNT_ALLOCS);
+
+    return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    count(COUNT_ALLOCS);
+
+    return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    count(COUNT_ALLOCS);
+
+    return (*ptr = __libc_memalign(alignment, size)) == NULL ? ENOMEM : 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    count(COUNT_ALLOCS);
+
+    return __libc_memalign(alignment, size);
+}
+
+void free(void *ptr)
+{
+    if (ptr != NULL)
+    {
+        count(COUNT_FREES);
+    }
+
+    __libc_free(ptr);
+}
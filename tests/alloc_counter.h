@@ -0,0 +1,13 @@
+/* This header file defines the layout of the allocation counters shared by the malloc interposer and the allocation test */
+
+#ifndef __ALLOC_COUNTER_H__
+#define __ALLOC_COUNTER_H__
+
+/* Macro Definitions */
+
+#define ALLOC_COUNT_ENV "ALLOC_COUNT_FILE"  // Environment variable naming the file the counters are mapped from.
+#define COUNT_ALLOCS 0                      // Index of the counter of calls allocating memory.
+#define COUNT_FREES 1                       // Index of the counter of calls freeing memory.
+#define NUM_COUNTS 2                        // Number of counters.
+
+#endif
@@ -0,0 +1,204 @@
+/* This source file tests that the overseer makes no heap allocations while it answers requests, launches children and samples them in steady 
+ * state */
+
+/* Include Directives */
+
+#include <fcntl.h>                      // File control options.
+#include <linux/limits.h>               // Implementation-defined constants.
+#include <stdio.h>                      // Functions that deal with standard input and output.
+#include <stdlib.h>                     // Standard library definitions.
+#include <string.h>                     // String manipulation functions.
+#include <sys/mman.h>                   // Declares memory mapping functions.
+#include <unistd.h>                     // Declares a number of implementation-specific functions.
+#include "../bench/bench_functions.h"   // Defines all of the macros and declares all of the functions shared by the benchmarks.
+#include "../protocol_functions.h"      // Defines all of the macros and declares all of the functions of the wire protocol.
+#include "alloc_counter.h"              // Defines the layout of the counters shared with the malloc interposer.
+
+/* Macro Definitions */
+
+#define BATCH_COMMANDS "/bin/true\n/bin/true"    // Commands of the batches launched during the test, one per line.
+#define BATCH_INTERVAL 64               // Number of requests per batch launched.
+#define COUNTER_PATH "tests/alloc_counter.so"   // Path of the malloc interposer, as the test is run from the top directory of the repository.
+#define DEFAULT_REQUESTS 2000           // Number of requests counted, by default.
+#define DEPTH 32                        // Number of requests kept in flight, below the overseer's limit of 64.
+#define EXEC_COMMAND "-log " LOG_FILE " /bin/true"  // Command of the children launched during the test, which exit at once.
+#define EXEC_INTERVAL 16                // Number of requests per child launched.
+#define JOB_FILE "/bin/sleep 3600"      // Command of the child sampled during the test, which is killed with the overseer.
+#define LOG_FILE "/tmp/alloc_test.log"  // Logging redirection file of the children launched during the test.
+#define SETTLE_US 2500000               // Time in microseconds left for launched children to exit and the sampler to sample the child twice.
+#define TEST_PORT 47401                 // Port the overseer listens on, unless another is given with -P.
+#define WARMUP_REQUESTS 200             // Number of requests sent before counting, so that every buffer has reached its steady size.
+
+/* Function Definitions */
+
+/*
+ * Function run_requests(): Send requests over a session and wait for all of them to be answered.
+ *
+ * Algorithm: Keep DEPTH requests in flight, sending a further request each time one is given its final reply. Every EXEC_INTERVAL-th 
+ * request launches EXEC_COMMAND and every BATCH_INTERVAL-th a batch of BATCH_COMMANDS; the others are MSG_MEM requests, alternating between 
+ * every process and the sampled child. Exits if a launch fails.
+ *
+ * Input: Socket file descriptor (sock_fd), process ID of the sampled child (c_pid) and number of requests (num_requests).
+ *
+ * Output: None.
+ */
+void run_requests(int sock_fd, pid_t c_pid, int num_requests)
+{
+    char request[sizeof(int32_t)];  // Payload of the current memory usage request.
+    int num_answered = 0;           // Number of requests answered.
+    int num_sent = 0;               // Number of requests sent.
+    int result;                     // Result of sending the current request.
+    struct frame_header header;     // Header of the current reply.
+
+    char *payload = malloc(MAX_PAYLOAD_LEN); // Payload of the current reply.
+
+    if (!payload)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    while (num_answered < num_requests)
+    {
+        while (num_sent < num_requests && num_sent - num_answered < DEPTH)
+        {
+            put_be32(request, num_sent % 2 ? c_pid : 0);
+
+            if (num_sent % BATCH_INTERVAL == BATCH_INTERVAL - 1)
+            {
+                result = send_frame(sock_fd, MSG_SUBMIT, num_sent, BATCH_COMMANDS, strlen(BATCH_COMMANDS));
+            }
+            else if (num_sent % EXEC_INTERVAL == EXEC_INTERVAL - 1)
+            {
+                result = send_frame(sock_fd, MSG_EXEC, num_sent, EXEC_COMMAND, strlen(EXEC_COMMAND));
+            }
+            else
+            {
+                result = send_frame(sock_fd, MSG_MEM, num_sent, request, sizeof(request));
+            }
+
+            if (result == ERROR)
+            {
+                fprintf(stderr, "Could not send request to overseer\n");
+                exit(EXIT_FAILURE);
+            }
+
+            num_sent++;
+        }
+
+        recv_final_reply(sock_fd, &header, payload);
+
+        if (header.type == MSG_ERROR)
+        {
+            fprintf(stderr, "Could not launch %s\n", EXEC_COMMAND);
+            exit(EXIT_FAILURE);
+        }
+
+        num_answered++;
+    }
+
+    free(payload);
+}
+
+/*
+ * Function main(): Count the heap allocations the overseer makes while answering requests, launching children and sampling a child.
+ *
+ * Algorithm: Create the counters file and start the overseer with the malloc interposer preloaded. Launch a child to be sampled, warm the
+ * session up, let the launched children exit and let the sampler sample the child, then read the counters, send the given number of requests,
+ * let the overseer reap the children they launched and the sampler tick again, and compare. Any allocation or free in between fails the test.
+ *
+ * Input: Number of command line arguments (argc) and command line arguments (argv).
+ *
+ * Output: Exit code.
+ */
+int main(int argc, char **argv)
+{
+    char counter_path[PATH_MAX];                    // Absolute path of the malloc interposer.
+    char counts_file[] = "/tmp/alloc_test.XXXXXX";  // Path of the counters file.
+    int counts_fd;                                  // File descriptor of the counters file.
+    int opt;                                        // Current command line option.
+    int sock_fd;                                    // Socket of the session.
+    long int after[NUM_COUNTS];                     // Counters once the requests have been answered.
+    long int before[NUM_COUNTS];                    // Counters once the overseer has warmed up.
+    long int *counts;                               // Counters shared with the interposer.
+    pid_t c_pid;                                    // Process ID of the sampled child.
+    pid_t overseer_pid;                             // Process ID of the overseer.
+    struct frame_header header;                     // Header of the reply to the launch.
+
+    char *opts[] = {NULL};                          // Options of the overseer.
+    int num_requests = DEFAULT_REQUESTS;            // Number of requests counted.
+    int port = TEST_PORT;                           // Port of the overseer.
+    char payload[MAX_PAYLOAD_LEN];                  // Payload of the reply to the launch.
+
+    while ((opt = getopt(argc, argv, "n:P:")) != ERROR)
+    {
+        if ((opt == 'n' && (num_requests = atoi(optarg)) <= 0) || (opt == 'P' && (port = atoi(optarg)) <= 0) || opt == '?')
+        {
+            fprintf(stderr, "Usage: alloc_test [-n requests] [-P port]\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if ((counts_fd = mkstemp(counts_file)) == ERROR || ftruncate(counts_fd, NUM_COUNTS * sizeof(long int)) ||
+        (counts = mmap(NULL, NUM_COUNTS * sizeof(long int), PROT_READ | PROT_WRITE, MAP_SHARED, counts_fd, 0)) == MAP_FAILED ||
+        close(counts_fd) || realpath(COUNTER_PATH, counter_path) == NULL)
+    {
+        fprintf(stderr, "Could not set up the allocation counters\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Only the overseer is started with the interposer, which removes itself from the environment its children inherit. */
+    if (setenv("LD_PRELOAD", counter_path, TRUE) || setenv(ALLOC_COUNT_ENV, counts_file, TRUE))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    overseer_pid = start_overseer(opts, port);
+
+    if (unsetenv("LD_PRELOAD") || unsetenv(ALLOC_COUNT_ENV) || (sock_fd = connect_overseer(port)) == ERROR ||
+        send_frame(sock_fd, MSG_EXEC, 0, JOB_FILE, strlen(JOB_FILE)) == ERROR)
+    {
+        fprintf(stderr, "Could not connect to overseer\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (recv_final_reply(sock_fd, &header, payload) != sizeof(int32_t) || header.type != MSG_STARTED)
+    {
+        fprintf(stderr, "Could not launch %s\n", JOB_FILE);
+        exit(EXIT_FAILURE);
+    }
+
+    c_pid = get_be32(payload);
+
+    run_requests(sock_fd, c_pid, WARMUP_REQUESTS);
+    usleep(SETTLE_US);
+
+    memcpy(before, counts, sizeof(before));
+
+    /* An overseer which started without the interposer counts nothing, not even its start-up, and would pass vacuously. */
+    if (before[COUNT_ALLOCS] == 0)
+    {
+        fprintf(stderr, "The malloc interposer was not loaded into the overseer\n");
+        exit(EXIT_FAILURE);
+    }
+
+    run_requests(sock_fd, c_pid, num_requests);
+    usleep(SETTLE_US);
+
+    memcpy(after, counts, sizeof(after));
+
+    printf("%i requests and %.1f s of sampling: %ld allocations, %ld frees\n", num_requests, (double)SETTLE_US / 1000000,
+           after[COUNT_ALLOCS] - before[COUNT_ALLOCS], after[COUNT_FREES] - before[COUNT_FREES]);
+
+    close(sock_fd);
+    stop_overseer(overseer_pid);
+    unlink(counts_file);
+    unlink(LOG_FILE);
+
+    if (after[COUNT_ALLOCS] != before[COUNT_ALLOCS] || after[COUNT_FREES] != before[COUNT_FREES])
+    {
+        fprintf(stderr, "The overseer used the heap in steady state\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}